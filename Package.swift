@@ -33,10 +33,14 @@ let package = Package(
                 .brew(["vips"]),
             ]
         ),
+        // PURPOSE: io_uring bridge for batch file I/O (thread-pool fallback elsewhere)
+        .target(
+            name: "CHokusaiIO"
+        ),
         // PURPOSE: Main Hokusai library target
         .target(
             name: "Hokusai",
-            dependencies: ["CVips"],
+            dependencies: ["CVips", "CHokusaiIO"],
             swiftSettings: [
                 .enableExperimentalFeature("StrictConcurrency")
             ]
@@ -54,6 +58,7 @@ let package = Package(
             name: "HokusaiTests",
             dependencies: [
                 "Hokusai",
+                "HokusaiCLI",
                 .product(name: "Testing", package: "swift-testing"),
             ],
             resources: [
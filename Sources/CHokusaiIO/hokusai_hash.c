@@ -0,0 +1,209 @@
+#include "hokusai_hash.h"
+
+#include <string.h>
+
+// MARK: - SHA-256 (FIPS 180-4)
+
+static const uint32_t hk_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t hk_rotr32(uint32_t x, unsigned n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static void hk_sha256_block(hk_sha256 *ctx, const uint8_t *p) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t)p[i * 4] << 24 | (uint32_t)p[i * 4 + 1] << 16 | (uint32_t)p[i * 4 + 2] << 8 | p[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = hk_rotr32(w[i - 15], 7) ^ hk_rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = hk_rotr32(w[i - 2], 17) ^ hk_rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+    uint32_t e = ctx->state[4], f = ctx->state[5], g = ctx->state[6], h = ctx->state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (hk_rotr32(e, 6) ^ hk_rotr32(e, 11) ^ hk_rotr32(e, 25)) + ((e & f) ^ (~e & g)) + hk_sha256_k[i] + w[i];
+        uint32_t t2 = (hk_rotr32(a, 2) ^ hk_rotr32(a, 13) ^ hk_rotr32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    ctx->state[0] += a; ctx->state[1] += b; ctx->state[2] += c; ctx->state[3] += d;
+    ctx->state[4] += e; ctx->state[5] += f; ctx->state[6] += g; ctx->state[7] += h;
+}
+
+void hk_sha256_init(hk_sha256 *ctx) {
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(ctx->state, initial, sizeof(initial));
+    ctx->length = 0;
+    ctx->used = 0;
+}
+
+void hk_sha256_update(hk_sha256 *ctx, const void *data, size_t len) {
+    const uint8_t *p = data;
+    ctx->length += len;
+
+    if (ctx->used > 0) {
+        size_t take = 64 - ctx->used < len ? 64 - ctx->used : len;
+        memcpy(ctx->block + ctx->used, p, take);
+        ctx->used += take;
+        p += take;
+        len -= take;
+        if (ctx->used < 64) {
+            return;
+        }
+        hk_sha256_block(ctx, ctx->block);
+        ctx->used = 0;
+    }
+    for (; len >= 64; p += 64, len -= 64) {
+        hk_sha256_block(ctx, p);
+    }
+    memcpy(ctx->block, p, len);
+    ctx->used = len;
+}
+
+void hk_sha256_final(hk_sha256 *ctx, uint8_t out[32]) {
+    uint64_t bits = ctx->length * 8;
+    uint8_t pad[72] = {0x80};
+    size_t padding = ctx->used < 56 ? 56 - ctx->used : 120 - ctx->used;
+    for (int i = 0; i < 8; i++) {
+        pad[padding + i] = (uint8_t)(bits >> (56 - i * 8));
+    }
+    hk_sha256_update(ctx, pad, padding + 8);
+
+    for (int i = 0; i < 8; i++) {
+        out[i * 4] = (uint8_t)(ctx->state[i] >> 24);
+        out[i * 4 + 1] = (uint8_t)(ctx->state[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(ctx->state[i] >> 8);
+        out[i * 4 + 3] = (uint8_t)ctx->state[i];
+    }
+}
+
+// MARK: - XXH64
+
+#define HK_XXH_P1 0x9E3779B185EBCA87ULL
+#define HK_XXH_P2 0xC2B2AE3D27D4EB4FULL
+#define HK_XXH_P3 0x165667B19E3779F9ULL
+#define HK_XXH_P4 0x85EBCA77C2B2AE63ULL
+#define HK_XXH_P5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t hk_rotl64(uint64_t x, unsigned n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+static inline uint64_t hk_read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline uint32_t hk_read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+static inline uint64_t hk_xxh64_round(uint64_t acc, uint64_t input) {
+    acc += input * HK_XXH_P2;
+    return hk_rotl64(acc, 31) * HK_XXH_P1;
+}
+
+static inline uint64_t hk_xxh64_merge(uint64_t acc, uint64_t value) {
+    acc ^= hk_xxh64_round(0, value);
+    return acc * HK_XXH_P1 + HK_XXH_P4;
+}
+
+static void hk_xxh64_stripe(hk_xxh64 *ctx, const uint8_t *p) {
+    ctx->acc[0] = hk_xxh64_round(ctx->acc[0], hk_read64(p));
+    ctx->acc[1] = hk_xxh64_round(ctx->acc[1], hk_read64(p + 8));
+    ctx->acc[2] = hk_xxh64_round(ctx->acc[2], hk_read64(p + 16));
+    ctx->acc[3] = hk_xxh64_round(ctx->acc[3], hk_read64(p + 24));
+}
+
+void hk_xxh64_init(hk_xxh64 *ctx, uint64_t seed) {
+    ctx->seed = seed;
+    ctx->acc[0] = seed + HK_XXH_P1 + HK_XXH_P2;
+    ctx->acc[1] = seed + HK_XXH_P2;
+    ctx->acc[2] = seed;
+    ctx->acc[3] = seed - HK_XXH_P1;
+    ctx->length = 0;
+    ctx->used = 0;
+}
+
+void hk_xxh64_update(hk_xxh64 *ctx, const void *data, size_t len) {
+    const uint8_t *p = data;
+    ctx->length += len;
+
+    if (ctx->used > 0) {
+        size_t take = 32 - ctx->used < len ? 32 - ctx->used : len;
+        memcpy(ctx->block + ctx->used, p, take);
+        ctx->used += take;
+        p += take;
+        len -= take;
+        if (ctx->used < 32) {
+            return;
+        }
+        hk_xxh64_stripe(ctx, ctx->block);
+        ctx->used = 0;
+    }
+    for (; len >= 32; p += 32, len -= 32) {
+        hk_xxh64_stripe(ctx, p);
+    }
+    memcpy(ctx->block, p, len);
+    ctx->used = len;
+}
+
+uint64_t hk_xxh64_digest(const hk_xxh64 *ctx) {
+    uint64_t h;
+    if (ctx->length >= 32) {
+        h = hk_rotl64(ctx->acc[0], 1) + hk_rotl64(ctx->acc[1], 7) + hk_rotl64(ctx->acc[2], 12) + hk_rotl64(ctx->acc[3], 18);
+        for (int i = 0; i < 4; i++) {
+            h = hk_xxh64_merge(h, ctx->acc[i]);
+        }
+    } else {
+        h = ctx->seed + HK_XXH_P5;
+    }
+    h += ctx->length;
+
+    const uint8_t *p = ctx->block;
+    size_t len = ctx->used;
+    for (; len >= 8; p += 8, len -= 8) {
+        h ^= hk_xxh64_round(0, hk_read64(p));
+        h = hk_rotl64(h, 27) * HK_XXH_P1 + HK_XXH_P4;
+    }
+    if (len >= 4) {
+        h ^= (uint64_t)hk_read32(p) * HK_XXH_P1;
+        h = hk_rotl64(h, 23) * HK_XXH_P2 + HK_XXH_P3;
+        p += 4;
+        len -= 4;
+    }
+    for (; len > 0; p++, len--) {
+        h ^= (*p) * HK_XXH_P5;
+        h = hk_rotl64(h, 11) * HK_XXH_P1;
+    }
+
+    h ^= h >> 33;
+    h *= HK_XXH_P2;
+    h ^= h >> 29;
+    h *= HK_XXH_P3;
+    h ^= h >> 32;
+    return h;
+}
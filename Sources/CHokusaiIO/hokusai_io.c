@@ -0,0 +1,232 @@
+#define _GNU_SOURCE
+
+#include "hokusai_io.h"
+
+#include <errno.h>
+#include <stddef.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define HK_HAVE_IO_URING 1
+#endif
+#endif
+
+#ifdef HK_HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct hk_io_ring {
+    int fd;
+    unsigned sq_entries;
+    unsigned pending;
+
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    struct io_uring_sqe *sqes;
+
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    void *sq_ptr;
+    size_t sq_size;
+    void *cq_ptr;
+    size_t cq_size;
+    size_t sqes_size;
+};
+
+static void hk_io_ring_unmap(hk_io_ring *ring) {
+    if (ring->sqes && ring->sqes != MAP_FAILED) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ptr && ring->cq_ptr != MAP_FAILED && ring->cq_ptr != ring->sq_ptr) {
+        munmap(ring->cq_ptr, ring->cq_size);
+    }
+    if (ring->sq_ptr && ring->sq_ptr != MAP_FAILED) {
+        munmap(ring->sq_ptr, ring->sq_size);
+    }
+}
+
+hk_io_ring *hk_io_ring_create(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        return NULL;
+    }
+
+#ifdef IORING_FEAT_FAST_POLL
+    // PURPOSE: FAST_POLL (5.7) implies IORING_OP_READ/WRITE (5.6) are available.
+    if (!(params.features & IORING_FEAT_FAST_POLL)) {
+        close(fd);
+        return NULL;
+    }
+#endif
+
+    hk_io_ring *ring = calloc(1, sizeof(*ring));
+    if (!ring) {
+        close(fd);
+        return NULL;
+    }
+    ring->fd = fd;
+    ring->sq_entries = params.sq_entries;
+
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    int single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        if (ring->cq_size > ring->sq_size) {
+            ring->sq_size = ring->cq_size;
+        }
+        ring->cq_size = ring->sq_size;
+    }
+
+    ring->sq_ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == MAP_FAILED) {
+        goto fail;
+    }
+    ring->cq_ptr = single_mmap
+        ? ring->sq_ptr
+        : mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ptr == MAP_FAILED) {
+        goto fail;
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        goto fail;
+    }
+
+    char *sq = ring->sq_ptr;
+    ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+
+    char *cq = ring->cq_ptr;
+    ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    return ring;
+
+fail:
+    hk_io_ring_unmap(ring);
+    close(fd);
+    free(ring);
+    return NULL;
+}
+
+void hk_io_ring_destroy(hk_io_ring *ring) {
+    if (!ring) {
+        return;
+    }
+    hk_io_ring_unmap(ring);
+    close(ring->fd);
+    free(ring);
+}
+
+static int hk_io_ring_prep(hk_io_ring *ring, int opcode, int fd, const void *buf, unsigned len, uint64_t offset, uint64_t user_data) {
+    // PURPOSE: Only this thread writes the SQ tail; the kernel advances the head.
+    unsigned tail = *ring->sq_tail;
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if (tail - head >= ring->sq_entries) {
+        return -EBUSY;
+    }
+
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (uint8_t)opcode;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = len;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->pending += 1;
+    return 0;
+}
+
+int hk_io_ring_prep_read(hk_io_ring *ring, int fd, void *buf, unsigned len, uint64_t offset, uint64_t user_data) {
+    return hk_io_ring_prep(ring, IORING_OP_READ, fd, buf, len, offset, user_data);
+}
+
+int hk_io_ring_prep_write(hk_io_ring *ring, int fd, const void *buf, unsigned len, uint64_t offset, uint64_t user_data) {
+    return hk_io_ring_prep(ring, IORING_OP_WRITE, fd, buf, len, offset, user_data);
+}
+
+int hk_io_ring_submit(hk_io_ring *ring, unsigned wait_nr) {
+    unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    for (;;) {
+        int submitted = (int)syscall(__NR_io_uring_enter, ring->fd, ring->pending, wait_nr, flags, NULL, 0);
+        if (submitted >= 0) {
+            ring->pending -= (unsigned)submitted;
+            return submitted;
+        }
+        if (errno != EINTR) {
+            return -errno;
+        }
+    }
+}
+
+int hk_io_ring_peek(hk_io_ring *ring, uint64_t *user_data, int32_t *result) {
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+        return 0;
+    }
+
+    struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+    *user_data = cqe->user_data;
+    *result = cqe->res;
+    __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+#else
+
+// PURPOSE: Non-Linux builds always take the thread-pool fallback.
+
+hk_io_ring *hk_io_ring_create(unsigned entries) {
+    (void)entries;
+    return NULL;
+}
+
+void hk_io_ring_destroy(hk_io_ring *ring) {
+    (void)ring;
+}
+
+int hk_io_ring_prep_read(hk_io_ring *ring, int fd, void *buf, unsigned len, uint64_t offset, uint64_t user_data) {
+    (void)ring; (void)fd; (void)buf; (void)len; (void)offset; (void)user_data;
+    return -ENOSYS;
+}
+
+int hk_io_ring_prep_write(hk_io_ring *ring, int fd, const void *buf, unsigned len, uint64_t offset, uint64_t user_data) {
+    (void)ring; (void)fd; (void)buf; (void)len; (void)offset; (void)user_data;
+    return -ENOSYS;
+}
+
+int hk_io_ring_submit(hk_io_ring *ring, unsigned wait_nr) {
+    (void)ring; (void)wait_nr;
+    return -ENOSYS;
+}
+
+int hk_io_ring_peek(hk_io_ring *ring, uint64_t *user_data, int32_t *result) {
+    (void)ring; (void)user_data; (void)result;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef HOKUSAI_HASH_H
+#define HOKUSAI_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief PURPOSE: Incremental SHA-256 and XXH64 for hashing encoder output as it is written.
+ * CONSTRAINTS:
+ * - States are plain structs owned by the caller; no allocation, not thread-safe.
+ * - `update` accepts arbitrary chunk sizes; results match one-shot hashing of the concatenation.
+ */
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;
+    uint8_t block[64];
+    size_t used;
+} hk_sha256;
+
+void hk_sha256_init(hk_sha256 *ctx);
+void hk_sha256_update(hk_sha256 *ctx, const void *data, size_t len);
+/** @brief Write the 32-byte digest to `out`; the state must be re-initialised before reuse. */
+void hk_sha256_final(hk_sha256 *ctx, uint8_t out[32]);
+
+typedef struct {
+    uint64_t acc[4];
+    uint64_t seed;
+    uint64_t length;
+    uint8_t block[32];
+    size_t used;
+} hk_xxh64;
+
+void hk_xxh64_init(hk_xxh64 *ctx, uint64_t seed);
+void hk_xxh64_update(hk_xxh64 *ctx, const void *data, size_t len);
+/** @brief Digest of everything fed so far; does not modify the state. */
+uint64_t hk_xxh64_digest(const hk_xxh64 *ctx);
+
+#endif /* HOKUSAI_HASH_H */
@@ -0,0 +1,35 @@
+#ifndef HOKUSAI_IO_H
+#define HOKUSAI_IO_H
+
+#include <stdint.h>
+
+/**
+ * @brief PURPOSE: Minimal io_uring bridge for batch file I/O (raw syscalls, no liburing).
+ * CONSTRAINTS:
+ * - A ring is single-threaded: one thread prepares, submits, and reaps.
+ * - Linux 5.7+ only; `hk_io_ring_create` returns NULL elsewhere so callers can fall back.
+ * AI HINTS:
+ * - Keep policy (buffering, ordering, retries) in Swift; this layer only moves SQEs/CQEs.
+ */
+
+typedef struct hk_io_ring hk_io_ring;
+
+/** @brief Create a ring with at least `entries` submission slots; NULL when unsupported. */
+hk_io_ring *hk_io_ring_create(unsigned entries);
+
+/** @brief Unmap the ring and close its descriptor. In-flight requests are abandoned. */
+void hk_io_ring_destroy(hk_io_ring *ring);
+
+/** @brief Queue a read of `len` bytes at `offset`; returns 0 or -EBUSY when the queue is full. */
+int hk_io_ring_prep_read(hk_io_ring *ring, int fd, void *buf, unsigned len, uint64_t offset, uint64_t user_data);
+
+/** @brief Queue a write of `len` bytes at `offset`; returns 0 or -EBUSY when the queue is full. */
+int hk_io_ring_prep_write(hk_io_ring *ring, int fd, const void *buf, unsigned len, uint64_t offset, uint64_t user_data);
+
+/** @brief Submit queued entries and wait for at least `wait_nr` completions; returns submitted count or -errno. */
+int hk_io_ring_submit(hk_io_ring *ring, unsigned wait_nr);
+
+/** @brief Pop one completion without blocking; returns 1 when `user_data`/`result` were filled. */
+int hk_io_ring_peek(hk_io_ring *ring, uint64_t *user_data, int32_t *result);
+
+#endif /* HOKUSAI_IO_H */
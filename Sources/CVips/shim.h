@@ -13,6 +13,41 @@
  * - Preserve ownership/NULL semantics from underlying libvips APIs.
  */
 
+#define SWIFT_VIPS_AT_LEAST(major, minor) \
+    (VIPS_MAJOR_VERSION > (major) || (VIPS_MAJOR_VERSION == (major) && VIPS_MINOR_VERSION >= (minor)))
+
+// MARK: - Metadata Retention
+
+/** @brief Metadata kept on save; values match libvips' VipsForeignKeep (8.15+). */
+#define SWIFT_VIPS_KEEP_NONE 0
+#define SWIFT_VIPS_KEEP_EXIF 1
+#define SWIFT_VIPS_KEEP_XMP 2
+#define SWIFT_VIPS_KEEP_IPTC 4
+#define SWIFT_VIPS_KEEP_ICC 8
+#define SWIFT_VIPS_KEEP_OTHER 16
+#define SWIFT_VIPS_KEEP_ALL 31
+
+/**
+ * @brief Saver argument pair for a keep mask.
+ * PURPOSE: Older libvips only has `strip`; partial masks are then applied by
+ * removing header fields before the save (see `VipsBackend.withMetadataPolicy`).
+ */
+#if SWIFT_VIPS_AT_LEAST(8, 15)
+#define SWIFT_VIPS_KEEP_ARG(keep) "keep", (VipsForeignKeep)(keep)
+#else
+#define SWIFT_VIPS_KEEP_ARG(keep) "strip", (gboolean)((keep) == SWIFT_VIPS_KEEP_NONE)
+#endif
+
+/** @brief 1 when savers honour every keep bit themselves. */
+static inline int swift_vips_keep_supported(void) {
+    return SWIFT_VIPS_AT_LEAST(8, 15);
+}
+
+/** @brief Remove a header field from `in` (no-op when absent). */
+static inline void swift_vips_image_remove_field(VipsImage *in, const char *name) {
+    vips_image_remove(in, name);
+}
+
 // PURPOSE: Export commonly used vips enums and types for Swift
 typedef VipsKernel VipsKernel;
 typedef VipsBlendMode VipsBlendMode;
@@ -34,10 +69,44 @@ static inline VipsImage *swift_vips_image_new_from_buffer(const void *buf, size_
     return vips_image_new_from_buffer(buf, size, "", NULL);
 }
 
+// MARK: - Buffer Lifetime
+
+/** @brief Release callback invoked once libvips has fully closed an image. */
+typedef void (*swift_vips_release_fn)(void *context);
+
+typedef struct {
+    swift_vips_release_fn release;
+    void *context;
+} SwiftVipsReleaseHook;
+
+static void swift_vips_postclose_trampoline(VipsObject *object, void *data) {
+    SwiftVipsReleaseHook *hook = (SwiftVipsReleaseHook *)data;
+    (void)object;
+    hook->release(hook->context);
+    g_free(hook);
+}
+
+/**
+ * @brief Run `release(context)` after `image` closes.
+ * PURPOSE: Buffer loaders do not copy their input; the owner of the bytes must
+ * outlive every image (and cached operation) that reads them.
+ */
+static inline void swift_vips_image_on_close(VipsImage *image, swift_vips_release_fn release, void *context) {
+    SwiftVipsReleaseHook *hook = g_new(SwiftVipsReleaseHook, 1);
+    hook->release = release;
+    hook->context = context;
+    g_signal_connect(image, "postclose", G_CALLBACK(swift_vips_postclose_trampoline), hook);
+}
+
 static inline int swift_vips_copy(VipsImage *in, VipsImage **out) {
     return vips_copy(in, out, NULL);
 }
 
+/** @brief Evaluate the pipeline into a new memory image; returns NULL on error. */
+static inline VipsImage *swift_vips_image_copy_memory(VipsImage *in) {
+    return vips_image_copy_memory(in);
+}
+
 static inline int swift_vips_jpegload(const char *filename, VipsImage **out) {
     return vips_jpegload(filename, out, NULL);
 }
@@ -70,10 +139,33 @@ static inline int swift_vips_heifload(const char *filename, VipsImage **out) {
     return vips_heifload(filename, out, NULL);
 }
 
+/** @brief Load JPEG with DCT-domain shrink-on-load (shrink is 1, 2, 4, or 8). */
+static inline int swift_vips_jpegload_shrink(const char *filename, VipsImage **out, int shrink) {
+    return vips_jpegload(filename, out, "shrink", shrink, NULL);
+}
+
+static inline int swift_vips_jpegload_buffer_shrink(const void *buf, size_t len, VipsImage **out, int shrink) {
+    return vips_jpegload_buffer((void *) buf, len, out, "shrink", shrink, NULL);
+}
+
+/** @brief Load WebP scaled by the decoder (scale in (0, 1]). */
+static inline int swift_vips_webpload_scale(const char *filename, VipsImage **out, double scale) {
+    return vips_webpload(filename, out, "scale", scale, NULL);
+}
+
+static inline int swift_vips_webpload_buffer_scale(const void *buf, size_t len, VipsImage **out, double scale) {
+    return vips_webpload_buffer((void *) buf, len, out, "scale", scale, NULL);
+}
+
 static inline int swift_vips_resize(VipsImage *in, VipsImage **out, double hscale, double vscale, VipsKernel kernel) {
     return vips_resize(in, out, hscale, "vscale", vscale, "kernel", kernel, NULL);
 }
 
+/** @brief Unsharp mask on lightness: radius `sigma`, gains `m1` (flat) and `m2` (jagged). */
+static inline int swift_vips_sharpen(VipsImage *in, VipsImage **out, double sigma, double m1, double m2) {
+    return vips_sharpen(in, out, "sigma", sigma, "m1", m1, "m2", m2, NULL);
+}
+
 static inline int swift_vips_embed(
     VipsImage *in,
     VipsImage **out,
@@ -86,6 +178,11 @@ static inline int swift_vips_embed(
     return vips_embed(in, out, x, y, width, height, "background", background, NULL);
 }
 
+/** @brief Lazily tile `in` `across` x `down` times; no pixels are copied. */
+static inline int swift_vips_replicate(VipsImage *in, VipsImage **out, int across, int down) {
+    return vips_replicate(in, out, across, down, NULL);
+}
+
 static inline int swift_vips_rot(VipsImage *in, VipsImage **out, VipsAngle angle) {
     return vips_rot(in, out, angle, NULL);
 }
@@ -106,6 +203,52 @@ static inline int swift_vips_similarity_background(VipsImage *in, VipsImage **ou
     return vips_similarity(in, out, "angle", angle, "background", background, NULL);
 }
 
+/**
+ * @brief Affine resample: [x', y'] = [[a, b], [c, d]] * [x, y] + [odx, ody].
+ * PURPOSE: `interpolator` is a libvips nickname (`bicubic`, `lbb`, ...). `oarea`
+ * (left, top, width, height) may be NULL for the transformed bounding box and
+ * `background` may be NULL for black/transparent.
+ */
+static inline int swift_vips_affine(
+    VipsImage *in,
+    VipsImage **out,
+    double a,
+    double b,
+    double c,
+    double d,
+    double odx,
+    double ody,
+    const char *interpolator,
+    const int *oarea,
+    VipsArrayDouble *background
+) {
+    VipsInterpolate *interpolate = vips_interpolate_new(interpolator);
+    if (!interpolate) {
+        return -1;
+    }
+
+    int result;
+    VipsArrayInt *area = oarea ? vips_array_int_new(oarea, 4) : NULL;
+    if (area && background) {
+        result = vips_affine(in, out, a, b, c, d, "interpolate", interpolate, "odx", odx, "ody", ody,
+                             "oarea", area, "background", background, NULL);
+    } else if (area) {
+        result = vips_affine(in, out, a, b, c, d, "interpolate", interpolate, "odx", odx, "ody", ody,
+                             "oarea", area, NULL);
+    } else if (background) {
+        result = vips_affine(in, out, a, b, c, d, "interpolate", interpolate, "odx", odx, "ody", ody,
+                             "background", background, NULL);
+    } else {
+        result = vips_affine(in, out, a, b, c, d, "interpolate", interpolate, "odx", odx, "ody", ody, NULL);
+    }
+
+    if (area) {
+        vips_area_unref(VIPS_AREA(area));
+    }
+    g_object_unref(interpolate);
+    return result;
+}
+
 static inline int swift_vips_text(VipsImage **out, const char *text, const char *font, int dpi, VipsAlign align) {
     return vips_text(out, text, "font", font, "dpi", dpi, "align", align, NULL);
 }
@@ -199,6 +342,32 @@ static inline int swift_vips_bandjoin(VipsImage **in, VipsImage **out, int n) {
     return vips_bandjoin(in, out, n, NULL);
 }
 
+/**
+ * @brief Copy of `in` whose evaluation uses at most `threads` libvips workers.
+ * PURPOSE: Lets batch callers split cores between images instead of every image
+ * claiming the whole pool. Releases without per-image concurrency get a plain copy.
+ */
+static inline int swift_vips_limit_concurrency(VipsImage *in, VipsImage **out, int threads) {
+    if (vips_copy(in, out, NULL)) {
+        return -1;
+    }
+#ifdef VIPS_META_CONCURRENCY
+    vips_image_set_int(*out, VIPS_META_CONCURRENCY, threads);
+#else
+    (void)threads;
+#endif
+    return 0;
+}
+
+/** @brief 1 when `swift_vips_limit_concurrency` really caps the worker count. */
+static inline int swift_vips_has_image_concurrency(void) {
+#ifdef VIPS_META_CONCURRENCY
+    return 1;
+#else
+    return 0;
+#endif
+}
+
 // MARK: - Metadata Helpers
 
 /** @brief Read integer metadata field if present; return -1 when absent. */
@@ -228,6 +397,17 @@ static inline const char *swift_vips_image_get_string_field(VipsImage *in, const
     return value;
 }
 
+/**
+ * @brief Borrow a blob field (ICC, EXIF, XMP) if present; return -1 when absent.
+ * PURPOSE: `*data` points into the image's own copy and stays valid while `in` is alive.
+ */
+static inline int swift_vips_image_get_blob_field(VipsImage *in, const char *name, const void **data, size_t *length) {
+    if (vips_image_get_typeof(in, name) == 0) {
+        return -1;
+    }
+    return vips_image_get_blob(in, name, data, length);
+}
+
 static inline char **swift_vips_image_get_fields(VipsImage *in) {
     return vips_image_get_fields(in);
 }
@@ -288,52 +468,266 @@ static inline int swift_vips_colourspace(VipsImage *in, VipsImage **out, VipsInt
     return vips_colourspace(in, out, space, NULL);
 }
 
-static inline int swift_vips_jpegsave(VipsImage *in, const char *filename, int quality, int interlace, int strip) {
-    return vips_jpegsave(in, filename, "Q", quality, "interlace", interlace, "strip", strip, NULL);
+/** @brief 1 when libvips was built with LCMS (ICC transforms available). */
+static inline int swift_vips_icc_present(void) {
+    return vips_icc_present();
+}
+
+/**
+ * @brief Transform to `output_profile` (file path or builtin `srgb`/`p3`/`cmyk`).
+ * PURPOSE: With `embedded`, an attached profile wins and `input_profile` (may be NULL)
+ * is the fallback; without it, `input_profile` is used as-is.
+ */
+static inline int swift_vips_icc_transform(
+    VipsImage *in,
+    VipsImage **out,
+    const char *output_profile,
+    const char *input_profile,
+    VipsIntent intent,
+    int embedded
+) {
+    if (input_profile) {
+        return vips_icc_transform(in, out, output_profile,
+                                  "input_profile", input_profile, "intent", intent, "embedded", embedded, NULL);
+    }
+    return vips_icc_transform(in, out, output_profile, "intent", intent, "embedded", embedded, NULL);
+}
+
+static inline int swift_vips_jpegsave(VipsImage *in, const char *filename, int quality, int interlace, int keep) {
+    return vips_jpegsave(in, filename, "Q", quality, "interlace", interlace, SWIFT_VIPS_KEEP_ARG(keep), NULL);
+}
+
+static inline int swift_vips_pngsave(VipsImage *in, const char *filename, int compression, int interlace, int keep) {
+    return vips_pngsave(in, filename, "compression", compression, "interlace", interlace, SWIFT_VIPS_KEEP_ARG(keep), NULL);
+}
+
+static inline int swift_vips_webpsave(VipsImage *in, const char *filename, int quality, int lossless, int effort, int keep) {
+    return vips_webpsave(in, filename, "Q", quality, "lossless", lossless, "effort", effort, SWIFT_VIPS_KEEP_ARG(keep), NULL);
+}
+
+static inline int swift_vips_tiffsave(VipsImage *in, const char *filename, int compression, int keep) {
+    return vips_tiffsave(in, filename, "compression", compression, SWIFT_VIPS_KEEP_ARG(keep), NULL);
+}
+
+static inline int swift_vips_heifsave(VipsImage *in, const char *filename, int quality, int lossless, int effort, int keep) {
+    return vips_heifsave(in, filename, "Q", quality, "lossless", lossless, "effort", effort, SWIFT_VIPS_KEEP_ARG(keep), NULL);
 }
 
-static inline int swift_vips_pngsave(VipsImage *in, const char *filename, int compression, int interlace) {
-    return vips_pngsave(in, filename, "compression", compression, "interlace", interlace, NULL);
+static inline int swift_vips_gifsave(VipsImage *in, const char *filename, int keep) {
+    return vips_gifsave(in, filename, SWIFT_VIPS_KEEP_ARG(keep), NULL);
 }
 
-static inline int swift_vips_webpsave(VipsImage *in, const char *filename, int quality, int lossless, int effort) {
-    return vips_webpsave(in, filename, "Q", quality, "lossless", lossless, "effort", effort, NULL);
+static inline int swift_vips_jpegsave_buffer(VipsImage *in, void **buf, size_t *len, int quality, int keep) {
+    return vips_jpegsave_buffer(in, buf, len, "Q", quality, SWIFT_VIPS_KEEP_ARG(keep), NULL);
 }
 
-static inline int swift_vips_tiffsave(VipsImage *in, const char *filename, int compression) {
-    return vips_tiffsave(in, filename, "compression", compression, NULL);
+static inline int swift_vips_pngsave_buffer(VipsImage *in, void **buf, size_t *len, int compression, int keep) {
+    return vips_pngsave_buffer(in, buf, len, "compression", compression, SWIFT_VIPS_KEEP_ARG(keep), NULL);
 }
 
-static inline int swift_vips_heifsave(VipsImage *in, const char *filename, int quality, int lossless, int effort) {
-    return vips_heifsave(in, filename, "Q", quality, "lossless", lossless, "effort", effort, NULL);
+static inline int swift_vips_webpsave_buffer(VipsImage *in, void **buf, size_t *len, int quality, int lossless, int keep) {
+    return vips_webpsave_buffer(in, buf, len, "Q", quality, "lossless", lossless, SWIFT_VIPS_KEEP_ARG(keep), NULL);
 }
 
-static inline int swift_vips_gifsave(VipsImage *in, const char *filename) {
-    return vips_gifsave(in, filename, NULL);
+static inline int swift_vips_tiffsave_buffer(VipsImage *in, void **buf, size_t *len, int keep) {
+    return vips_tiffsave_buffer(in, buf, len, SWIFT_VIPS_KEEP_ARG(keep), NULL);
 }
 
-static inline int swift_vips_jpegsave_buffer(VipsImage *in, void **buf, size_t *len, int quality) {
-    return vips_jpegsave_buffer(in, buf, len, "Q", quality, NULL);
+static inline int swift_vips_heifsave_buffer(VipsImage *in, void **buf, size_t *len, int quality, int keep) {
+    return vips_heifsave_buffer(in, buf, len, "Q", quality, SWIFT_VIPS_KEEP_ARG(keep), NULL);
 }
 
-static inline int swift_vips_pngsave_buffer(VipsImage *in, void **buf, size_t *len, int compression) {
-    return vips_pngsave_buffer(in, buf, len, "compression", compression, NULL);
+static inline int swift_vips_gifsave_buffer(VipsImage *in, void **buf, size_t *len, int keep) {
+    return vips_gifsave_buffer(in, buf, len, SWIFT_VIPS_KEEP_ARG(keep), NULL);
 }
 
-static inline int swift_vips_webpsave_buffer(VipsImage *in, void **buf, size_t *len, int quality, int lossless) {
-    return vips_webpsave_buffer(in, buf, len, "Q", quality, "lossless", lossless, NULL);
+// MARK: - Animation
+
+/**
+ * @brief Stack `n` equal-sized frames into one multi-page image.
+ * PURPOSE: Sets `page-height`, `n-pages`, `delay` (ms per frame), `loop`, and the
+ * legacy `gif-delay` (centiseconds) on a fresh copy so savers encode every page.
+ */
+static inline int swift_vips_animation_assemble(VipsImage **frames, int n, const int *delays, int loop, VipsImage **out) {
+    VipsImage *joined;
+    if (vips_arrayjoin(frames, &joined, n, "across", 1, NULL)) {
+        return -1;
+    }
+    int result = vips_copy(joined, out, NULL);
+    g_object_unref(joined);
+    if (result) {
+        return -1;
+    }
+    vips_image_set_int(*out, "page-height", frames[0]->Ysize);
+    vips_image_set_int(*out, "n-pages", n);
+    vips_image_set_array_int(*out, "delay", delays, n);
+    vips_image_set_int(*out, "loop", loop);
+    vips_image_set_int(*out, "gif-delay", delays[0] / 10);
+    return 0;
+}
+
+/**
+ * @brief Animated GIF with frame differencing and palette sharing where available.
+ * PURPOSE: `interframe_maxerror` turns pixels unchanged since the previous frame
+ * transparent so cgif can crop each frame to its changed area (8.13+). `shared_palette`
+ * sets `interpalette_maxerror` to its 255 maximum, so every frame reuses the global
+ * palette; otherwise libvips' default of 3 lets frames that drift get a local palette (8.15+).
+ */
+static inline int swift_vips_gifsave_buffer_animated(
+    VipsImage *in,
+    void **buf,
+    size_t *len,
+    int effort,
+    double interframe_maxerror,
+    int shared_palette,
+    int keep
+) {
+#if SWIFT_VIPS_AT_LEAST(8, 15)
+    return vips_gifsave_buffer(in, buf, len, "effort", effort,
+                               "interframe_maxerror", interframe_maxerror,
+                               "interpalette_maxerror", shared_palette ? 255.0 : 3.0,
+                               SWIFT_VIPS_KEEP_ARG(keep), NULL);
+#elif SWIFT_VIPS_AT_LEAST(8, 13)
+    (void)shared_palette;
+    return vips_gifsave_buffer(in, buf, len, "effort", effort,
+                               "interframe_maxerror", interframe_maxerror,
+                               SWIFT_VIPS_KEEP_ARG(keep), NULL);
+#else
+    (void)effort; (void)interframe_maxerror; (void)shared_palette;
+    return vips_gifsave_buffer(in, buf, len, SWIFT_VIPS_KEEP_ARG(keep), NULL);
+#endif
 }
 
-static inline int swift_vips_tiffsave_buffer(VipsImage *in, void **buf, size_t *len) {
-    return vips_tiffsave_buffer(in, buf, len, NULL);
+/** @brief Animated WebP; `kmin`/`kmax` bound keyframe distance, `min_size` searches for the smallest encoding. */
+static inline int swift_vips_webpsave_buffer_animated(
+    VipsImage *in,
+    void **buf,
+    size_t *len,
+    int quality,
+    int lossless,
+    int effort,
+    int kmin,
+    int kmax,
+    int min_size,
+    int keep
+) {
+    return vips_webpsave_buffer(in, buf, len, "Q", quality, "lossless", lossless, "effort", effort,
+                                "kmin", kmin, "kmax", kmax, "min_size", min_size,
+                                SWIFT_VIPS_KEEP_ARG(keep), NULL);
 }
 
-static inline int swift_vips_heifsave_buffer(VipsImage *in, void **buf, size_t *len, int quality) {
-    return vips_heifsave_buffer(in, buf, len, "Q", quality, NULL);
+// MARK: - Target Saving
+
+/** @brief Append callback for custom targets; returns bytes consumed or -1 on failure. */
+typedef int64_t (*swift_vips_write_fn)(const void *data, int64_t length, void *context);
+
+/**
+ * @brief 1 when `<suffix>save_target` exists in the libvips this was built against.
+ * PURPOSE: Callers fall back to `*save_buffer` for older releases. TIFF always falls
+ * back: libtiff seeks and reads back through its target, which an append-only custom
+ * target cannot do.
+ */
+static inline int swift_vips_target_save_supported(const char *suffix) {
+#if SWIFT_VIPS_AT_LEAST(8, 12)
+    if (g_str_equal(suffix, "gif")) return 1;
+#endif
+#if SWIFT_VIPS_AT_LEAST(8, 11)
+    if (g_str_equal(suffix, "heif")) return 1;
+#endif
+#if SWIFT_VIPS_AT_LEAST(8, 9)
+    return g_str_equal(suffix, "jpeg") || g_str_equal(suffix, "png") || g_str_equal(suffix, "webp");
+#else
+    (void)suffix;
+    return 0;
+#endif
 }
 
-static inline int swift_vips_gifsave_buffer(VipsImage *in, void **buf, size_t *len) {
-    return vips_gifsave_buffer(in, buf, len, NULL);
+#if SWIFT_VIPS_AT_LEAST(8, 9)
+
+typedef struct {
+    swift_vips_write_fn write;
+    void *context;
+} SwiftVipsWriteHook;
+
+static gint64 swift_vips_target_write_trampoline(VipsTargetCustom *target, const void *data, gint64 length, void *user) {
+    SwiftVipsWriteHook *hook = (SwiftVipsWriteHook *)user;
+    (void)target;
+    return hook->write(data, length, hook->context);
+}
+
+static void swift_vips_write_hook_free(gpointer data, GClosure *closure) {
+    (void)closure;
+    g_free(data);
+}
+
+/**
+ * @brief Owned target that forwards every encoder write to `write(context)`.
+ * PURPOSE: Lets Swift own the output memory instead of libvips' growing g_malloc buffer.
+ */
+static inline VipsTarget *swift_vips_target_new_custom(swift_vips_write_fn write, void *context) {
+    VipsTargetCustom *target = vips_target_custom_new();
+    SwiftVipsWriteHook *hook = g_new(SwiftVipsWriteHook, 1);
+    hook->write = write;
+    hook->context = context;
+    g_signal_connect_data(target, "write", G_CALLBACK(swift_vips_target_write_trampoline), hook,
+                          swift_vips_write_hook_free, 0);
+    return VIPS_TARGET(target);
+}
+
+static inline int swift_vips_jpegsave_target(VipsImage *in, VipsTarget *target, int quality, int interlace, int keep) {
+    return vips_jpegsave_target(in, target, "Q", quality, "interlace", interlace, SWIFT_VIPS_KEEP_ARG(keep), NULL);
+}
+
+static inline int swift_vips_pngsave_target(VipsImage *in, VipsTarget *target, int compression, int interlace, int keep) {
+    return vips_pngsave_target(in, target, "compression", compression, "interlace", interlace, SWIFT_VIPS_KEEP_ARG(keep), NULL);
+}
+
+static inline int swift_vips_webpsave_target(VipsImage *in, VipsTarget *target, int quality, int lossless, int effort, int keep) {
+    return vips_webpsave_target(in, target, "Q", quality, "lossless", lossless, "effort", effort, SWIFT_VIPS_KEEP_ARG(keep), NULL);
+}
+
+#else
+
+typedef struct _VipsTarget VipsTarget;
+
+static inline VipsTarget *swift_vips_target_new_custom(swift_vips_write_fn write, void *context) {
+    (void)write; (void)context;
+    return NULL;
+}
+
+static inline int swift_vips_jpegsave_target(VipsImage *in, VipsTarget *target, int quality, int interlace, int keep) {
+    (void)in; (void)target; (void)quality; (void)interlace; (void)keep;
+    return -1;
+}
+
+static inline int swift_vips_pngsave_target(VipsImage *in, VipsTarget *target, int compression, int interlace, int keep) {
+    (void)in; (void)target; (void)compression; (void)interlace; (void)keep;
+    return -1;
+}
+
+static inline int swift_vips_webpsave_target(VipsImage *in, VipsTarget *target, int quality, int lossless, int effort, int keep) {
+    (void)in; (void)target; (void)quality; (void)lossless; (void)effort; (void)keep;
+    return -1;
+}
+
+#endif
+
+static inline int swift_vips_heifsave_target(VipsImage *in, VipsTarget *target, int quality, int lossless, int effort, int keep) {
+#if SWIFT_VIPS_AT_LEAST(8, 11)
+    return vips_heifsave_target(in, target, "Q", quality, "lossless", lossless, "effort", effort, SWIFT_VIPS_KEEP_ARG(keep), NULL);
+#else
+    (void)in; (void)target; (void)quality; (void)lossless; (void)effort; (void)keep;
+    return -1;
+#endif
+}
+
+static inline int swift_vips_gifsave_target(VipsImage *in, VipsTarget *target, int keep) {
+#if SWIFT_VIPS_AT_LEAST(8, 12)
+    return vips_gifsave_target(in, target, SWIFT_VIPS_KEEP_ARG(keep), NULL);
+#else
+    (void)in; (void)target; (void)keep;
+    return -1;
+#endif
 }
 
 // MARK: - Composite Operations
@@ -349,6 +743,117 @@ static inline int swift_vips_composite2(
     return vips_composite2(base, overlay, out, mode, "x", x, "y", y, NULL);
 }
 
+// MARK: - Tone Operations
+
+/** @brief `entries` x 1 lookup table image with `bands` bands, copied from `data`. */
+static inline VipsImage *swift_vips_lut_new(const void *data, int entries, int bands, VipsBandFormat format) {
+    size_t size = (size_t) entries * bands * vips_format_sizeof(format);
+    return vips_image_new_from_memory_copy(data, size, entries, 1, bands, format);
+}
+
+/** @brief Map every pixel through `lut`; band i of the image uses band i of the table. */
+static inline int swift_vips_maplut(VipsImage *in, VipsImage **out, VipsImage *lut) {
+    return vips_maplut(in, out, lut, NULL);
+}
+
+/**
+ * @brief Affine band recombination: out = M * [bands..., 1], cast back to the input format.
+ * PURPOSE: `matrix` is `out_bands` rows of `in->Bands + 1` columns, the last column being
+ * the per-band offset; the whole filter is one recomb with clipping in the final cast.
+ */
+static inline int swift_vips_recomb_affine(VipsImage *in, VipsImage **out, const double *matrix, int out_bands) {
+    int columns = in->Bands + 1;
+    VipsImage *m = vips_image_new_matrix_from_array(columns, out_bands, matrix, columns * out_bands);
+    if (!m) {
+        return -1;
+    }
+
+    double one = 1.0;
+    VipsImage *extended = NULL;
+    VipsImage *combined = NULL;
+    VipsImage *cast = NULL;
+    int result = vips_bandjoin_const(in, &extended, &one, 1, NULL);
+    if (!result) {
+        result = vips_recomb(extended, &combined, m, NULL);
+    }
+    if (!result) {
+        result = vips_cast(combined, &cast, in->BandFmt, NULL);
+    }
+    if (!result) {
+        result = vips_copy(cast, out, "interpretation", in->Type, NULL);
+    }
+
+    if (cast) {
+        g_object_unref(cast);
+    }
+    if (combined) {
+        g_object_unref(combined);
+    }
+    if (extended) {
+        g_object_unref(extended);
+    }
+    g_object_unref(m);
+    return result;
+}
+
+// MARK: - Montage Operations
+
+/** @brief Shrink-on-load thumbnail fitting inside width x height; never upsizes. */
+static inline int swift_vips_thumbnail(const char *filename, VipsImage **out, int width, int height) {
+    return vips_thumbnail(filename, out, width, "height", height, "size", VIPS_SIZE_DOWN, NULL);
+}
+
+static inline int swift_vips_thumbnail_buffer(const void *buf, size_t len, VipsImage **out, int width, int height) {
+    return vips_thumbnail_buffer((void *) buf, len, out, width, "height", height, "size", VIPS_SIZE_DOWN, NULL);
+}
+
+/** @brief Grid of `n` images, `across` per row, each centred in an hspacing x vspacing cell. */
+static inline int swift_vips_arrayjoin(
+    VipsImage **in,
+    VipsImage **out,
+    int n,
+    int across,
+    int shim,
+    int hspacing,
+    int vspacing,
+    VipsArrayDouble *background
+) {
+    return vips_arrayjoin(in, out, n,
+                          "across", across, "shim", shim,
+                          "hspacing", hspacing, "vspacing", vspacing,
+                          "halign", VIPS_ALIGN_CENTRE, "valign", VIPS_ALIGN_CENTRE,
+                          "background", background, NULL);
+}
+
+/** @brief Transparent sRGB RGBA canvas. */
+static inline int swift_vips_canvas_rgba(VipsImage **out, int width, int height) {
+    VipsImage *black;
+    if (vips_black(&black, width, height, "bands", 4, NULL)) {
+        return -1;
+    }
+    int result = vips_copy(black, out, "interpretation", VIPS_INTERPRETATION_sRGB, NULL);
+    g_object_unref(black);
+    return result;
+}
+
+/**
+ * @brief Place in[1..n-1] over in[0] at (x[i], y[i]) with OVER blending, in one operation.
+ * CONSTRAINTS: `x` and `y` hold n-1 entries.
+ */
+static inline int swift_vips_composite_at(VipsImage **in, VipsImage **out, int n, const int *x, const int *y) {
+    int *modes = g_new(int, n - 1);
+    for (int i = 0; i < n - 1; i++) {
+        modes[i] = VIPS_BLEND_MODE_OVER;
+    }
+    VipsArrayInt *xs = vips_array_int_new(x, n - 1);
+    VipsArrayInt *ys = vips_array_int_new(y, n - 1);
+    int result = vips_composite(in, out, n, modes, "x", xs, "y", ys, NULL);
+    vips_area_unref(VIPS_AREA(xs));
+    vips_area_unref(VIPS_AREA(ys));
+    g_free(modes);
+    return result;
+}
+
 // MARK: - Array Helpers
 
 static inline VipsArrayDouble* swift_vips_array_double_new(const double *array, int n) {
@@ -387,4 +892,186 @@ static inline int swift_vips_smartcrop(
     return vips_smartcrop(in, out, width, height, "interesting", interesting, NULL);
 }
 
+// MARK: - Region Sinks
+
+/**
+ * @brief Per-tile callback: `data` addresses pixel (left, top) with `stride` bytes per line.
+ * PURPOSE: Returning non-zero stops the sink after the tiles already in flight.
+ */
+typedef int (*swift_vips_tile_fn)(int left, int top, int width, int height, const void *data, size_t stride, void *context);
+
+typedef struct {
+    swift_vips_tile_fn tile;
+    void *context;
+} SwiftVipsTileHook;
+
+static int swift_vips_sink_tile_trampoline(VipsRegion *region, void *seq, void *a, void *b, gboolean *stop) {
+    SwiftVipsTileHook *hook = (SwiftVipsTileHook *)a;
+    VipsRect *rect = &region->valid;
+    (void)seq;
+    (void)b;
+    if (hook->tile(rect->left, rect->top, rect->width, rect->height,
+                   VIPS_REGION_ADDR(region, rect->left, rect->top), VIPS_REGION_LSKIP(region), hook->context)) {
+        *stop = TRUE;
+    }
+    return 0;
+}
+
+/**
+ * @brief Compute `in` in `tile_width` x `tile_height` tiles on the libvips thread pool.
+ * PURPOSE: Each prepared region is lent to `tile` from a worker thread; `data` is only
+ * valid for the duration of the call. Tiles are dispatched in raster order.
+ */
+static inline int swift_vips_sink_tile(VipsImage *in, int tile_width, int tile_height, swift_vips_tile_fn tile, void *context) {
+    SwiftVipsTileHook hook = { tile, context };
+    return vips_sink_tile(in, tile_width, tile_height, NULL, swift_vips_sink_tile_trampoline, NULL, &hook, NULL);
+}
+
+/** @brief 1 when `in` depends on a sequential-access load and must be read top to bottom. */
+static inline int swift_vips_image_is_sequential(VipsImage *in) {
+#ifdef VIPS_META_SEQUENTIAL
+    return vips_image_get_typeof(in, VIPS_META_SEQUENTIAL) != 0;
+#else
+    (void)in;
+    return 0;
+#endif
+}
+
+/** @brief Bytes per pixel (all bands). */
+static inline size_t swift_vips_image_sizeof_pel(VipsImage *in) {
+    return VIPS_IMAGE_SIZEOF_PEL(in);
+}
+
+// MARK: - Custom Region Operations
+
+/** @brief Matching input and output pixels of one region; `in`/`out` address (left, top). */
+typedef struct {
+    int left;
+    int top;
+    int width;
+    int height;
+    const void *in;
+    size_t in_stride;
+    int in_bands;
+    size_t in_sizeof_pel;
+    void *out;
+    size_t out_stride;
+    int out_bands;
+    size_t out_sizeof_pel;
+} SwiftVipsRegionPair;
+
+/**
+ * @brief Fill `pair->out` from `pair->in`. Called concurrently from libvips workers;
+ * non-zero fails the pipeline.
+ */
+typedef int (*swift_vips_region_fn)(const SwiftVipsRegionPair *pair, void *context);
+
+typedef struct {
+    swift_vips_region_fn process;
+    void *context;
+    swift_vips_release_fn release;
+    VipsImage *in;
+    char *name;
+} SwiftVipsRegionOp;
+
+static int swift_vips_region_op_generate(VipsRegion *out, void *seq, void *a, void *b, gboolean *stop) {
+    VipsRegion *ir = (VipsRegion *)seq;
+    SwiftVipsRegionOp *op = (SwiftVipsRegionOp *)b;
+    VipsRect *r = &out->valid;
+    SwiftVipsRegionPair pair;
+    (void)a;
+    (void)stop;
+
+    if (vips_region_prepare(ir, r)) {
+        return -1;
+    }
+    pair.left = r->left;
+    pair.top = r->top;
+    pair.width = r->width;
+    pair.height = r->height;
+    pair.in = VIPS_REGION_ADDR(ir, r->left, r->top);
+    pair.in_stride = VIPS_REGION_LSKIP(ir);
+    pair.in_bands = ir->im->Bands;
+    pair.in_sizeof_pel = VIPS_IMAGE_SIZEOF_PEL(ir->im);
+    pair.out = VIPS_REGION_ADDR(out, r->left, r->top);
+    pair.out_stride = VIPS_REGION_LSKIP(out);
+    pair.out_bands = out->im->Bands;
+    pair.out_sizeof_pel = VIPS_IMAGE_SIZEOF_PEL(out->im);
+
+    if (op->process(&pair, op->context)) {
+        vips_error(op->name, "%s", "region callback failed");
+        return -1;
+    }
+    return 0;
+}
+
+/** @brief Append `message` to the libvips error buffer (vips_error is variadic).
+ * PURPOSE: Lets Swift kernels tag a failure so the caller can find the original error.
+ */
+static inline void swift_vips_error(const char *domain, const char *message) {
+    vips_error(domain, "%s", message);
+}
+
+static void swift_vips_region_op_postclose(VipsObject *object, void *data) {
+    SwiftVipsRegionOp *op = (SwiftVipsRegionOp *)data;
+    (void)object;
+    if (op->release) {
+        op->release(op->context);
+    }
+    g_object_unref(op->in);
+    g_free(op->name);
+    g_free(op);
+}
+
+/**
+ * @brief Lazy custom operation: `out` has `in`'s geometry and each output region is
+ * filled by `process` from the matching input region.
+ * PURPOSE: Scheduled by libvips' demand-driven thread pool with the same tiling as
+ * native ops. `bands` <= 0 and `format` < 0 keep the input layout. `release(context)`
+ * (may be NULL) runs exactly once, after `out` closes or on failure.
+ */
+static inline int swift_vips_region_op(
+    VipsImage *in,
+    VipsImage **out,
+    const char *name,
+    int bands,
+    int format,
+    swift_vips_region_fn process,
+    void *context,
+    swift_vips_release_fn release
+) {
+    VipsImage *image = vips_image_new();
+    VipsImage *inputs[] = { in, NULL };
+    SwiftVipsRegionOp *op = g_new(SwiftVipsRegionOp, 1);
+
+    op->process = process;
+    op->context = context;
+    op->release = release;
+    op->in = in;
+    op->name = g_strdup(name);
+    g_object_ref(in);
+    g_signal_connect(image, "postclose", G_CALLBACK(swift_vips_region_op_postclose), op);
+
+    if (vips_image_pipeline_array(image, VIPS_DEMAND_STYLE_THINSTRIP, inputs)) {
+        g_object_unref(image);
+        return -1;
+    }
+    if (bands > 0) {
+        image->Bands = bands;
+    }
+    if (format >= 0) {
+        image->BandFmt = (VipsBandFormat)format;
+    }
+    if (bands > 0 || format >= 0) {
+        image->Type = vips_image_guess_interpretation(image);
+    }
+
+    if (vips_image_generate(image, vips_start_one, swift_vips_region_op_generate, vips_stop_one, in, op)) {
+        g_object_unref(image);
+        return -1;
+    }
+    *out = image;
+    return 0;
+}
+
 #endif /* CVIPS_SHIM_H */
@@ -76,14 +76,103 @@ final class VipsBackend: ImageBackend {
             throw HokusaiError.invalidImageData
         }
 
-        let output = data.withUnsafeBytes { bytes in
-            swift_vips_image_new_from_buffer(bytes.baseAddress, data.count)
+        let owner = DataOwner(data)
+        return try loadFromBuffer(owner.bytes, count: owner.count, owner: owner)
+    }
+
+    /// PURPOSE: Zero-copy load from caller-owned bytes.
+    /// INPUT: `owner` keeps `bytes` valid; it is retained until libvips closes the image.
+    /// CONSTRAINTS: `bytes` must not be mutated while any derived image is alive.
+    static func loadFromBuffer(_ bytes: UnsafeRawPointer?, count: Int, owner: AnyObject) throws -> VipsBackend {
+        guard let bytes, count > 0 else {
+            throw HokusaiError.invalidImageData
         }
 
-        guard let img = output else {
+        guard let img = swift_vips_image_new_from_buffer(bytes, count) else {
+            throw HokusaiError.loadFailed(getLastError())
+        }
+
+        retain(owner, until: img)
+        return VipsBackend(takingOwnership: img)
+    }
+
+    /// PURPOSE: Load with decoder-side downscaling where the format supports it.
+    /// INPUT: `shrink` is an integer reduction; JPEG requires 2, 4, or 8.
+    /// CONSTRAINTS: Falls back to a full-size load for formats without shrink-on-load.
+    static func loadFromFile(_ path: String, format: ImageFormat, shrink: Int) throws -> VipsBackend {
+        guard shrink > 1 else {
+            return try loadFromFile(path)
+        }
+
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        let result: Int32
+        switch format {
+        case .jpeg:
+            result = swift_vips_jpegload_shrink(path, &output, Int32(shrink))
+        case .webp:
+            result = swift_vips_webpload_scale(path, &output, 1.0 / Double(shrink))
+        default:
+            return try loadFromFile(path)
+        }
+
+        guard result == 0, let img = output else {
+            throw HokusaiError.loadFailed(getLastError())
+        }
+        return VipsBackend(takingOwnership: img)
+    }
+
+    static func loadFromBuffer(_ data: Data, format: ImageFormat, shrink: Int) throws -> VipsBackend {
+        let owner = DataOwner(data)
+        return try loadFromBuffer(owner.bytes, count: owner.count, owner: owner, format: format, shrink: shrink)
+    }
+
+    static func loadFromBuffer(
+        _ bytes: UnsafeRawPointer?,
+        count: Int,
+        owner: AnyObject,
+        format: ImageFormat,
+        shrink: Int
+    ) throws -> VipsBackend {
+        guard shrink > 1, format == .jpeg || format == .webp else {
+            return try loadFromBuffer(bytes, count: count, owner: owner)
+        }
+
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        let result: Int32
+        if format == .jpeg {
+            result = swift_vips_jpegload_buffer_shrink(bytes, count, &output, Int32(shrink))
+        } else {
+            result = swift_vips_webpload_buffer_scale(bytes, count, &output, 1.0 / Double(shrink))
+        }
+
+        guard result == 0, let img = output else {
+            throw HokusaiError.loadFailed(getLastError())
+        }
+
+        retain(owner, until: img)
+        return VipsBackend(takingOwnership: img)
+    }
+
+    /// PURPOSE: Decode a thumbnail fitting inside `width` x `height` with shrink-on-load.
+    /// CONSTRAINTS: Never upsizes.
+    static func thumbnail(path: String, width: Int, height: Int) throws -> VipsBackend {
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        guard swift_vips_thumbnail(path, &output, Int32(width), Int32(height)) == 0, let img = output else {
             throw HokusaiError.loadFailed(getLastError())
         }
+        return VipsBackend(takingOwnership: img)
+    }
 
+    /// PURPOSE: Buffer variant of `thumbnail(path:width:height:)`.
+    /// CONSTRAINTS: `bytes` are read lazily; keep them valid until the result is rendered.
+    static func thumbnail(bytes: UnsafeRawPointer?, count: Int, width: Int, height: Int) throws -> VipsBackend {
+        guard let bytes, count > 0 else {
+            throw HokusaiError.invalidImageData
+        }
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        guard swift_vips_thumbnail_buffer(bytes, count, &output, Int32(width), Int32(height)) == 0, let img = output else {
+            throw HokusaiError.loadFailed(getLastError())
+        }
         return VipsBackend(takingOwnership: img)
     }
 
@@ -94,23 +183,23 @@ final class VipsBackend: ImageBackend {
         let result: Int32
         switch detectedFormat.lowercased() {
         case "jpeg", "jpg":
-            result = swift_vips_jpegsave(pointer, path, Int32(quality ?? 85), 0, 1)
+            result = swift_vips_jpegsave(pointer, path, Int32(quality ?? 85), 0, SWIFT_VIPS_KEEP_NONE)
         case "png":
-            result = swift_vips_pngsave(pointer, path, Int32(quality ?? 6), 0)
+            result = swift_vips_pngsave(pointer, path, Int32(quality ?? 6), 0, SWIFT_VIPS_KEEP_ALL)
         case "webp":
-            result = swift_vips_webpsave(pointer, path, Int32(quality ?? 80), 0, 4)
+            result = swift_vips_webpsave(pointer, path, Int32(quality ?? 80), 0, 4, SWIFT_VIPS_KEEP_ALL)
         case "avif", "heif", "heic":
-            result = swift_vips_heifsave(pointer, path, Int32(quality ?? 80), 0, 4)
+            result = swift_vips_heifsave(pointer, path, Int32(quality ?? 80), 0, 4, SWIFT_VIPS_KEEP_ALL)
         case "tiff", "tif":
-            result = swift_vips_tiffsave(pointer, path, 0)
+            result = swift_vips_tiffsave(pointer, path, 0, SWIFT_VIPS_KEEP_ALL)
         case "gif":
-            result = swift_vips_gifsave(pointer, path)
+            result = swift_vips_gifsave(pointer, path, SWIFT_VIPS_KEEP_ALL)
         default:
             throw HokusaiError.unsupportedFormat(detectedFormat)
         }
 
         guard result == 0 else {
-            throw HokusaiError.saveFailed(Self.getLastError())
+            throw Self.evaluationError(HokusaiError.saveFailed)
         }
     }
 
@@ -124,29 +213,91 @@ final class VipsBackend: ImageBackend {
         let result: Int32
         switch targetFormat.lowercased() {
         case "jpeg", "jpg":
-            result = swift_vips_jpegsave_buffer(pointer, &buffer, &length, Int32(quality ?? 85))
+            result = swift_vips_jpegsave_buffer(pointer, &buffer, &length, Int32(quality ?? 85), SWIFT_VIPS_KEEP_ALL)
         case "png":
-            result = swift_vips_pngsave_buffer(pointer, &buffer, &length, Int32(quality ?? 6))
+            result = swift_vips_pngsave_buffer(pointer, &buffer, &length, Int32(quality ?? 6), SWIFT_VIPS_KEEP_ALL)
         case "webp":
-            result = swift_vips_webpsave_buffer(pointer, &buffer, &length, Int32(quality ?? 80), 0)
+            result = swift_vips_webpsave_buffer(pointer, &buffer, &length, Int32(quality ?? 80), 0, SWIFT_VIPS_KEEP_ALL)
         case "avif", "heif", "heic":
-            result = swift_vips_heifsave_buffer(pointer, &buffer, &length, Int32(quality ?? 80))
+            result = swift_vips_heifsave_buffer(pointer, &buffer, &length, Int32(quality ?? 80), SWIFT_VIPS_KEEP_ALL)
         case "tiff", "tif":
-            result = swift_vips_tiffsave_buffer(pointer, &buffer, &length)
+            result = swift_vips_tiffsave_buffer(pointer, &buffer, &length, SWIFT_VIPS_KEEP_ALL)
         case "gif":
-            result = swift_vips_gifsave_buffer(pointer, &buffer, &length)
+            result = swift_vips_gifsave_buffer(pointer, &buffer, &length, SWIFT_VIPS_KEEP_ALL)
         default:
             throw HokusaiError.unsupportedFormat(targetFormat)
         }
 
         guard result == 0, let buf = buffer else {
-            throw HokusaiError.saveFailed(Self.getLastError())
+            throw Self.evaluationError(HokusaiError.saveFailed)
         }
 
         defer { g_free(buffer) }
         return Data(bytes: buf, count: length)
     }
 
+    /// PURPOSE: Encode into pooled buffers through a custom libvips target.
+    /// OUTPUT: `nil` when this libvips has no `*save_target` for `format`; callers
+    /// then use the `*save_buffer` path. Encoder parameters match that path exactly.
+    func saveToPooledBuffer(format: ImageFormat, options: SaveOptions, hashing algorithms: HashAlgorithms = []) throws -> EncodedOutput? {
+        let sink = EncodeSink(format: format, hashing: algorithms)
+        guard try saveToTarget(sink, format: format, options: options, honoringFileOptions: false) else {
+            return nil
+        }
+        let data = sink.finish()
+        return EncodedOutput(data: data, digest: sink.digest?.finish() ?? OutputDigest(sha256: nil, xxHash64: nil, byteCount: data.count))
+    }
+
+    /// PURPOSE: Run the `*save_target` encoder for `format`, delivering bytes to `output`.
+    /// INPUT: `honoringFileOptions` applies the extra options `toFile` honours
+    /// (progressive, effort); buffer saves ignore them.
+    /// OUTPUT: `false` when this libvips has no target saver for `format`.
+    func saveToTarget(_ output: EncodeTarget, format: ImageFormat, options: SaveOptions, honoringFileOptions file: Bool) throws -> Bool {
+        let suffix = format == .avif ? "heif" : format.rawValue
+        guard swift_vips_target_save_supported(suffix) != 0 else {
+            return false
+        }
+
+        let box = TargetBox(output)
+        let context = Unmanaged.passUnretained(box).toOpaque()
+        guard let target = swift_vips_target_new_custom({ data, length, context in
+            guard let data, let context else { return -1 }
+            let box = Unmanaged<TargetBox>.fromOpaque(context).takeUnretainedValue()
+            return Int64(box.output.append(data, count: Int(length)))
+        }, context) else {
+            return false
+        }
+        defer { g_object_unref(target) }
+
+        let interlace: Int32 = file && options.progressive ? 1 : 0
+        let effort = Int32(file ? options.effort ?? 4 : 4)
+        let result: Int32 = try withMetadataPolicy(options.metadata) { pointer, keep in
+            withExtendedLifetime(box) {
+                switch format {
+                case .jpeg:
+                    return swift_vips_jpegsave_target(pointer, target, Int32(options.quality ?? 85), interlace, keep)
+                case .png:
+                    return swift_vips_pngsave_target(pointer, target, Int32(options.compression ?? 6), interlace, keep)
+                case .webp:
+                    return swift_vips_webpsave_target(pointer, target, Int32(options.quality ?? 80), options.lossless ? 1 : 0, effort, keep)
+                case .avif:
+                    return swift_vips_heifsave_target(pointer, target, Int32(options.quality ?? 80), file && options.lossless ? 1 : 0, effort, keep)
+                case .heif:
+                    return swift_vips_heifsave_target(pointer, target, Int32(options.quality ?? 80), 0, 4, keep)
+                case .gif:
+                    return swift_vips_gifsave_target(pointer, target, keep)
+                default:
+                    return -1
+                }
+            }
+        }
+
+        guard result == 0 else {
+            throw Self.evaluationError(HokusaiError.saveFailed)
+        }
+        return true
+    }
+
     func getWidth() throws -> Int {
         let pointer = try getPointer()
         return Int(vips_image_get_width(pointer))
@@ -167,6 +318,168 @@ final class VipsBackend: ImageBackend {
         return vips_image_hasalpha(pointer) != 0
     }
 
+    /// PURPOSE: Read an integer header field; nil when absent.
+    func intField(_ name: String) throws -> Int? {
+        let pointer = try getPointer()
+        var value: Int32 = 0
+        guard swift_vips_image_get_int_field(pointer, name, &value) == 0 else {
+            return nil
+        }
+        return Int(value)
+    }
+
+    /// PURPOSE: Map the `vips-loader` header field (e.g. `jpegload_buffer`) to a format.
+    func loaderFormat() throws -> ImageFormat? {
+        let pointer = try getPointer()
+        guard let loaderPointer = swift_vips_image_get_string_field(pointer, "vips-loader") else {
+            return nil
+        }
+
+        let loader = String(cString: loaderPointer)
+        let prefixes: [(String, ImageFormat)] = [
+            ("jpeg", .jpeg), ("png", .png), ("webp", .webp), ("gif", .gif),
+            ("tiff", .tiff), ("heif", .heif), ("pdf", .pdf), ("svg", .svg),
+        ]
+        guard let format = prefixes.first(where: { loader.hasPrefix($0.0) })?.1 else {
+            return nil
+        }
+
+        // PURPOSE: libvips loads AVIF through heifload; the compression field tells them apart.
+        if format == .heif,
+           let compression = swift_vips_image_get_string_field(pointer, "heif-compression"),
+           String(cString: compression) == "av1" {
+            return .avif
+        }
+        return format
+    }
+
+    /// PURPOSE: Interpretation nick such as `srgb`, `b-w`, or `cmyk`.
+    func interpretationName() throws -> String? {
+        let pointer = try getPointer()
+        guard let nick = swift_vips_interpretation_nick(swift_vips_image_get_interpretation(pointer)) else {
+            return nil
+        }
+        return String(cString: nick)
+    }
+
+    /// PURPOSE: Horizontal resolution in DPI (libvips stores pixels per millimetre).
+    func densityDPI() throws -> Double? {
+        let pointer = try getPointer()
+        let xres = swift_vips_image_get_xres(pointer)
+        return xres > 0 ? xres * 25.4 : nil
+    }
+
+    /// PURPOSE: Read a string header field without copying the rest of the header.
+    func stringField(_ name: String) throws -> String? {
+        let pointer = try getPointer()
+        return swift_vips_image_get_string_field(pointer, name).map { String(cString: $0) }
+    }
+
+    /// PURPOSE: Zero-copy view of a blob field; the `Data` keeps this image alive.
+    func blobField(_ name: String) throws -> Data? {
+        let pointer = try getPointer()
+        var bytes: UnsafeRawPointer?
+        var length = 0
+        guard swift_vips_image_get_blob_field(pointer, name, &bytes, &length) == 0, let bytes, length > 0 else {
+            return nil
+        }
+        return Data(bytesNoCopy: UnsafeMutableRawPointer(mutating: bytes), count: length, deallocator: .custom { _, _ in
+            withExtendedLifetime(self) {}
+        })
+    }
+
+    /// PURPOSE: Run one save with `policy` applied.
+    /// ALGORITHM:
+    /// - `.all` / `.strip` and plain category masks map straight onto the saver keep flags.
+    /// - Orientation or copyright without full EXIF keeps the EXIF flag on a copy whose other
+    ///   `exif-*` fields and raw EXIF blob are removed, so libvips rebuilds a minimal EXIF.
+    /// - libvips before 8.15 only knows `strip`, so unwanted blobs are removed on the copy too.
+    /// INPUT: `body` receives the image to save and the keep mask; the copy lives until it returns.
+    func withMetadataPolicy<T>(
+        _ policy: MetadataPolicy,
+        _ body: (UnsafeMutablePointer<CVips.VipsImage>, Int32) throws -> T
+    ) throws -> T {
+        let pointer = try getPointer()
+        let kinds: MetadataKinds
+        switch policy {
+        case .all:
+            return try body(pointer, SWIFT_VIPS_KEEP_ALL)
+        case .strip:
+            return try body(pointer, SWIFT_VIPS_KEEP_NONE)
+        case .keep(let kept):
+            kinds = kept
+        }
+
+        let partialExif = !kinds.contains(.exif) && !kinds.isDisjoint(with: [.orientation, .copyright])
+        var keep = Int32(SWIFT_VIPS_KEEP_NONE)
+        if kinds.contains(.exif) || partialExif { keep |= SWIFT_VIPS_KEEP_EXIF }
+        if kinds.contains(.xmp) { keep |= SWIFT_VIPS_KEEP_XMP }
+        if kinds.contains(.iptc) { keep |= SWIFT_VIPS_KEEP_IPTC }
+        if kinds.contains(.icc) { keep |= SWIFT_VIPS_KEEP_ICC }
+        if kinds.contains(.other) { keep |= SWIFT_VIPS_KEEP_OTHER }
+
+        let nativeKeep = swift_vips_keep_supported() != 0
+        guard partialExif || (!nativeKeep && keep != SWIFT_VIPS_KEEP_NONE) else {
+            return try body(pointer, keep)
+        }
+
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        guard swift_vips_copy(pointer, &output) == 0, let copy = output else {
+            throw HokusaiError.vipsError(Self.getLastError())
+        }
+        defer { g_object_unref(copy) }
+
+        if !kinds.contains(.exif) {
+            swift_vips_image_remove_field(copy, "exif-data")
+            for name in Self.fieldNames(of: copy) where name.hasPrefix("exif-") {
+                let kept = (kinds.contains(.orientation) && name == "exif-ifd0-Orientation")
+                    || (kinds.contains(.copyright) && name == "exif-ifd0-Copyright")
+                if !kept {
+                    swift_vips_image_remove_field(copy, name)
+                }
+            }
+            if !kinds.contains(.orientation) {
+                swift_vips_image_remove_field(copy, "orientation")
+            }
+        }
+        if !nativeKeep {
+            if !kinds.contains(.icc) { swift_vips_image_remove_field(copy, "icc-profile-data") }
+            if !kinds.contains(.xmp) { swift_vips_image_remove_field(copy, "xmp-data") }
+            if !kinds.contains(.iptc) { swift_vips_image_remove_field(copy, "iptc-data") }
+        }
+        return try body(copy, keep)
+    }
+
+    /// PURPOSE: Header field names only; values are not converted.
+    func fieldNames() throws -> [String] {
+        return Self.fieldNames(of: try getPointer())
+    }
+
+    private static func fieldNames(of pointer: UnsafeMutablePointer<CVips.VipsImage>) -> [String] {
+        guard let fields = swift_vips_image_get_fields(pointer) else {
+            return []
+        }
+        defer { swift_vips_g_strfreev(fields) }
+
+        var names: [String] = []
+        var index = 0
+        while let fieldPointer = fields[index] {
+            names.append(String(cString: fieldPointer))
+            index += 1
+        }
+        return names
+    }
+
+    /// PURPOSE: libvips' string rendering of any single header field.
+    func fieldDescription(_ name: String) throws -> String? {
+        let pointer = try getPointer()
+        guard let valuePointer = swift_vips_image_get_as_string(pointer, name) else {
+            return nil
+        }
+        defer { swift_vips_g_free(valuePointer) }
+        return String(cString: valuePointer)
+    }
+
     func extendedMetadata() throws -> [String: String] {
         let pointer = try getPointer()
         var metadata: [String: String] = [:]
@@ -221,6 +534,15 @@ final class VipsBackend: ImageBackend {
 
     // MARK: - Helper Methods
 
+    /// PURPOSE: Keep `owner` alive until libvips emits `postclose` for `image`.
+    private static func retain(_ owner: AnyObject, until image: UnsafeMutablePointer<CVips.VipsImage>) {
+        let context = Unmanaged.passRetained(owner).toOpaque()
+        swift_vips_image_on_close(image, { context in
+            guard let context else { return }
+            Unmanaged<AnyObject>.fromOpaque(context).release()
+        }, context)
+    }
+
     private func detectFormat(from path: String) -> String {
         let ext = (path as NSString).pathExtension
         return ext.isEmpty ? "jpeg" : ext
@@ -234,6 +556,13 @@ final class VipsBackend: ImageBackend {
         return String(cString: buffer)
     }
 
+    /// PURPOSE: Error for a failed evaluation: the Swift error a region kernel threw, if
+    /// any, otherwise the libvips message wrapped by `wrap`.
+    static func evaluationError(_ wrap: (String) -> HokusaiError) -> Error {
+        let message = getLastError()
+        return RegionFailures.shared.take(from: message) ?? wrap(message)
+    }
+
     /// PURPOSE: Get libvips version
     static var version: String {
         guard let versionStr = vips_version_string() else {
@@ -242,3 +571,33 @@ final class VipsBackend: ImageBackend {
         return String(cString: versionStr)
     }
 }
+
+/// PURPOSE: Stable copy of `Data` bytes for the lifetime of a buffer-backed image.
+/// CONSTRAINTS: `Data` only guarantees its pointer inside `withUnsafeBytes` (small values
+/// are stored inline and move with the value), so the bytes are copied once into an
+/// allocation this object owns and frees.
+private final class DataOwner {
+    let bytes: UnsafeMutableRawPointer
+    let count: Int
+
+    init(_ data: Data) {
+        self.count = data.count
+        self.bytes = UnsafeMutableRawPointer.allocate(byteCount: max(1, data.count), alignment: 16)
+        data.withUnsafeBytes { source in
+            UnsafeMutableRawBufferPointer(start: bytes, count: count).copyMemory(from: source)
+        }
+    }
+
+    deinit {
+        bytes.deallocate()
+    }
+}
+
+/// PURPOSE: Concrete class handed through the C write callback's context pointer.
+private final class TargetBox {
+    let output: EncodeTarget
+
+    init(_ output: EncodeTarget) {
+        self.output = output
+    }
+}
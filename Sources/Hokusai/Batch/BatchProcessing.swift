@@ -0,0 +1,261 @@
+import Foundation
+import CVips
+
+extension Hokusai {
+    /// PURPOSE: Process many inputs with bounded concurrency and an optional memory budget.
+    /// INPUT:
+    /// - `inputs`: files or buffers; materialized once when the stream starts.
+    /// - `recipe`: transform steps and encoder settings applied to every input.
+    /// - `maxConcurrency`: images in flight (default: derived from cores).
+    /// - `memoryBudget`: soft cap in bytes on the estimated peak memory of images in flight.
+    /// - `prefetch`: read `.file` inputs ahead of the decoders into pooled buffers
+    ///   (io_uring on Linux, threads elsewhere) instead of inside the libvips loaders.
+    /// OUTPUT: Stream of `BatchOutput` in completion order; per-item failures are
+    /// reported in `BatchOutput.result` and never terminate the stream.
+    /// CONSTRAINTS:
+    /// - Each image evaluates with `cores / workers` libvips threads, so running
+    ///   several images side by side does not oversubscribe the cores.
+    /// - A single item larger than the budget still runs, but alone.
+    ///
+    /// Example:
+    /// ```swift
+    /// let recipe = ProcessingRecipe(
+    ///     steps: [.resize(ResizeOptions(width: 320, height: 320))],
+    ///     output: SaveOptions(format: .webp, quality: 80)
+    /// )
+    /// for try await output in Hokusai.process(paths.map { .file($0) }, recipe: recipe) {
+    ///     print(output.index, output.data?.count ?? 0)
+    /// }
+    /// ```
+    public static func process(
+        _ inputs: some Sequence<ImageInput>,
+        recipe: ProcessingRecipe,
+        maxConcurrency: Int? = nil,
+        memoryBudget: Int? = nil,
+        prefetch: PrefetchOptions? = nil
+    ) -> AsyncThrowingStream<BatchOutput, Error> {
+        let items = Array(inputs)
+        let workers = BatchLimits.workerCount(requested: maxConcurrency)
+        let threadsPerImage = BatchLimits.vipsThreads(forWorkers: workers)
+        let (stream, continuation) = AsyncThrowingStream<BatchOutput, Error>.makeStream()
+        let (pending, reader) = pendingItems(items, prefetch: prefetch)
+
+        let task = Task {
+            let gate = MemoryGate(budget: memoryBudget)
+
+            await withTaskGroup(of: Void.self) { group in
+                var running = 0
+                for await item in pending {
+                    if item.prefetched != nil {
+                        reader?.release()
+                    }
+                    if Task.isCancelled { break }
+
+                    if running >= workers {
+                        await group.next()
+                        running -= 1
+                    }
+
+                    group.addTask {
+                        let result = await processItem(item, recipe: recipe, gate: gate, vipsThreads: threadsPerImage)
+                        continuation.yield(BatchOutput(index: item.index, input: item.input, result: result))
+                    }
+                    running += 1
+                }
+                await group.waitForAll()
+            }
+
+            continuation.finish()
+        }
+
+        continuation.onTermination = { _ in
+            task.cancel()
+            reader?.cancel()
+        }
+        return stream
+    }
+
+    /// PURPOSE: Images to run at once for hosts with their own workers (e.g. `hokusai daemon`).
+    /// OUTPUT: `requested` when given, otherwise the default `process` uses (half the cores).
+    /// AI HINTS: Pass the result to `ProcessingRecipe.run(_:concurrentRuns:)` so each image
+    /// gets its share of libvips threads.
+    public static func workerCount(requested: Int? = nil) -> Int {
+        return BatchLimits.workerCount(requested: requested)
+    }
+
+    // MARK: - Private Helpers
+
+    /// PURPOSE: Input ready for decoding, with its bytes when prefetched.
+    private struct PendingItem: Sendable {
+        let index: Int
+        let input: ImageInput
+        let prefetched: Result<PooledBuffer, Error>?
+    }
+
+    /// PURPOSE: In-memory inputs are ready at once; files arrive as the prefetcher completes them.
+    private static func pendingItems(
+        _ items: [ImageInput],
+        prefetch: PrefetchOptions?
+    ) -> (AsyncStream<PendingItem>, PrefetchReader?) {
+        let (stream, continuation) = AsyncStream<PendingItem>.makeStream()
+
+        var files: [(index: Int, path: String)] = []
+        for (index, input) in items.enumerated() {
+            if prefetch != nil, case .file(let path) = input {
+                files.append((index, path))
+            } else {
+                continuation.yield(PendingItem(index: index, input: input, prefetched: nil))
+            }
+        }
+
+        guard let prefetch, !files.isEmpty else {
+            continuation.finish()
+            return (stream, nil)
+        }
+
+        let reader = PrefetchReader(paths: files.map(\.path), options: prefetch)
+        let fileIndices = files.map(\.index)
+        let forward = Task {
+            for await item in reader.start() {
+                let index = fileIndices[item.index]
+                continuation.yield(PendingItem(index: index, input: items[index], prefetched: item.result))
+            }
+            continuation.finish()
+        }
+        continuation.onTermination = { _ in forward.cancel() }
+        return (stream, reader)
+    }
+
+    private static func processItem(
+        _ item: PendingItem,
+        recipe: ProcessingRecipe,
+        gate: MemoryGate,
+        vipsThreads: Int
+    ) async -> Result<Data, Error> {
+        let image: HokusaiImage
+        let estimate: CostEstimate
+        do {
+            // PURPOSE: Header-only open; libvips defers decoding until encode.
+            if let prefetched = item.prefetched {
+                image = try recipe.load(prefetched.get())
+            } else {
+                image = try recipe.load(item.input)
+            }
+            estimate = try estimateCost(probe: image.metadata(), recipe: recipe)
+        } catch {
+            return .failure(error)
+        }
+
+        do {
+            try await gate.acquire(estimate.peakMemoryBytes)
+        } catch {
+            return .failure(error)
+        }
+        let result = Result { try recipe.encode(recipe.transform(image).limitingConcurrency(vipsThreads)) }
+        await gate.release(estimate.peakMemoryBytes)
+        return result
+    }
+}
+
+/// PURPOSE: Shared sizing policy for everything that runs several images at once
+/// (batch streams, staged pipelines, the executor, daemon workers).
+/// ALGORITHM: The caller's worker count is always honoured; cores are split between
+/// workers by lowering each image's libvips thread count instead.
+enum BatchLimits {
+    /// PURPOSE: Images in flight: `requested` when given, otherwise half the cores
+    /// (each image still gets two or more libvips threads for its own tiles).
+    static func workerCount(requested: Int?) -> Int {
+        guard let requested else {
+            return max(1, ProcessInfo.processInfo.activeProcessorCount / 2)
+        }
+        return max(1, requested)
+    }
+
+    /// PURPOSE: libvips threads per image so `workers` images together use about every core.
+    static func vipsThreads(forWorkers workers: Int) -> Int {
+        let cores = ProcessInfo.processInfo.activeProcessorCount
+        return max(1, min(Int(vips_concurrency_get()), cores / max(1, workers)))
+    }
+}
+
+extension HokusaiImage {
+    /// PURPOSE: Same pixels, evaluated with at most `threads` libvips workers.
+    func limitingConcurrency(_ threads: Int) throws -> HokusaiImage {
+        let pointer = try ensureVipsBackend().getPointer()
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        guard swift_vips_limit_concurrency(pointer, &output, Int32(max(1, threads))) == 0, let out = output else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
+    }
+}
+
+/// PURPOSE: Weighted async semaphore that caps estimated bytes in flight.
+/// CONSTRAINTS: FIFO; an item is always admitted when nothing else is running.
+/// A waiter whose task is cancelled leaves the queue and throws `CancellationError`.
+actor MemoryGate {
+    private struct Waiter {
+        let id: Int
+        let bytes: Int
+        let continuation: CheckedContinuation<Void, Error>
+    }
+
+    private let budget: Int?
+    private var inUse = 0
+    private var waiters: [Waiter] = []
+    private var nextWaiterID = 0
+
+    init(budget: Int?) {
+        self.budget = budget
+    }
+
+    func acquire(_ bytes: Int) async throws {
+        if waiters.isEmpty && admits(bytes) {
+            inUse += bytes
+            return
+        }
+
+        let id = nextWaiterID
+        nextWaiterID += 1
+        try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { continuation in
+                if Task.isCancelled {
+                    continuation.resume(throwing: CancellationError())
+                } else {
+                    waiters.append(Waiter(id: id, bytes: bytes, continuation: continuation))
+                }
+            }
+        } onCancel: {
+            Task { await self.cancelWaiter(id) }
+        }
+    }
+
+    func release(_ bytes: Int) {
+        inUse -= bytes
+        admitWaiters()
+    }
+
+    var waitingCount: Int {
+        return waiters.count
+    }
+
+    private func cancelWaiter(_ id: Int) {
+        guard let index = waiters.firstIndex(where: { $0.id == id }) else { return }
+        waiters.remove(at: index).continuation.resume(throwing: CancellationError())
+        // PURPOSE: A cancelled head may have been blocking smaller requests behind it.
+        admitWaiters()
+    }
+
+    private func admitWaiters() {
+        while let next = waiters.first, admits(next.bytes) {
+            waiters.removeFirst()
+            inUse += next.bytes
+            next.continuation.resume()
+        }
+    }
+
+    private func admits(_ bytes: Int) -> Bool {
+        guard let budget else { return true }
+        return inUse == 0 || inUse + bytes <= budget
+    }
+}
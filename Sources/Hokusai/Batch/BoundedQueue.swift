@@ -0,0 +1,88 @@
+import Foundation
+
+/// PURPOSE: Blocking FIFO queue with a fixed capacity used between pipeline stages.
+/// CONSTRAINTS:
+/// - Called from dedicated stage threads, never from the Swift concurrency pool.
+/// - `push` blocks while the queue is full (backpressure on the producer stage) and
+///   rejects the element once the queue is closed.
+/// - `pop` returns nil only once the queue is closed and drained.
+final class BoundedQueue<Element>: @unchecked Sendable {
+    private let capacity: Int
+    private let condition = NSCondition()
+    private var buffer: [Element] = []
+    private var head = 0
+    private var closed = false
+    private var highWater = 0
+
+    init(capacity: Int) {
+        self.capacity = max(1, capacity)
+    }
+
+    /// PURPOSE: Number of queued items not yet taken by a consumer.
+    var depth: Int {
+        condition.lock()
+        defer { condition.unlock() }
+        return buffer.count - head
+    }
+
+    /// PURPOSE: Highest depth observed.
+    var maxDepth: Int {
+        condition.lock()
+        defer { condition.unlock() }
+        return highWater
+    }
+
+    /// PURPOSE: Append `element`, waiting for space.
+    /// OUTPUT: false if the queue was (or became) closed; the element is dropped.
+    @discardableResult
+    func push(_ element: Element) -> Bool {
+        condition.lock()
+        defer { condition.unlock() }
+
+        while buffer.count - head >= capacity && !closed {
+            condition.wait()
+        }
+        guard !closed else {
+            return false
+        }
+
+        buffer.append(element)
+        highWater = max(highWater, buffer.count - head)
+        condition.broadcast()
+        return true
+    }
+
+    func pop() -> Element? {
+        condition.lock()
+        defer { condition.unlock() }
+
+        while buffer.count == head && !closed {
+            condition.wait()
+        }
+        guard buffer.count > head else {
+            return nil
+        }
+
+        let element = buffer[head]
+        head += 1
+        compactIfNeeded()
+        condition.broadcast()
+        return element
+    }
+
+    /// PURPOSE: Stop accepting new work; wakes blocked producers and, once drained, consumers.
+    func close() {
+        condition.lock()
+        closed = true
+        condition.broadcast()
+        condition.unlock()
+    }
+
+    private func compactIfNeeded() {
+        // PURPOSE: Reclaim consumed slots without shifting on every pop.
+        if head > 64 && head * 2 > buffer.count {
+            buffer.removeFirst(head)
+            head = 0
+        }
+    }
+}
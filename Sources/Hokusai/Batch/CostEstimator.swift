@@ -0,0 +1,310 @@
+import Foundation
+
+extension Hokusai {
+    /// PURPOSE: Predict the work and memory a recipe will need before running it.
+    /// INPUT:
+    /// - `probe`: header-only metadata (see `HokusaiImage.metadata()`).
+    /// - `recipe`: steps and output settings that will be executed.
+    /// - `model`: per-operation pixel costs (default or calibrated).
+    /// OUTPUT: `CostEstimate` with pixel counts, decode shrink, per-op timing, and peak memory.
+    /// CONSTRAINTS: Geometry uses the same sizing rules as the real operations.
+    ///
+    /// Example:
+    /// ```swift
+    /// let probe = try Hokusai.loadFromFile(path).metadata()
+    /// let estimate = try Hokusai.estimateCost(probe: probe, recipe: recipe)
+    /// if estimate.peakMemoryBytes > limit { throw ... }
+    /// ```
+    public static func estimateCost(
+        probe: ImageMetadata,
+        recipe: ProcessingRecipe,
+        model: CostModel = .default
+    ) throws -> CostEstimate {
+        let inputPixels = probe.width * probe.height
+        let shrink = DecodeShrink.factor(for: probe, firstStep: recipe.steps.first)
+        var width = Int((Double(probe.width) / Double(shrink)).rounded(.up))
+        var height = Int((Double(probe.height) / Double(shrink)).rounded(.up))
+        let decodedPixels = width * height
+
+        var operations: [OperationCost] = []
+        func record(_ operation: String, pixels: Int) {
+            let ms = Double(pixels) * model.coefficient(for: operation) / 1_000_000.0
+            operations.append(OperationCost(operation: operation, pixels: pixels, estimatedMs: ms))
+        }
+
+        // PURPOSE: Entropy decoding still walks every coded pixel even when the DCT shrinks.
+        let decodeWork = decodedPixels + (inputPixels - decodedPixels) / 4
+        record("decode.\(probe.format?.rawValue ?? "unknown")", pixels: decodeWork)
+
+        for step in recipe.steps {
+            switch step {
+            case .resize(let options):
+                record("resize", pixels: width * height)
+                let (resizedWidth, resizedHeight) = try HokusaiImage.calculateDimensions(
+                    currentWidth: width,
+                    currentHeight: height,
+                    targetWidth: options.width,
+                    targetHeight: options.height,
+                    fit: options.fit,
+                    withoutEnlargement: options.withoutEnlargement,
+                    withoutReduction: options.withoutReduction
+                )
+                width = resizedWidth
+                height = resizedHeight
+                if options.sharpen != nil {
+                    record("sharpen", pixels: width * height)
+                }
+                if options.fit == .cover || options.fit == .contain,
+                   let targetWidth = options.width,
+                   let targetHeight = options.height {
+                    width = targetWidth
+                    height = targetHeight
+                }
+
+            case .crop(let options):
+                width = options.width
+                height = options.height
+                record("crop", pixels: width * height)
+
+            case .rotate(let angle, _):
+                let degrees = angle.degrees
+                if degrees.truncatingRemainder(dividingBy: 90) == 0 {
+                    if Int(degrees / 90) % 2 != 0 {
+                        swap(&width, &height)
+                    }
+                    record("rotate90", pixels: width * height)
+                } else {
+                    let radians = degrees * .pi / 180
+                    let c = abs(cos(radians))
+                    let s = abs(sin(radians))
+                    let rotatedWidth = Int((Double(width) * c + Double(height) * s).rounded(.up))
+                    let rotatedHeight = Int((Double(width) * s + Double(height) * c).rounded(.up))
+                    width = rotatedWidth
+                    height = rotatedHeight
+                    record("rotate", pixels: width * height)
+                }
+
+            case .flip(let direction):
+                let passes = direction == .both ? 2 : 1
+                record("flip", pixels: width * height * passes)
+
+            case .autoRotate:
+                if let orientation = probe.orientation, (5...8).contains(orientation) {
+                    swap(&width, &height)
+                }
+                record("autorotate", pixels: width * height)
+
+            case .affine(let affine, _, _):
+                let bounds = affine.bounds(width: width, height: height)
+                width = max(1, Int((bounds.maxX - bounds.minX).rounded()))
+                height = max(1, Int((bounds.maxY - bounds.minY).rounded()))
+                record("affine", pixels: width * height)
+
+            case .custom:
+                record("custom", pixels: width * height)
+            }
+        }
+
+        let outputFormat = recipe.output.format ?? probe.format
+        record("encode.\(outputFormat?.rawValue ?? "unknown")", pixels: width * height)
+
+        // PURPOSE: Matches the materialized stage boundaries: decoded raster,
+        // transformed raster, and an encode buffer bounded by the raw output size.
+        let bytesPerPixel = max(1, probe.channels)
+        let peakMemory = decodedPixels * bytesPerPixel + 2 * width * height * bytesPerPixel
+
+        return CostEstimate(
+            inputPixels: inputPixels,
+            decodeShrink: shrink,
+            decodedPixels: decodedPixels,
+            outputWidth: width,
+            outputHeight: height,
+            operations: operations,
+            peakMemoryBytes: peakMemory
+        )
+    }
+}
+
+/// PURPOSE: Decide decoder shrink-on-load for recipes that start with a downscale.
+/// CONSTRAINTS:
+/// - JPEG shrinks by 2, 4, or 8 in the DCT domain; WebP scales by any integer.
+/// - Leave at least a 2x reduction for the resize kernel so antialiasing quality holds.
+enum DecodeShrink {
+    static func factor(for probe: ImageMetadata, firstStep: ProcessingStep?) -> Int {
+        guard let format = probe.format, format == .jpeg || format == .webp,
+              case .resize(let options)? = firstStep,
+              probe.width > 0, probe.height > 0,
+              let target = try? HokusaiImage.calculateDimensions(
+                  currentWidth: probe.width,
+                  currentHeight: probe.height,
+                  targetWidth: options.width,
+                  targetHeight: options.height,
+                  fit: options.fit,
+                  withoutEnlargement: options.withoutEnlargement,
+                  withoutReduction: options.withoutReduction
+              ),
+              target.width > 0, target.height > 0 else {
+            return 1
+        }
+
+        let reduction = min(
+            Double(probe.width) / Double(target.width),
+            Double(probe.height) / Double(target.height)
+        )
+        let allowed = Int(reduction / 2)
+        guard allowed >= 2 else { return 1 }
+
+        if format == .jpeg {
+            return [8, 4, 2].first { $0 <= allowed } ?? 1
+        }
+        return allowed
+    }
+}
+
+extension ProcessingRecipe {
+    /// PURPOSE: Open an input, using decoder shrink-on-load when the first step downsizes.
+    func load(_ input: ImageInput) throws -> HokusaiImage {
+        return try load(open: input.load, reopen: input.load(format:shrink:))
+    }
+
+    /// PURPOSE: Zero-copy open of prefetched bytes; the buffer is held until libvips closes the image.
+    func load(_ buffer: PooledBuffer) throws -> HokusaiImage {
+        return try load(
+            open: {
+                HokusaiImage(backend: .vips(try VipsBackend.loadFromBuffer(buffer.pointer, count: buffer.count, owner: buffer)))
+            },
+            reopen: { format, shrink in
+                HokusaiImage(backend: .vips(try VipsBackend.loadFromBuffer(
+                    buffer.pointer,
+                    count: buffer.count,
+                    owner: buffer,
+                    format: format,
+                    shrink: shrink
+                )))
+            }
+        )
+    }
+
+    // MARK: - Private Helpers
+
+    private func load(
+        open: () throws -> HokusaiImage,
+        reopen: (ImageFormat, Int) throws -> HokusaiImage
+    ) throws -> HokusaiImage {
+        let image = try open()
+        let probe = try image.metadata()
+        let shrink = DecodeShrink.factor(for: probe, firstStep: steps.first)
+        guard shrink > 1, let format = probe.format else {
+            return image
+        }
+        return try reopen(format, shrink)
+    }
+}
+
+extension CostModel {
+    /// PURPOSE: Fit coefficients to `hokusai benchmark suite --json-output` results.
+    /// ALGORITHM:
+    /// - Rebuild each known suite case as a recipe and estimate it with `base`.
+    /// - Scale every coefficient used by a case by the geometric mean of measured/estimated.
+    /// - Scale coefficients no case covers by the median ratio (overall machine speed).
+    /// CONSTRAINTS: Requires the `input` block written by current CLI versions.
+    public static func calibrated(fromBenchmarkSuite data: Data, base: CostModel = .default) throws -> CostModel {
+        let suite = try JSONDecoder().decode(BenchmarkSuiteCalibration.self, from: data)
+        guard let input = suite.input else {
+            throw HokusaiError.invalidOperation("Benchmark suite has no input dimensions; re-run `hokusai benchmark suite`")
+        }
+
+        let probe = ImageMetadata(
+            width: input.width,
+            height: input.height,
+            channels: input.channels,
+            format: input.format.flatMap(ImageFormat.init(rawValue:))
+        )
+
+        var ratiosByOperation: [String: [Double]] = [:]
+        var allRatios: [Double] = []
+        for suiteCase in suite.cases {
+            guard let recipe = calibrationRecipe(for: suiteCase.name) else { continue }
+            let estimate = try Hokusai.estimateCost(probe: probe, recipe: recipe, model: base)
+            guard estimate.estimatedMs > 0, suiteCase.stats.meanMs > 0 else { continue }
+
+            let ratio = suiteCase.stats.meanMs / estimate.estimatedMs
+            allRatios.append(ratio)
+            for operation in estimate.operations {
+                ratiosByOperation[operation.operation, default: []].append(ratio)
+            }
+        }
+
+        guard !allRatios.isEmpty else {
+            throw HokusaiError.invalidOperation("Benchmark suite has no cases usable for calibration")
+        }
+
+        let sortedRatios = allRatios.sorted()
+        let medianRatio = sortedRatios[sortedRatios.count / 2]
+
+        var calibrated = base
+        let keys = Set(base.nanosecondsPerPixel.keys).union(ratiosByOperation.keys)
+        for key in keys {
+            let ratio = ratiosByOperation[key].map(geometricMean) ?? medianRatio
+            calibrated.nanosecondsPerPixel[key] = base.coefficient(for: key) * ratio
+        }
+        calibrated.fallbackNanosecondsPerPixel = base.fallbackNanosecondsPerPixel * medianRatio
+        return calibrated
+    }
+
+    // MARK: - Private Helpers
+
+    /// PURPOSE: Mirror the recipes run by `hokusai benchmark suite`.
+    private static func calibrationRecipe(for name: String) -> ProcessingRecipe? {
+        let parts = name.split(separator: ":").map(String.init)
+        guard let kind = parts.first else { return nil }
+
+        switch kind {
+        case "resize":
+            let size = parts.count > 1 ? parts[1].split(separator: "x").compactMap { Int($0) } : []
+            guard size.count == 2 else { return nil }
+            return ProcessingRecipe(
+                steps: [.resize(ResizeOptions(width: size[0], height: size[1], fit: .fill))],
+                output: SaveOptions(format: .jpeg, quality: 85)
+            )
+        case "convert":
+            guard parts.count > 1, let format = ImageFormat(rawValue: parts[1]) else { return nil }
+            return ProcessingRecipe(output: SaveOptions(format: format))
+        case "rotate":
+            guard parts.count > 1, let angle = Double(parts[1]) else { return nil }
+            return ProcessingRecipe(
+                steps: [.rotate(.custom(angle))],
+                output: SaveOptions(format: .jpeg, quality: 85)
+            )
+        default:
+            return nil
+        }
+    }
+
+    private static func geometricMean(_ values: [Double]) -> Double {
+        let logSum = values.reduce(0) { $0 + log($1) }
+        return exp(logSum / Double(values.count))
+    }
+}
+
+/// PURPOSE: Subset of the CLI benchmark suite JSON needed for calibration.
+private struct BenchmarkSuiteCalibration: Decodable {
+    struct Input: Decodable {
+        let width: Int
+        let height: Int
+        let channels: Int
+        let format: String?
+    }
+
+    struct Stats: Decodable {
+        let meanMs: Double
+    }
+
+    struct Case: Decodable {
+        let name: String
+        let stats: Stats
+    }
+
+    let input: Input?
+    let cases: [Case]
+}
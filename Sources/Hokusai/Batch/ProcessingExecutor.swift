@@ -0,0 +1,370 @@
+import Foundation
+
+/// PURPOSE: Scheduling class of a processing job
+public enum PriorityClass: String, CaseIterable, Comparable, Sendable {
+    /// PURPOSE: Latency-sensitive requests (thumbnails, previews)
+    case interactive
+
+    /// PURPOSE: Regular request traffic
+    case standard
+
+    /// PURPOSE: Bulk work (backfills, re-encodes)
+    case batch
+
+    public static func < (lhs: PriorityClass, rhs: PriorityClass) -> Bool {
+        return lhs.rank < rhs.rank
+    }
+
+    var rank: Int {
+        switch self {
+        case .interactive: return 0
+        case .standard: return 1
+        case .batch: return 2
+        }
+    }
+}
+
+/// PURPOSE: Slot and fairness settings for `ProcessingExecutor`
+public struct ProcessingExecutorConfiguration: Sendable {
+    /// PURPOSE: Stages allowed to run at the same time (nil: the batch worker default).
+    /// Raised if needed so at least one slot is left for standard and batch work.
+    public var maxConcurrent: Int?
+
+    /// PURPOSE: Slots only interactive work may use, so it never waits behind bulk stages
+    public var reservedInteractiveSlots: Int
+
+    /// PURPOSE: Soft cap in bytes on the estimated peak memory of jobs in flight
+    /// (nil: unbounded). A job larger than the budget still runs, but alone.
+    public var memoryBudget: Int?
+
+    /// PURPOSE: Relative share per tenant key within a class (missing tenants weigh 1)
+    public var tenantWeights: [String: Double]
+
+    /// PURPOSE: Queue-latency samples kept per class for percentiles
+    public var latencySampleLimit: Int
+
+    /// PURPOSE: Pixel cost model used to weight stages (cheaper stages dispatch first)
+    public var costModel: CostModel
+
+    public init(
+        maxConcurrent: Int? = nil,
+        reservedInteractiveSlots: Int = 1,
+        tenantWeights: [String: Double] = [:],
+        latencySampleLimit: Int = 1024,
+        costModel: CostModel = .default,
+        memoryBudget: Int? = nil
+    ) {
+        self.maxConcurrent = maxConcurrent
+        self.reservedInteractiveSlots = reservedInteractiveSlots
+        self.memoryBudget = memoryBudget
+        self.tenantWeights = tenantWeights
+        self.latencySampleLimit = latencySampleLimit
+        self.costModel = costModel
+    }
+}
+
+/// PURPOSE: Queue wait percentiles for one priority class
+public struct QueueLatencyStatistics: Sendable {
+    public let priority: PriorityClass
+
+    /// PURPOSE: Stage dispatches recorded (all time)
+    public let dispatched: Int
+
+    /// PURPOSE: Jobs currently waiting for a slot
+    public let waiting: Int
+
+    /// PURPOSE: Percentiles over the most recent samples, in milliseconds
+    public let p50Ms: Double
+    public let p95Ms: Double
+    public let p99Ms: Double
+    public let maxMs: Double
+}
+
+/// PURPOSE: Shared executor with priority classes and weighted fair queuing across tenants.
+/// CONSTRAINTS:
+/// - Every job runs as decode, transform, and encode stages; each stage re-enters the
+///   queue, so interactive work can overtake a bulk job between its stages.
+/// - Classes are served in strict priority order; `reservedInteractiveSlots` are never
+///   given to standard or batch work.
+/// - Within a class, tenants share slots by weighted fair queuing on estimated stage
+///   milliseconds, so short jobs finish ahead of long ones from the same tenant.
+/// - A job holds its estimated peak memory against `memoryBudget` from decode until
+///   encode returns; each stage evaluates with `cores / slots` libvips threads.
+/// - Stage bodies are blocking libvips calls and run on a dispatch queue, never on
+///   the Swift concurrency pool.
+/// AI HINTS:
+/// - Decode and transform materialize pixels so each slot covers the work it was
+///   charged for, as `StagedPipeline` stages do.
+public final class ProcessingExecutor: Sendable {
+    private let scheduler: FairScheduler
+    private let costModel: CostModel
+    private let memoryGate: MemoryGate
+    private let threadsPerStage: Int
+    private let queue = DispatchQueue(label: "hokusai-executor", attributes: .concurrent)
+
+    public init(configuration: ProcessingExecutorConfiguration = ProcessingExecutorConfiguration()) {
+        self.scheduler = FairScheduler(configuration: configuration)
+        self.costModel = configuration.costModel
+        self.memoryGate = MemoryGate(budget: configuration.memoryBudget)
+        self.threadsPerStage = BatchLimits.vipsThreads(forWorkers: FairScheduler.slotCount(for: configuration))
+    }
+
+    /// PURPOSE: Run one recipe under the executor's scheduling policy.
+    /// INPUT: `tenant` is any caller-chosen fairness key (account, API key, queue name).
+    /// OUTPUT: Encoded bytes.
+    public func submit(
+        _ input: ImageInput,
+        recipe: ProcessingRecipe,
+        priority: PriorityClass = .standard,
+        tenant: String = "default"
+    ) async throws -> Data {
+        // PURPOSE: Header probe runs outside the slots; it only parses the file header.
+        let (opened, estimate) = try await runBlocking { [costModel] in
+            let opened = try recipe.load(input)
+            return (opened, try Hokusai.estimateCost(probe: opened.metadata(), recipe: recipe, model: costModel))
+        }
+        let operations = estimate.operations
+        let decodeCost = operations.first?.estimatedMs ?? 1
+        let encodeCost = operations.last?.estimatedMs ?? 1
+        let transformCost = max(0, estimate.estimatedMs - decodeCost - encodeCost)
+        let threads = threadsPerStage
+
+        try await memoryGate.acquire(estimate.peakMemoryBytes)
+        do {
+            let decoded = try await runStage(priority: priority, tenant: tenant, cost: decodeCost) {
+                try opened.limitingConcurrency(threads).materialized()
+            }
+            let transformed = try await runStage(priority: priority, tenant: tenant, cost: transformCost) {
+                try recipe.transform(decoded).limitingConcurrency(threads).materialized()
+            }
+            let data = try await runStage(priority: priority, tenant: tenant, cost: encodeCost) {
+                try recipe.encode(transformed.limitingConcurrency(threads))
+            }
+            await memoryGate.release(estimate.peakMemoryBytes)
+            return data
+        } catch {
+            await memoryGate.release(estimate.peakMemoryBytes)
+            throw error
+        }
+    }
+
+    /// PURPOSE: Per-class queue latency percentiles and current waiters.
+    public func queueLatencyStatistics() async -> [QueueLatencyStatistics] {
+        return await scheduler.statistics()
+    }
+
+    // MARK: - Private Helpers
+
+    private func runStage<T: Sendable>(
+        priority: PriorityClass,
+        tenant: String,
+        cost: Double,
+        _ body: @escaping @Sendable () throws -> T
+    ) async throws -> T {
+        try await scheduler.acquire(priority: priority, tenant: tenant, cost: cost)
+        let result: Result<T, Error>
+        do {
+            result = .success(try await runBlocking(body))
+        } catch {
+            result = .failure(error)
+        }
+        await scheduler.release(priority: priority)
+        return try result.get()
+    }
+
+    /// PURPOSE: Run `body` on the executor's dispatch queue and resume with its result.
+    private func runBlocking<T: Sendable>(_ body: @escaping @Sendable () throws -> T) async throws -> T {
+        return try await withCheckedThrowingContinuation { continuation in
+            queue.async {
+                continuation.resume(with: Result { try body() })
+            }
+        }
+    }
+}
+
+/// PURPOSE: Slot accounting plus strict-priority / weighted-fair dispatch.
+/// ALGORITHM:
+/// - Each (class, tenant) has a FIFO; a waiter's start tag is
+///   `max(classVirtualTime, tenantLastFinish)` and its finish tag adds `cost / tenantWeight`.
+/// - Dispatch picks the highest class with an admissible waiter, then the smallest
+///   finish tag, and moves class virtual time up to that waiter's start tag.
+actor FairScheduler {
+    private struct Waiter {
+        let id: Int
+        let tenant: String
+        let startTag: Double
+        let finishTag: Double
+        let enqueuedAt: UInt64
+        let continuation: CheckedContinuation<Void, Error>
+    }
+
+    private let configuration: ProcessingExecutorConfiguration
+    private let slots: Int
+    private var running = 0
+    private var queues: [PriorityClass: [String: [Waiter]]] = [:]
+    private var virtualTime: [PriorityClass: Double] = [:]
+    private var lastFinish: [PriorityClass: [String: Double]] = [:]
+    private var latencySamples: [PriorityClass: [Double]] = [:]
+    private var sampleCursor: [PriorityClass: Int] = [:]
+    private var dispatched: [PriorityClass: Int] = [:]
+    private var nextWaiterID = 0
+
+    init(configuration: ProcessingExecutorConfiguration) {
+        self.slots = Self.slotCount(for: configuration)
+        self.configuration = configuration
+    }
+
+    /// PURPOSE: Total slots; always leaves at least one beyond the interactive reserve.
+    static func slotCount(for configuration: ProcessingExecutorConfiguration) -> Int {
+        let reserved = max(0, configuration.reservedInteractiveSlots)
+        let requested = configuration.maxConcurrent ?? BatchLimits.workerCount(requested: nil)
+        return max(requested, reserved + 1)
+    }
+
+    /// PURPOSE: Wait for a slot; throws `CancellationError` (and leaves the queue) if the task is cancelled.
+    func acquire(priority: PriorityClass, tenant: String, cost: Double) async throws {
+        let weight = max(configuration.tenantWeights[tenant] ?? 1, 0.001)
+        let startTag = max(virtualTime[priority] ?? 0, lastFinish[priority]?[tenant] ?? 0)
+        let finishTag = startTag + max(cost, 0) / weight
+        lastFinish[priority, default: [:]][tenant] = finishTag
+
+        if waitingCount(priority) == 0 && !hasWaitersAbove(priority) && admits(priority) {
+            running += 1
+            advanceVirtualTime(priority, to: startTag)
+            recordLatency(priority, nanos: 0)
+            return
+        }
+
+        let id = nextWaiterID
+        nextWaiterID += 1
+        let enqueuedAt = DispatchTime.now().uptimeNanoseconds
+        try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { continuation in
+                if Task.isCancelled {
+                    continuation.resume(throwing: CancellationError())
+                    return
+                }
+                queues[priority, default: [:]][tenant, default: []].append(Waiter(
+                    id: id,
+                    tenant: tenant,
+                    startTag: startTag,
+                    finishTag: finishTag,
+                    enqueuedAt: enqueuedAt,
+                    continuation: continuation
+                ))
+            }
+        } onCancel: {
+            Task { await self.cancelWaiter(id, priority: priority, tenant: tenant) }
+        }
+    }
+
+    func release(priority: PriorityClass) {
+        running -= 1
+        dispatch()
+    }
+
+    func statistics() -> [QueueLatencyStatistics] {
+        return PriorityClass.allCases.map { priority in
+            let sorted = (latencySamples[priority] ?? []).sorted()
+
+            func percentile(_ p: Double) -> Double {
+                guard !sorted.isEmpty else { return 0 }
+                let rank = Int((p * Double(sorted.count - 1)).rounded())
+                return sorted[min(max(rank, 0), sorted.count - 1)]
+            }
+
+            return QueueLatencyStatistics(
+                priority: priority,
+                dispatched: dispatched[priority] ?? 0,
+                waiting: waitingCount(priority),
+                p50Ms: percentile(0.50),
+                p95Ms: percentile(0.95),
+                p99Ms: percentile(0.99),
+                maxMs: sorted.last ?? 0
+            )
+        }
+    }
+
+    // MARK: - Private Helpers
+
+    private func dispatch() {
+        while let next = nextWaiter() {
+            let (priority, tenant) = next
+            guard var tenantQueue = queues[priority]?[tenant], !tenantQueue.isEmpty else { return }
+            let waiter = tenantQueue.removeFirst()
+            queues[priority]?[tenant] = tenantQueue.isEmpty ? nil : tenantQueue
+
+            running += 1
+            advanceVirtualTime(priority, to: waiter.startTag)
+            recordLatency(priority, nanos: DispatchTime.now().uptimeNanoseconds - waiter.enqueuedAt)
+            waiter.continuation.resume()
+        }
+    }
+
+    private func nextWaiter() -> (PriorityClass, String)? {
+        for priority in PriorityClass.allCases.sorted() {
+            guard let tenants = queues[priority], !tenants.isEmpty else { continue }
+            guard admits(priority) else { return nil }
+
+            let best = tenants.min { lhs, rhs in
+                (lhs.value.first?.finishTag ?? .infinity) < (rhs.value.first?.finishTag ?? .infinity)
+            }
+            if let best {
+                return (priority, best.key)
+            }
+        }
+        return nil
+    }
+
+    private func admits(_ priority: PriorityClass) -> Bool {
+        if priority == .interactive {
+            return running < slots
+        }
+        let shared = slots - max(0, configuration.reservedInteractiveSlots)
+        return running < shared
+    }
+
+    /// PURPOSE: Class virtual time follows the start tag of the latest dispatch and never goes back.
+    private func advanceVirtualTime(_ priority: PriorityClass, to startTag: Double) {
+        virtualTime[priority] = max(virtualTime[priority] ?? 0, startTag)
+    }
+
+    private func cancelWaiter(_ id: Int, priority: PriorityClass, tenant: String) {
+        guard var tenantQueue = queues[priority]?[tenant],
+              let index = tenantQueue.firstIndex(where: { $0.id == id }) else {
+            return
+        }
+        let waiter = tenantQueue.remove(at: index)
+        queues[priority]?[tenant] = tenantQueue.isEmpty ? nil : tenantQueue
+        // PURPOSE: Give the tenant back the virtual time it never used.
+        if lastFinish[priority]?[tenant] == waiter.finishTag {
+            lastFinish[priority]?[tenant] = waiter.startTag
+        }
+        waiter.continuation.resume(throwing: CancellationError())
+        dispatch()
+    }
+
+    private func hasWaitersAbove(_ priority: PriorityClass) -> Bool {
+        return PriorityClass.allCases.contains { $0 < priority && waitingCount($0) > 0 }
+    }
+
+    private func waitingCount(_ priority: PriorityClass) -> Int {
+        return queues[priority]?.values.reduce(0) { $0 + $1.count } ?? 0
+    }
+
+    private func recordLatency(_ priority: PriorityClass, nanos: UInt64) {
+        let limit = max(1, configuration.latencySampleLimit)
+        let milliseconds = Double(nanos) / 1_000_000.0
+        dispatched[priority, default: 0] += 1
+
+        var samples = latencySamples[priority] ?? []
+        if samples.count < limit {
+            samples.append(milliseconds)
+        } else {
+            let cursor = sampleCursor[priority] ?? 0
+            samples[cursor] = milliseconds
+            sampleCursor[priority] = (cursor + 1) % limit
+        }
+        latencySamples[priority] = samples
+    }
+}
@@ -0,0 +1,467 @@
+import Foundation
+
+/// PURPOSE: Phases of a staged batch job
+public enum PipelineStage: String, CaseIterable, Sendable {
+    /// PURPOSE: Open the input with shrink-on-load and decode it into memory
+    case decode
+
+    /// PURPOSE: Run the recipe's steps over the decoded pixels into a new buffer
+    case transform
+
+    /// PURPOSE: Compress the transformed pixels into the output format
+    case encode
+}
+
+/// PURPOSE: Worker and queue settings for `StagedPipeline`
+public struct StagedPipelineConfiguration: Sendable {
+    /// PURPOSE: Initial workers per stage
+    public var decodeWorkers: Int
+    public var transformWorkers: Int
+    public var encodeWorkers: Int
+
+    /// PURPOSE: Capacity of the queue in front of each stage
+    public var queueCapacity: Int
+
+    /// PURPOSE: Move workers toward the busiest stage while running
+    public var autoBalance: Bool
+
+    /// PURPOSE: Upper bound on workers across all stages (default: active cores)
+    public var maxTotalWorkers: Int
+
+    /// PURPOSE: Seconds between balancing decisions
+    public var balanceInterval: Double
+
+    public init(
+        decodeWorkers: Int = 1,
+        transformWorkers: Int = 1,
+        encodeWorkers: Int = 2,
+        queueCapacity: Int = 4,
+        autoBalance: Bool = true,
+        maxTotalWorkers: Int = ProcessInfo.processInfo.activeProcessorCount,
+        balanceInterval: Double = 0.25
+    ) {
+        self.decodeWorkers = decodeWorkers
+        self.transformWorkers = transformWorkers
+        self.encodeWorkers = encodeWorkers
+        self.queueCapacity = queueCapacity
+        self.autoBalance = autoBalance
+        self.maxTotalWorkers = maxTotalWorkers
+        self.balanceInterval = balanceInterval
+    }
+}
+
+/// PURPOSE: Point-in-time counters for one pipeline stage
+public struct PipelineStageStatistics: Sendable {
+    public let stage: PipelineStage
+
+    /// PURPOSE: Workers currently assigned to the stage
+    public let workers: Int
+
+    /// PURPOSE: Items completed by the stage
+    public let processed: Int
+
+    /// PURPOSE: Busy fraction of assigned workers over the last balance window (0...1)
+    public let utilization: Double
+
+    /// PURPOSE: Items waiting in front of the stage
+    public let queueDepth: Int
+
+    /// PURPOSE: Highest queue depth observed
+    public let maxQueueDepth: Int
+}
+
+/// PURPOSE: Batch executor that runs decode, transform, and encode on separate worker pools.
+/// CONSTRAINTS:
+/// - Each stage owns a bounded input queue; full queues apply backpressure upstream.
+/// - Decode and transform materialize their result, so each stage's time is its own
+///   pixel work and auto-balance sees where the cost really is. Queued images are
+///   decoded rasters: memory grows with `queueCapacity` and the worker counts.
+/// - Each image evaluates with `cores / total workers` libvips threads, recomputed
+///   from the live worker targets as auto-balance resizes the stages.
+/// - Workers are dedicated threads: stage work is blocking libvips calls and must
+///   not occupy the Swift concurrency pool.
+/// - One `process` call per pipeline instance.
+/// AI HINTS:
+/// - Auto-balance only moves whole workers; keep at least one worker per stage.
+public final class StagedPipeline: @unchecked Sendable {
+    private let recipe: ProcessingRecipe
+    private let configuration: StagedPipelineConfiguration
+    private let runners: [StageRunner]
+
+    public init(recipe: ProcessingRecipe, configuration: StagedPipelineConfiguration = StagedPipelineConfiguration()) {
+        self.recipe = recipe
+        self.configuration = configuration
+
+        let capacity = configuration.queueCapacity
+        let budget = StageThreadBudget()
+        self.runners = [
+            StageRunner(stage: .decode, workers: configuration.decodeWorkers, capacity: capacity, budget: budget) { item, threads in
+                item.opened { input in .image(try recipe.load(input).limitingConcurrency(threads).materialized()) }
+            },
+            StageRunner(stage: .transform, workers: configuration.transformWorkers, capacity: capacity, budget: budget) { item, threads in
+                item.mapImage { image in .image(try recipe.transform(image).limitingConcurrency(threads).materialized()) }
+            },
+            StageRunner(stage: .encode, workers: configuration.encodeWorkers, capacity: capacity, budget: budget) { item, threads in
+                item.mapImage { image in .encoded(try recipe.encode(image.limitingConcurrency(threads))) }
+            },
+        ]
+    }
+
+    /// PURPOSE: Feed inputs through the three stages.
+    /// OUTPUT: Stream of `BatchOutput` in completion order with per-item errors.
+    public func process(_ inputs: some Sequence<ImageInput>) -> AsyncThrowingStream<BatchOutput, Error> {
+        let items = Array(inputs.enumerated())
+        let (stream, continuation) = AsyncThrowingStream<BatchOutput, Error>.makeStream()
+        let decode = runners[0]
+        let transform = runners[1]
+        let encode = runners[2]
+
+        decode.connect(to: transform.input)
+        transform.connect(to: encode.input)
+        encode.connect { item in
+            continuation.yield(BatchOutput(index: item.index, input: item.input, result: item.encodedResult))
+        } onFinish: {
+            continuation.finish()
+        }
+
+        // PURPOSE: `push` blocks on backpressure, so feed from a thread; a cancelled
+        // run closes the queue and the rejected push ends the loop.
+        let feeder = Thread {
+            for (index, input) in items {
+                guard decode.input.push(PipelineItem(index: index, input: input, payload: .success(.pending))) else {
+                    break
+                }
+            }
+            decode.input.close()
+        }
+        feeder.name = "hokusai-pipeline-feed"
+        feeder.start()
+
+        for runner in runners {
+            runner.start()
+        }
+
+        let balancer = Task { [configuration, runners] in
+            guard configuration.autoBalance else { return }
+            let intervalNanos = UInt64(max(0.01, configuration.balanceInterval) * 1_000_000_000)
+            while !runners.allSatisfy({ $0.isFinished }) {
+                try? await Task.sleep(nanoseconds: intervalNanos)
+                if Task.isCancelled { return }
+                Self.rebalance(runners, maxTotalWorkers: configuration.maxTotalWorkers)
+            }
+        }
+
+        continuation.onTermination = { [runners] _ in
+            balancer.cancel()
+            for runner in runners {
+                runner.cancel()
+            }
+        }
+
+        return stream
+    }
+
+    /// PURPOSE: Snapshot of per-stage workers, utilization, and queue depth.
+    public func statistics() async -> [PipelineStageStatistics] {
+        var result: [PipelineStageStatistics] = []
+        for runner in runners {
+            result.append(runner.statistics())
+        }
+        return result
+    }
+
+    // MARK: - Private Helpers
+
+    /// PURPOSE: Give the busiest stage another worker, taking one from the idlest stage at the cap.
+    /// ALGORITHM:
+    /// - Rank stages by window utilization, breaking ties by queue depth.
+    /// - Grow the busiest stage while under `maxTotalWorkers`.
+    /// - At the cap, move one worker from a stage below 50% utilization.
+    private static func rebalance(_ runners: [StageRunner], maxTotalWorkers: Int) {
+        var samples: [(runner: StageRunner, utilization: Double, depth: Int)] = []
+        for runner in runners where !runner.isFinished {
+            let utilization = runner.takeWindowUtilization()
+            samples.append((runner, utilization, runner.input.depth))
+        }
+
+        let ranked = samples.sorted { lhs, rhs in
+            if lhs.utilization != rhs.utilization {
+                return lhs.utilization > rhs.utilization
+            }
+            return lhs.depth > rhs.depth
+        }
+
+        guard let busiest = ranked.first, busiest.utilization > 0.9 || busiest.depth > 0 else {
+            return
+        }
+
+        let totalWorkers = runners.reduce(0) { $0 + $1.targetWorkers }
+        if totalWorkers < maxTotalWorkers {
+            busiest.runner.setTargetWorkers(busiest.runner.targetWorkers + 1)
+            return
+        }
+
+        if let idlest = ranked.last,
+           idlest.runner !== busiest.runner,
+           idlest.utilization < 0.5,
+           idlest.runner.targetWorkers > 1 {
+            idlest.runner.setTargetWorkers(idlest.runner.targetWorkers - 1)
+            busiest.runner.setTargetWorkers(busiest.runner.targetWorkers + 1)
+        }
+    }
+}
+
+
+/// PURPOSE: Value carried between stages
+enum PipelinePayload: Sendable {
+    /// PURPOSE: Input not opened yet (before the decode stage)
+    case pending
+    case image(HokusaiImage)
+    case encoded(Data)
+}
+
+/// PURPOSE: Unit of work passed between stages; failures ride along untouched.
+struct PipelineItem: Sendable {
+    let index: Int
+    let input: ImageInput
+    let payload: Result<PipelinePayload, Error>
+
+    /// PURPOSE: Open the input of a pending item, capturing its error per item.
+    func opened(_ open: (ImageInput) throws -> PipelinePayload) -> PipelineItem {
+        let next = payload.flatMap { value -> Result<PipelinePayload, Error> in
+            guard case .pending = value else {
+                return .failure(HokusaiError.invalidOperation("Pipeline input was opened twice"))
+            }
+            return Result { try open(input) }
+        }
+        return PipelineItem(index: index, input: input, payload: next)
+    }
+
+    /// PURPOSE: Apply a stage to the image payload, capturing its error per item.
+    func mapImage(_ transform: (HokusaiImage) throws -> PipelinePayload) -> PipelineItem {
+        let next = payload.flatMap { value -> Result<PipelinePayload, Error> in
+            guard case .image(let image) = value else {
+                return .failure(HokusaiError.invalidOperation("Pipeline stage received no image"))
+            }
+            return Result { try transform(image) }
+        }
+        return PipelineItem(index: index, input: input, payload: next)
+    }
+
+    /// PURPOSE: Final encoded bytes for `BatchOutput`.
+    var encodedResult: Result<Data, Error> {
+        return payload.flatMap { value -> Result<Data, Error> in
+            guard case .encoded(let data) = value else {
+                return .failure(HokusaiError.invalidOperation("Pipeline finished without encoding"))
+            }
+            return .success(data)
+        }
+    }
+}
+
+/// PURPOSE: Worker targets of every stage, used to split libvips threads between images.
+/// CONSTRAINTS: Shared by the runners of one pipeline; guarded by `lock`.
+final class StageThreadBudget: @unchecked Sendable {
+    private let lock = NSLock()
+    private var targets: [PipelineStage: Int] = [:]
+
+    func setWorkers(_ count: Int, for stage: PipelineStage) {
+        lock.lock()
+        targets[stage] = count
+        lock.unlock()
+    }
+
+    /// PURPOSE: libvips threads for one image while every stage runs at its current target.
+    var threadsPerImage: Int {
+        lock.lock()
+        let workers = targets.values.reduce(0, +)
+        lock.unlock()
+        return BatchLimits.vipsThreads(forWorkers: workers)
+    }
+}
+
+/// PURPOSE: Thread pool for one stage with resizable worker count and utilization accounting.
+/// CONSTRAINTS: Mutable counters are guarded by `lock`.
+final class StageRunner: @unchecked Sendable {
+    let stage: PipelineStage
+    let input: BoundedQueue<PipelineItem>
+
+    /// PURPOSE: Stage body; receives the item and its libvips thread allowance.
+    private let work: @Sendable (PipelineItem, Int) -> PipelineItem
+    private let budget: StageThreadBudget
+    private var emit: (@Sendable (PipelineItem) -> Void)?
+    private var onFinish: (@Sendable () -> Void)?
+
+    private let lock = NSLock()
+    private var target: Int
+    private var active = 0
+    private var processed = 0
+    private var windowBusyNanos: UInt64 = 0
+    private var windowStart = DispatchTime.now().uptimeNanoseconds
+    private var lastUtilization = 0.0
+    private var finished = false
+    private var cancelled = false
+    private var spawned = 0
+
+    init(
+        stage: PipelineStage,
+        workers: Int,
+        capacity: Int,
+        budget: StageThreadBudget,
+        work: @escaping @Sendable (PipelineItem, Int) -> PipelineItem
+    ) {
+        self.stage = stage
+        self.input = BoundedQueue(capacity: capacity)
+        self.target = max(1, workers)
+        self.budget = budget
+        self.work = work
+        budget.setWorkers(self.target, for: stage)
+    }
+
+    func connect(to next: BoundedQueue<PipelineItem>) {
+        connect { item in
+            next.push(item)
+        } onFinish: {
+            next.close()
+        }
+    }
+
+    func connect(
+        emit: @escaping @Sendable (PipelineItem) -> Void,
+        onFinish: @escaping @Sendable () -> Void
+    ) {
+        self.emit = emit
+        self.onFinish = onFinish
+    }
+
+    var isFinished: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return finished
+    }
+
+    var targetWorkers: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return target
+    }
+
+    func start() {
+        setTargetWorkers(targetWorkers)
+    }
+
+    /// PURPOSE: Resize the pool; extra workers retire after their current item.
+    func setTargetWorkers(_ count: Int) {
+        lock.lock()
+        target = max(1, count)
+        budget.setWorkers(target, for: stage)
+        let missing = finished || cancelled ? 0 : max(0, target - active)
+        active += missing
+        let firstIndex = spawned
+        spawned += missing
+        lock.unlock()
+
+        for index in firstIndex..<(firstIndex + missing) {
+            let thread = Thread { [self] in
+                workerLoop()
+            }
+            thread.name = "hokusai-\(stage.rawValue)-\(index)"
+            thread.start()
+        }
+    }
+
+    /// PURPOSE: Stop workers after their current item and wake any blocked on the queue.
+    func cancel() {
+        lock.lock()
+        cancelled = true
+        lock.unlock()
+        input.close()
+    }
+
+    /// PURPOSE: Busy fraction since the previous call; resets the window.
+    func takeWindowUtilization() -> Double {
+        lock.lock()
+        defer { lock.unlock() }
+
+        let now = DispatchTime.now().uptimeNanoseconds
+        let elapsed = Double(max(1, now - windowStart))
+        lastUtilization = min(1.0, Double(windowBusyNanos) / (elapsed * Double(max(1, target))))
+        windowBusyNanos = 0
+        windowStart = now
+        return lastUtilization
+    }
+
+    func statistics() -> PipelineStageStatistics {
+        let depth = input.depth
+        let maxDepth = input.maxDepth
+
+        lock.lock()
+        defer { lock.unlock() }
+        return PipelineStageStatistics(
+            stage: stage,
+            workers: active,
+            processed: processed,
+            utilization: lastUtilization,
+            queueDepth: depth,
+            maxQueueDepth: maxDepth
+        )
+    }
+
+    // MARK: - Private Helpers
+
+    private func workerLoop() {
+        while !isCancelled {
+            if retireIfAboveTarget() {
+                return
+            }
+            guard let item = input.pop() else {
+                break
+            }
+
+            let start = DispatchTime.now().uptimeNanoseconds
+            let output = work(item, budget.threadsPerImage)
+            recordBusy(since: start)
+            emit?(output)
+        }
+        workerDrained()
+    }
+
+    private var isCancelled: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return cancelled
+    }
+
+    /// PURPOSE: Leave the pool when it is above target; never drops the last worker.
+    private func retireIfAboveTarget() -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard active > target else { return false }
+        active -= 1
+        return true
+    }
+
+    private func recordBusy(since start: UInt64) {
+        let elapsed = DispatchTime.now().uptimeNanoseconds - start
+        lock.lock()
+        windowBusyNanos += elapsed
+        processed += 1
+        lock.unlock()
+    }
+
+    /// PURPOSE: Close the downstream queue once the last worker sees the input drained.
+    private func workerDrained() {
+        lock.lock()
+        active -= 1
+        let isLast = active == 0 && !finished
+        if isLast {
+            finished = true
+        }
+        lock.unlock()
+
+        if isLast {
+            onFinish?()
+        }
+    }
+}
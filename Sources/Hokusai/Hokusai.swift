@@ -1,4 +1,5 @@
 import Foundation
+import CVips
 
 /// PURPOSE: Main static API entry point for Hokusai image processing.
 /// CONSTRAINTS:
@@ -25,6 +26,21 @@ public struct Hokusai {
         VipsBackend.shutdown()
     }
 
+    /// PURPOSE: Pay one-time lazy startup costs before the first real request.
+    /// INPUT: `fonts`: Pango font descriptions to resolve (fontconfig scan, glyph cache).
+    /// SIDE EFFECTS: Loads libvips modules and populates font caches process-wide.
+    /// AI HINTS: Intended for long-lived hosts such as `hokusai daemon`.
+    public static func warmUp(fonts: [String] = ["sans"]) throws {
+        for font in fonts {
+            var output: UnsafeMutablePointer<CVips.VipsImage>?
+            let result = swift_vips_text(&output, "Hokusai", font, 72, VIPS_ALIGN_LOW)
+            guard result == 0, let out = output else {
+                throw HokusaiError.vipsError(VipsBackend.getLastError())
+            }
+            g_object_unref(out)
+        }
+    }
+
     // MARK: - Image Loading
 
     /// PURPOSE: Asynchronously load an image from a filesystem path.
@@ -68,6 +84,24 @@ public struct Hokusai {
         return HokusaiImage(backend: .vips(vipsBackend))
     }
 
+    /// PURPOSE: Load a local file through a read-only memory mapping instead of reading it into `Data`.
+    /// INPUT: `path` must reference a regular, non-empty image file.
+    /// OUTPUT: `HokusaiImage` decoding straight from the mapped pages.
+    /// CONSTRAINTS:
+    /// - The mapping lives until libvips closes the image and every image derived from it.
+    /// - Do not truncate or rewrite the file while the image is alive (SIGBUS).
+    ///
+    /// Example:
+    /// ```swift
+    /// let image = try Hokusai.loadMapped(path: "/var/spool/uploads/raw.jpg")
+    /// let thumbnail = try image.resize(width: 320).toBuffer(options: SaveOptions(format: .webp))
+    /// ```
+    public static func loadMapped(path: String) throws -> HokusaiImage {
+        let file = try MappedFile(path: path)
+        let vipsBackend = try VipsBackend.loadFromBuffer(file.pointer, count: file.count, owner: file)
+        return HokusaiImage(backend: .vips(vipsBackend))
+    }
+
     // MARK: - Version Information
 
     /// PURPOSE: Return runtime libvips version string.
@@ -84,18 +84,21 @@ public final class HokusaiImage: @unchecked Sendable {
     /// AI HINTS:
     /// - Keep optional fields nil unless we can extract them reliably.
     public func metadata() throws -> ImageMetadata {
-        return ImageMetadata(
-            width: try width,
-            height: try height,
-            channels: try bands,
-            format: nil,  // TODO: Detect format
-            space: nil,   // TODO: Get color space
-            hasAlpha: try hasAlpha,
-            orientation: nil,  // TODO: Get EXIF orientation
-            density: nil,      // TODO: Get DPI
-            pages: nil,        // TODO: Get page count
-            size: nil
-        )
+        switch imageData {
+        case .vips(let backend):
+            return ImageMetadata(
+                width: try backend.getWidth(),
+                height: try backend.getHeight(),
+                channels: try backend.getBands(),
+                format: try backend.loaderFormat(),
+                space: try backend.interpretationName(),
+                hasAlpha: try backend.hasAlpha(),
+                orientation: try backend.intField("orientation"),
+                density: try backend.densityDPI(),
+                pages: try backend.intField("n-pages"),
+                size: nil
+            )
+        }
     }
 
     /// PURPOSE: Return extended libvips-derived metadata key/value map.
@@ -135,4 +138,15 @@ public final class HokusaiImage: @unchecked Sendable {
         let backend = try ensureVipsBackend()
         return try backend.getPointer()
     }
+
+    /// PURPOSE: Run the lazy pipeline now and hold the pixels in memory.
+    /// OUTPUT: New image whose later reads do not re-run upstream operations.
+    /// SIDE EFFECTS: Allocates the full decoded image.
+    func materialized() throws -> HokusaiImage {
+        let pointer = try getVipsPointer()
+        guard let out = swift_vips_image_copy_memory(pointer) else {
+            throw VipsBackend.evaluationError(HokusaiError.vipsError)
+        }
+        return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
+    }
 }
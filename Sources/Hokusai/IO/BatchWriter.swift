@@ -0,0 +1,333 @@
+import Foundation
+
+/// PURPOSE: Write encoded batch outputs in the background, grouped into batches.
+/// ALGORITHM:
+/// - `write` only enqueues; one writer thread drains up to `batchSize` files at a time.
+/// - io_uring: open temp files, queue every write in one submission, reap, then rename.
+/// - threads: write the batch concurrently with atomic `Data.write`.
+/// CONSTRAINTS:
+/// - Each output appears atomically (temp file + rename) or not at all.
+/// - Call `finish()` once after the last `write`; it reports the first failure.
+///   Later writes are not performed and are listed in `failedWrites`.
+/// - A writer released without `finish()` still flushes queued writes, then its
+///   thread exits (failures are then unreported).
+///
+/// Example:
+/// ```swift
+/// let writer = BatchWriter()
+/// for try await output in Hokusai.process(inputs, recipe: recipe) {
+///     if let data = output.data { writer.write(data, to: outputPath(output.index)) }
+/// }
+/// try await writer.finish()
+/// ```
+public final class BatchWriter: @unchecked Sendable {
+    /// PURPOSE: Backend in use after resolving `.automatic`
+    public let backend: IOBackend
+
+    private let core: BatchWriterCore
+
+    public init(backend: IOBackend = .automatic, batchSize: Int = 32) {
+        let wantsRing = backend != .threads && IORing.isAvailable
+        self.backend = wantsRing ? .ioUring : .threads
+        self.core = BatchWriterCore(backend: self.backend, batchSize: max(1, batchSize))
+
+        // PURPOSE: The thread holds only the core, so dropping the writer reaches `deinit`.
+        let thread = Thread { [core] in
+            core.run()
+        }
+        thread.name = "hokusai-writer"
+        thread.start()
+    }
+
+    deinit {
+        core.close()
+    }
+
+    /// PURPOSE: Files written successfully so far
+    public var writtenCount: Int {
+        return core.writtenCount
+    }
+
+    /// PURPOSE: Outputs that could not be written, with the reason
+    public var failedWrites: [(path: String, error: Error)] {
+        return core.failedWrites
+    }
+
+    /// PURPOSE: Enqueue `data` for `path`; parent directories are created as needed.
+    public func write(_ data: Data, to path: String) {
+        core.write(data, to: path)
+    }
+
+    /// PURPOSE: Flush every queued write, then stop the writer thread.
+    /// OUTPUT: Throws `HokusaiError.saveFailed` naming the first failed path.
+    public func finish() async throws {
+        try await core.finish()
+    }
+}
+
+/// PURPOSE: Queue and writer-thread state behind `BatchWriter`.
+/// CONSTRAINTS: Mutable state is guarded by `lock`; the thread exits once closed and drained.
+private final class BatchWriterCore: @unchecked Sendable {
+    private struct Job {
+        let data: Data
+        let path: String
+
+        /// PURPOSE: Enqueue order; keeps temp files apart when a path is written twice
+        let sequence: Int
+    }
+
+    let backend: IOBackend
+    private let batchSize: Int
+    private let lock = NSLock()
+    private let available = DispatchSemaphore(value: 0)
+    private var queue: [Job] = []
+    private var isClosed = false
+    private var isDrained = false
+    private var failures: [(path: String, error: Error)] = []
+    private var waiters: [CheckedContinuation<Void, Never>] = []
+    private var written = 0
+    private var nextSequence = 0
+
+    init(backend: IOBackend, batchSize: Int) {
+        self.backend = backend
+        self.batchSize = batchSize
+    }
+
+    var writtenCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return written
+    }
+
+    var failedWrites: [(path: String, error: Error)] {
+        lock.lock()
+        defer { lock.unlock() }
+        return failures
+    }
+
+    func write(_ data: Data, to path: String) {
+        lock.lock()
+        guard !isClosed else {
+            failures.append((path, HokusaiError.invalidOperation("BatchWriter.write called after finish()")))
+            lock.unlock()
+            return
+        }
+        queue.append(Job(data: data, path: path, sequence: nextSequence))
+        nextSequence += 1
+        lock.unlock()
+        available.signal()
+    }
+
+    func finish() async throws {
+        await withCheckedContinuation { (continuation: CheckedContinuation<Void, Never>) in
+            lock.lock()
+            isClosed = true
+            if isDrained {
+                lock.unlock()
+                continuation.resume()
+                return
+            }
+            waiters.append(continuation)
+            lock.unlock()
+            available.signal()
+        }
+
+        lock.lock()
+        let failures = self.failures
+        lock.unlock()
+        if let first = failures.first {
+            throw HokusaiError.saveFailed("\(failures.count) outputs failed; first \(first.path): \(first.error)")
+        }
+    }
+
+    /// PURPOSE: Stop accepting writes and wake the thread so it drains and exits.
+    func close() {
+        lock.lock()
+        isClosed = true
+        lock.unlock()
+        available.signal()
+    }
+
+    /// PURPOSE: Writer thread body; returns once closed and drained.
+    func run() {
+        let ring = backend == .ioUring ? IORing(entries: batchSize) : nil
+
+        while true {
+            available.wait()
+
+            lock.lock()
+            let batch = Array(queue.prefix(batchSize))
+            queue.removeFirst(batch.count)
+            let done = isClosed && queue.isEmpty && batch.isEmpty
+            lock.unlock()
+
+            if done { break }
+            guard !batch.isEmpty else { continue }
+
+            let results = ring.map { writeBatch(batch, ring: $0) } ?? writeBatchWithThreads(batch)
+
+            lock.lock()
+            for (job, error) in zip(batch, results) {
+                if let error {
+                    failures.append((job.path, error))
+                } else {
+                    written += 1
+                }
+            }
+            // PURPOSE: Jobs left over beyond this batch need another wake-up.
+            if !queue.isEmpty || isClosed {
+                available.signal()
+            }
+            lock.unlock()
+        }
+
+        lock.lock()
+        isDrained = true
+        let waiters = self.waiters
+        self.waiters.removeAll()
+        lock.unlock()
+        waiters.forEach { $0.resume() }
+    }
+
+    // MARK: - Private Helpers
+
+    private func writeBatchWithThreads(_ batch: [Job]) -> [Error?] {
+        let results = ResultSlots(count: batch.count)
+        // PURPOSE: Concurrent writes finish in any order, so only the last write of a
+        // repeated path runs; the earlier ones would be replaced anyway.
+        let latest = Dictionary(batch.indices.map { (batch[$0].path, $0) }, uniquingKeysWith: { _, last in last })
+        DispatchQueue.concurrentPerform(iterations: batch.count) { index in
+            let job = batch[index]
+            guard latest[job.path] == index else { return }
+            do {
+                try Self.createParent(of: job.path)
+                try job.data.write(to: URL(fileURLWithPath: job.path), options: .atomic)
+            } catch {
+                results.set(index, error)
+            }
+        }
+        return results.values
+    }
+
+    private func writeBatch(_ batch: [Job], ring: IORing) -> [Error?] {
+        var results = [Error?](repeating: nil, count: batch.count)
+        var descriptors = [Int32](repeating: -1, count: batch.count)
+        let temporaryPaths = batch.map { "\($0.path).hokusai-\(getpid())-\($0.sequence).tmp" }
+
+        for (index, job) in batch.enumerated() {
+            do {
+                try Self.createParent(of: job.path)
+            } catch {
+                results[index] = error
+                continue
+            }
+            let descriptor = open(temporaryPaths[index], O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0o644)
+            if descriptor < 0 {
+                results[index] = HokusaiError.saveFailed("open \(temporaryPaths[index]): \(String(cString: strerror(errno)))")
+            }
+            descriptors[index] = descriptor
+        }
+
+        Self.withPinnedBytes(batch.map(\.data)[...]) { buffers in
+            var pending = 0
+            for (index, buffer) in buffers.enumerated() where descriptors[index] >= 0 && buffer.count > 0 {
+                guard let base = buffer.baseAddress,
+                      ring.prepareWrite(descriptor: descriptors[index], from: base, count: buffer.count, offset: 0, tag: UInt64(index)) else {
+                    results[index] = Self.writeSynchronously(descriptors[index], buffer, from: 0)
+                    continue
+                }
+                pending += 1
+            }
+
+            while pending > 0 {
+                do {
+                    try ring.submit(waitFor: 1)
+                } catch {
+                    // PURPOSE: Ring failed mid-batch; a plain rewrite from offset 0 is always safe.
+                    for (index, buffer) in buffers.enumerated() where descriptors[index] >= 0 && results[index] == nil {
+                        results[index] = Self.writeSynchronously(descriptors[index], buffer, from: 0)
+                    }
+                    return
+                }
+
+                while let completion = ring.nextCompletion() {
+                    pending -= 1
+                    let index = Int(completion.tag)
+                    if completion.result < 0 {
+                        results[index] = HokusaiError.saveFailed("write \(batch[index].path): \(String(cString: strerror(-completion.result)))")
+                    } else if Int(completion.result) < buffers[index].count {
+                        results[index] = Self.writeSynchronously(descriptors[index], buffers[index], from: Int(completion.result))
+                    }
+                }
+            }
+        }
+
+        for (index, descriptor) in descriptors.enumerated() where descriptor >= 0 {
+            close(descriptor)
+            if results[index] == nil, rename(temporaryPaths[index], batch[index].path) != 0 {
+                results[index] = HokusaiError.saveFailed("rename \(batch[index].path): \(String(cString: strerror(errno)))")
+            }
+            if results[index] != nil {
+                unlink(temporaryPaths[index])
+            }
+        }
+        return results
+    }
+
+    /// PURPOSE: Keep every `Data` in the batch pinned while the kernel reads from it.
+    private static func withPinnedBytes(
+        _ items: ArraySlice<Data>,
+        pinned: [UnsafeRawBufferPointer] = [],
+        _ body: ([UnsafeRawBufferPointer]) -> Void
+    ) {
+        guard let first = items.first else {
+            body(pinned)
+            return
+        }
+        first.withUnsafeBytes { bytes in
+            withPinnedBytes(items.dropFirst(), pinned: pinned + [bytes], body)
+        }
+    }
+
+    private static func writeSynchronously(_ descriptor: Int32, _ buffer: UnsafeRawBufferPointer, from start: Int) -> Error? {
+        guard let base = buffer.baseAddress else { return nil }
+        var offset = start
+        while offset < buffer.count {
+            let sent = pwrite(descriptor, base + offset, buffer.count - offset, off_t(offset))
+            if sent < 0 {
+                if errno == EINTR { continue }
+                return HokusaiError.saveFailed("write: \(String(cString: strerror(errno)))")
+            }
+            offset += sent
+        }
+        return nil
+    }
+
+    private static func createParent(of path: String) throws {
+        let directory = (path as NSString).deletingLastPathComponent
+        guard !directory.isEmpty else { return }
+        try FileManager.default.createDirectory(atPath: directory, withIntermediateDirectories: true)
+    }
+}
+
+/// PURPOSE: Lock-guarded per-index error slots filled from concurrent workers.
+private final class ResultSlots: @unchecked Sendable {
+    private let lock = NSLock()
+    private var slots: [Error?]
+
+    init(count: Int) {
+        slots = Array(repeating: nil, count: count)
+    }
+
+    func set(_ index: Int, _ error: Error) {
+        lock.lock()
+        slots[index] = error
+        lock.unlock()
+    }
+
+    var values: [Error?] {
+        lock.lock()
+        defer { lock.unlock() }
+        return slots
+    }
+}
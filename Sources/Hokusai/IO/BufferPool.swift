@@ -0,0 +1,91 @@
+import Foundation
+
+/// PURPOSE: Reusable page-aligned byte buffers in power-of-two size classes.
+/// CONSTRAINTS:
+/// - Thread-safe; buffers return to the pool when their `PooledBuffer` is released.
+/// - Retains at most `maxRetainedBytes` of idle buffers; larger classes are never pooled.
+/// AI HINTS:
+/// - Pair with `VipsBackend.loadFromBuffer(_:count:owner:)` so libvips decodes
+///   straight out of the pooled bytes and releases them on image close.
+final class BufferPool: @unchecked Sendable {
+    static let shared = BufferPool(maxRetainedBytes: 256 * 1024 * 1024)
+
+    /// PURPOSE: Smallest size class; outputs below it are copied out rather than handed off
+    static let minimumClass = 64 * 1024
+    private static let maximumPooledClass = 64 * 1024 * 1024
+    private static let alignment = 4096
+
+    private let maxRetainedBytes: Int
+    private let lock = NSLock()
+    private var idle: [Int: [UnsafeMutableRawPointer]] = [:]
+    private var retainedBytes = 0
+
+    init(maxRetainedBytes: Int) {
+        self.maxRetainedBytes = maxRetainedBytes
+    }
+
+    deinit {
+        for (_, pointers) in idle {
+            pointers.forEach { $0.deallocate() }
+        }
+    }
+
+    /// PURPOSE: Buffer with at least `capacity` bytes; `count` starts at 0.
+    func acquire(capacity: Int) -> PooledBuffer {
+        let size = Self.sizeClass(for: capacity)
+
+        lock.lock()
+        let reused = idle[size]?.popLast()
+        if reused != nil {
+            retainedBytes -= size
+        }
+        lock.unlock()
+
+        let pointer = reused ?? UnsafeMutableRawPointer.allocate(byteCount: size, alignment: Self.alignment)
+        return PooledBuffer(pointer: pointer, capacity: size, pool: self)
+    }
+
+    fileprivate func recycle(_ pointer: UnsafeMutableRawPointer, capacity: Int) {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard capacity <= Self.maximumPooledClass, retainedBytes + capacity <= maxRetainedBytes else {
+            pointer.deallocate()
+            return
+        }
+        idle[capacity, default: []].append(pointer)
+        retainedBytes += capacity
+    }
+
+    private static func sizeClass(for capacity: Int) -> Int {
+        guard capacity > minimumClass else { return minimumClass }
+        guard capacity <= maximumPooledClass else {
+            return (capacity + alignment - 1) / alignment * alignment
+        }
+        var size = minimumClass
+        while size < capacity { size <<= 1 }
+        return size
+    }
+}
+
+/// PURPOSE: Owned view of a pooled allocation; returns it to the pool on deinit.
+/// CONSTRAINTS: Written by one reader, then treated as immutable while images reference it.
+final class PooledBuffer: @unchecked Sendable {
+    let pointer: UnsafeMutableRawPointer
+    let capacity: Int
+
+    /// PURPOSE: Valid bytes from `pointer`
+    var count: Int = 0
+
+    private let pool: BufferPool
+
+    fileprivate init(pointer: UnsafeMutableRawPointer, capacity: Int, pool: BufferPool) {
+        self.pointer = pointer
+        self.capacity = capacity
+        self.pool = pool
+    }
+
+    deinit {
+        pool.recycle(pointer, capacity: capacity)
+    }
+}
@@ -0,0 +1,111 @@
+import Foundation
+
+/// PURPOSE: Destination for bytes a libvips custom target receives from an encoder.
+protocol EncodeTarget: AnyObject {
+    /// PURPOSE: Consume `count` bytes; return the count consumed or -1 to abort the save.
+    func append(_ bytes: UnsafeRawPointer, count: Int) -> Int
+}
+
+/// PURPOSE: Encoder output accumulated in pooled buffers instead of libvips' `g_malloc` buffer.
+/// ALGORITHM:
+/// - Start at the recent output size for the format, so most encodes never grow.
+/// - On overflow, move to the next size class (at least double) and recycle the old buffer.
+/// - `finish()` wraps the bytes as `Data` whose deallocator returns them to the pool.
+/// CONSTRAINTS: Driven by one encoder at a time; not thread-safe.
+final class EncodeSink: EncodeTarget {
+    private let format: ImageFormat
+    private let pool: BufferPool
+    let digest: StreamingDigest?
+    private(set) var buffer: PooledBuffer
+
+    init(format: ImageFormat, hashing algorithms: HashAlgorithms = [], pool: BufferPool = .shared) {
+        self.format = format
+        self.pool = pool
+        self.digest = algorithms.isEmpty ? nil : StreamingDigest(algorithms)
+        self.buffer = pool.acquire(capacity: OutputSizeHint.shared.expectedBytes(for: format))
+    }
+
+    /// PURPOSE: Copy encoder bytes in; returns the count consumed (always all of them).
+    func append(_ bytes: UnsafeRawPointer, count: Int) -> Int {
+        let needed = buffer.count + count
+        if needed > buffer.capacity {
+            let grown = pool.acquire(capacity: max(needed, buffer.capacity * 2))
+            grown.pointer.copyMemory(from: buffer.pointer, byteCount: buffer.count)
+            grown.count = buffer.count
+            buffer = grown
+        }
+        (buffer.pointer + buffer.count).copyMemory(from: bytes, byteCount: count)
+        buffer.count = needed
+        digest?.update(bytes, count: count)
+        return count
+    }
+
+    /// PURPOSE: Hand the bytes out without copying; the pool gets them back when `Data` is freed.
+    /// CONSTRAINTS: Outputs smaller than the minimum size class are copied instead, so a
+    /// small `Data` never pins a whole pooled buffer.
+    func finish() -> Data {
+        let buffer = self.buffer
+        OutputSizeHint.shared.record(buffer.count, for: format)
+        if buffer.count < BufferPool.minimumClass {
+            return Data(bytes: buffer.pointer, count: buffer.count)
+        }
+        return Data(bytesNoCopy: buffer.pointer, count: buffer.count, deallocator: .custom { _, _ in
+            withExtendedLifetime(buffer) {}
+        })
+    }
+}
+
+/// PURPOSE: Stream encoder output straight to a file descriptor, hashing on the way.
+/// CONSTRAINTS: The descriptor is owned by the caller; short writes are retried.
+final class FileEncodeSink: EncodeTarget {
+    private let descriptor: Int32
+    let digest: StreamingDigest
+    private(set) var failure: Int32 = 0
+
+    init(descriptor: Int32, hashing algorithms: HashAlgorithms) {
+        self.descriptor = descriptor
+        self.digest = StreamingDigest(algorithms)
+    }
+
+    func append(_ bytes: UnsafeRawPointer, count: Int) -> Int {
+        var offset = 0
+        while offset < count {
+            let sent = write(descriptor, bytes + offset, count - offset)
+            if sent < 0 {
+                if errno == EINTR { continue }
+                failure = errno
+                return -1
+            }
+            offset += sent
+        }
+        digest.update(bytes, count: count)
+        return count
+    }
+}
+
+/// PURPOSE: Exponentially weighted recent output size per format.
+/// CONSTRAINTS: Thread-safe; shared by every encoder in the process.
+final class OutputSizeHint: @unchecked Sendable {
+    static let shared = OutputSizeHint()
+
+    private static let initialBytes = 64 * 1024
+    private static let weight = 0.2
+
+    private let lock = NSLock()
+    private var averages: [ImageFormat: Double] = [:]
+
+    /// PURPOSE: Capacity to start with; 25% headroom over the running average.
+    func expectedBytes(for format: ImageFormat) -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        guard let average = averages[format] else { return Self.initialBytes }
+        return max(Self.initialBytes, Int(average * 1.25))
+    }
+
+    func record(_ bytes: Int, for format: ImageFormat) {
+        lock.lock()
+        defer { lock.unlock() }
+        let previous = averages[format] ?? Double(bytes)
+        averages[format] = previous + Self.weight * (Double(bytes) - previous)
+    }
+}
@@ -0,0 +1,101 @@
+import Foundation
+import CHokusaiIO
+
+/// PURPOSE: Swift owner for a `hk_io_ring` submission/completion queue pair.
+/// CONSTRAINTS:
+/// - Not thread-safe; a ring may be handed to one driving thread and used only there.
+/// - Buffers passed to `prepare*` must stay valid until their completion is reaped.
+final class IORing: @unchecked Sendable {
+    private let ring: OpaquePointer
+
+    /// PURPOSE: Probe once per process whether io_uring can be used (kernel, seccomp, containers).
+    static let isAvailable: Bool = {
+        guard let probe = hk_io_ring_create(2) else { return false }
+        hk_io_ring_destroy(probe)
+        return true
+    }()
+
+    init?(entries: Int) {
+        guard let ring = hk_io_ring_create(UInt32(max(2, entries))) else {
+            return nil
+        }
+        self.ring = ring
+    }
+
+    deinit {
+        hk_io_ring_destroy(ring)
+    }
+
+    /// PURPOSE: Queue a read; false when the submission queue is full.
+    func prepareRead(descriptor: Int32, into buffer: UnsafeMutableRawPointer, count: Int, offset: Int, tag: UInt64) -> Bool {
+        return hk_io_ring_prep_read(ring, descriptor, buffer, UInt32(count), UInt64(offset), tag) == 0
+    }
+
+    /// PURPOSE: Queue a write; false when the submission queue is full.
+    func prepareWrite(descriptor: Int32, from buffer: UnsafeRawPointer, count: Int, offset: Int, tag: UInt64) -> Bool {
+        return hk_io_ring_prep_write(ring, descriptor, buffer, UInt32(count), UInt64(offset), tag) == 0
+    }
+
+    /// PURPOSE: Submit everything queued and block until `waitFor` completions are ready.
+    func submit(waitFor: Int) throws {
+        let result = hk_io_ring_submit(ring, UInt32(waitFor))
+        guard result >= 0 else {
+            throw HokusaiError.invalidOperation("io_uring_enter failed: \(String(cString: strerror(-result)))")
+        }
+    }
+
+    /// PURPOSE: Next completion, if any; `result` is bytes transferred or `-errno`.
+    func nextCompletion() -> (tag: UInt64, result: Int32)? {
+        var tag: UInt64 = 0
+        var result: Int32 = 0
+        guard hk_io_ring_peek(ring, &tag, &result) == 1 else {
+            return nil
+        }
+        return (tag, result)
+    }
+}
+
+/// PURPOSE: Blocking file helpers shared by the io_uring and thread backends.
+enum FileIO {
+    /// PURPOSE: Open for reading and return the descriptor with the file size.
+    static func openForReading(_ path: String) throws -> (descriptor: Int32, size: Int) {
+        let descriptor = open(path, O_RDONLY | O_CLOEXEC)
+        guard descriptor >= 0 else {
+            if errno == ENOENT {
+                throw HokusaiError.fileNotFound(path)
+            }
+            throw HokusaiError.loadFailed("open \(path): \(String(cString: strerror(errno)))")
+        }
+
+        var info = stat()
+        guard fstat(descriptor, &info) == 0 else {
+            let message = String(cString: strerror(errno))
+            close(descriptor)
+            throw HokusaiError.loadFailed("stat \(path): \(message)")
+        }
+        return (descriptor, Int(info.st_size))
+    }
+
+    /// PURPOSE: `pread` until `buffer` holds `size` bytes or EOF; continues from `buffer.count`.
+    static func readFully(_ descriptor: Int32, into buffer: PooledBuffer, size: Int, path: String) throws {
+        while buffer.count < size {
+            let received = pread(descriptor, buffer.pointer + buffer.count, size - buffer.count, off_t(buffer.count))
+            if received == 0 { break }
+            if received < 0 {
+                if errno == EINTR { continue }
+                throw HokusaiError.loadFailed("read \(path): \(String(cString: strerror(errno)))")
+            }
+            buffer.count += received
+        }
+    }
+
+    /// PURPOSE: Read a whole file into a pooled buffer with blocking I/O.
+    static func readFile(_ path: String, pool: BufferPool) throws -> PooledBuffer {
+        let (descriptor, size) = try openForReading(path)
+        defer { close(descriptor) }
+
+        let buffer = pool.acquire(capacity: size)
+        try readFully(descriptor, into: buffer, size: size, path: path)
+        return buffer
+    }
+}
@@ -0,0 +1,35 @@
+import Foundation
+
+/// PURPOSE: Read-only private mapping of a whole file, unmapped on deinit.
+/// CONSTRAINTS:
+/// - Pages are faulted in lazily; peak resident memory is what the decoder touches.
+/// - Truncating the file while mapped raises SIGBUS on access; map only files
+///   this process controls (uploads, spool directories).
+final class MappedFile: @unchecked Sendable {
+    let pointer: UnsafeRawPointer
+    let count: Int
+
+    init(path: String) throws {
+        let (descriptor, size) = try FileIO.openForReading(path)
+        defer { close(descriptor) }
+
+        guard size > 0 else {
+            throw HokusaiError.invalidImageData
+        }
+
+        let mapping = mmap(nil, size, PROT_READ, MAP_PRIVATE, descriptor, 0)
+        guard let mapping, mapping != UnsafeMutableRawPointer(bitPattern: -1) else {
+            throw HokusaiError.loadFailed("mmap \(path): \(String(cString: strerror(errno)))")
+        }
+
+        // PURPOSE: Decoders scan front to back; ask for aggressive read-ahead and early reclaim.
+        _ = madvise(mapping, size, MADV_SEQUENTIAL)
+
+        self.pointer = UnsafeRawPointer(mapping)
+        self.count = size
+    }
+
+    deinit {
+        munmap(UnsafeMutableRawPointer(mutating: pointer), count)
+    }
+}
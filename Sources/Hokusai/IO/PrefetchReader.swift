@@ -0,0 +1,220 @@
+import Foundation
+
+/// PURPOSE: Read file inputs into pooled buffers ahead of the decoders.
+/// ALGORITHM:
+/// - io_uring: one thread keeps up to `depth` reads in flight on a single ring,
+///   re-queuing short reads and falling back to `pread` if the ring errors.
+/// - threads: up to `depth` (max 16) threads each `pread` whole files.
+/// - A permit is taken per file started and returned by `release()` when the
+///   consumer takes an item, so at most `depth` buffers wait unconsumed.
+/// CONSTRAINTS: Items arrive in completion order; `Item.index` maps back to `paths`.
+final class PrefetchReader: @unchecked Sendable {
+    struct Item: Sendable {
+        let index: Int
+        let result: Result<PooledBuffer, Error>
+    }
+
+    private let paths: [String]
+    private let depth: Int
+    private let backend: IOBackend
+    private let pool: BufferPool
+    private let permits: DispatchSemaphore
+    private let lock = NSLock()
+    private var nextIndex = 0
+    private var runningThreads = 0
+    private var isCancelled = false
+
+    init(paths: [String], options: PrefetchOptions, pool: BufferPool = .shared) {
+        self.paths = paths
+        self.depth = max(1, options.depth)
+        self.pool = pool
+        self.permits = DispatchSemaphore(value: max(1, options.depth))
+
+        switch options.backend {
+        case .automatic:
+            self.backend = IORing.isAvailable ? .ioUring : .threads
+        case .ioUring, .threads:
+            self.backend = options.backend
+        }
+    }
+
+    /// PURPOSE: Backend actually in use after resolving `.automatic` and probing the kernel.
+    var activeBackend: IOBackend {
+        return backend == .ioUring && IORing.isAvailable ? .ioUring : .threads
+    }
+
+    /// PURPOSE: Begin reading; the stream finishes after every path has produced an item.
+    func start() -> AsyncStream<Item> {
+        let (stream, continuation) = AsyncStream<Item>.makeStream()
+        guard !paths.isEmpty else {
+            continuation.finish()
+            return stream
+        }
+
+        if activeBackend == .ioUring, let ring = IORing(entries: depth) {
+            let thread = Thread { [self] in
+                runRing(ring, continuation: continuation)
+            }
+            thread.name = "hokusai-prefetch"
+            thread.start()
+            return stream
+        }
+
+        let threads = min(depth, 16, paths.count)
+        runningThreads = threads
+        for index in 0..<threads {
+            let thread = Thread { [self] in
+                runThread(continuation: continuation)
+            }
+            thread.name = "hokusai-prefetch-\(index)"
+            thread.start()
+        }
+        return stream
+    }
+
+    /// PURPOSE: Consumer took an item; allow another read to start.
+    func release() {
+        permits.signal()
+    }
+
+    /// PURPOSE: Stop starting new reads and wake threads parked on permits.
+    func cancel() {
+        lock.lock()
+        isCancelled = true
+        lock.unlock()
+        for _ in 0..<16 {
+            permits.signal()
+        }
+    }
+
+    // MARK: - Private Helpers
+
+    private var cancelled: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return isCancelled
+    }
+
+    private func claimNext() -> Int? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard !isCancelled, nextIndex < paths.count else { return nil }
+        defer { nextIndex += 1 }
+        return nextIndex
+    }
+
+    private func runThread(continuation: AsyncStream<Item>.Continuation) {
+        while let index = claimNext() {
+            permits.wait()
+            if cancelled { break }
+            let result = Result { try FileIO.readFile(paths[index], pool: pool) }
+            continuation.yield(Item(index: index, result: result))
+        }
+
+        lock.lock()
+        runningThreads -= 1
+        let isLast = runningThreads == 0
+        lock.unlock()
+        if isLast {
+            continuation.finish()
+        }
+    }
+
+    private struct Slot {
+        let index: Int
+        let descriptor: Int32
+        let buffer: PooledBuffer
+        let size: Int
+    }
+
+    private func runRing(_ initialRing: IORing, continuation: AsyncStream<Item>.Continuation) {
+        var ring: IORing? = initialRing
+        var slots: [UInt64: Slot] = [:]
+
+        func finish(_ slot: Slot, _ result: Result<PooledBuffer, Error>) {
+            close(slot.descriptor)
+            continuation.yield(Item(index: slot.index, result: result))
+        }
+
+        func completeSynchronously(_ slot: Slot) {
+            finish(slot, Result {
+                try FileIO.readFully(slot.descriptor, into: slot.buffer, size: slot.size, path: paths[slot.index])
+                return slot.buffer
+            })
+        }
+
+        while true {
+            // PURPOSE: Start reads while permits allow; block for a permit only when nothing is in flight.
+            while nextIndex < paths.count, !cancelled {
+                let timeout: DispatchTime = slots.isEmpty ? .distantFuture : .now()
+                guard permits.wait(timeout: timeout) == .success, !cancelled else { break }
+
+                let index = nextIndex
+                nextIndex += 1
+                let path = paths[index]
+                do {
+                    let (descriptor, size) = try FileIO.openForReading(path)
+                    let slot = Slot(index: index, descriptor: descriptor, buffer: pool.acquire(capacity: size), size: size)
+                    let queued = size > 0 && size <= Int(UInt32.max) && ring?.prepareRead(
+                        descriptor: descriptor,
+                        into: slot.buffer.pointer,
+                        count: size,
+                        offset: 0,
+                        tag: UInt64(index)
+                    ) == true
+
+                    if queued {
+                        slots[UInt64(index)] = slot
+                    } else {
+                        completeSynchronously(slot)
+                    }
+                } catch {
+                    continuation.yield(Item(index: index, result: .failure(error)))
+                }
+            }
+
+            guard let activeRing = ring, !slots.isEmpty else {
+                if nextIndex >= paths.count || cancelled { break }
+                continue
+            }
+
+            do {
+                try activeRing.submit(waitFor: 1)
+            } catch {
+                // PURPOSE: Ring is unusable (e.g. seccomp); finish in-flight files and continue with pread.
+                ring = nil
+                slots.values.forEach(completeSynchronously)
+                slots.removeAll()
+                continue
+            }
+
+            while let completion = activeRing.nextCompletion() {
+                guard let slot = slots.removeValue(forKey: completion.tag) else { continue }
+
+                if completion.result < 0 {
+                    let message = String(cString: strerror(-completion.result))
+                    finish(slot, .failure(HokusaiError.loadFailed("read \(paths[slot.index]): \(message)")))
+                    continue
+                }
+
+                slot.buffer.count += Int(completion.result)
+                let remaining = slot.size - slot.buffer.count
+                if completion.result == 0 || remaining <= 0 {
+                    finish(slot, .success(slot.buffer))
+                } else if activeRing.prepareRead(
+                    descriptor: slot.descriptor,
+                    into: slot.buffer.pointer + slot.buffer.count,
+                    count: remaining,
+                    offset: slot.buffer.count,
+                    tag: completion.tag
+                ) {
+                    slots[completion.tag] = slot
+                } else {
+                    completeSynchronously(slot)
+                }
+            }
+        }
+
+        continuation.finish()
+    }
+}
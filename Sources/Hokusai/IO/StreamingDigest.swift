@@ -0,0 +1,54 @@
+import Foundation
+import CHokusaiIO
+
+/// PURPOSE: Feed encoder chunks into the requested hashers as they are produced.
+/// CONSTRAINTS: One writer at a time; call `finish()` once.
+final class StreamingDigest {
+    private let algorithms: HashAlgorithms
+    private var sha = hk_sha256()
+    private var xxh = hk_xxh64()
+    private var byteCount = 0
+
+    init(_ algorithms: HashAlgorithms) {
+        self.algorithms = algorithms
+        hk_sha256_init(&sha)
+        hk_xxh64_init(&xxh, 0)
+    }
+
+    func update(_ bytes: UnsafeRawPointer, count: Int) {
+        byteCount += count
+        if algorithms.contains(.sha256) {
+            hk_sha256_update(&sha, bytes, count)
+        }
+        if algorithms.contains(.xxHash64) {
+            hk_xxh64_update(&xxh, bytes, count)
+        }
+    }
+
+    func finish() -> OutputDigest {
+        var sha256: String?
+        if algorithms.contains(.sha256) {
+            var digest = [UInt8](repeating: 0, count: 32)
+            hk_sha256_final(&sha, &digest)
+            sha256 = digest.map { String(format: "%02x", $0) }.joined()
+        }
+
+        var xxHash64: String?
+        if algorithms.contains(.xxHash64) {
+            let value = String(hk_xxh64_digest(&xxh), radix: 16)
+            xxHash64 = String(repeating: "0", count: 16 - value.count) + value
+        }
+        return OutputDigest(sha256: sha256, xxHash64: xxHash64, byteCount: byteCount)
+    }
+
+    /// PURPOSE: One-pass digest of bytes that were not produced through a hashing target.
+    static func digest(of data: Data, algorithms: HashAlgorithms) -> OutputDigest {
+        let digest = StreamingDigest(algorithms)
+        data.withUnsafeBytes { bytes in
+            if let base = bytes.baseAddress {
+                digest.update(base, count: bytes.count)
+            }
+        }
+        return digest.finish()
+    }
+}
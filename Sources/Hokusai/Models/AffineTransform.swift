@@ -0,0 +1,122 @@
+import Foundation
+
+/// PURPOSE: 2-D affine map in image coordinates (y down):
+/// `x' = a·x + b·y + tx`, `y' = c·x + d·y + ty`.
+/// ALGORITHM: Transforms compose with `then`, so scale/rotate/translate chains
+/// collapse into one matrix and one resample.
+///
+/// Example:
+/// ```swift
+/// let t = AffineTransform.rotation(degrees: 12).then(.scale(0.5))
+/// let out = try image.transform(affine: t)
+/// ```
+public struct AffineTransform: Sendable, Equatable {
+    public var a: Double
+    public var b: Double
+    public var c: Double
+    public var d: Double
+    public var tx: Double
+    public var ty: Double
+
+    public init(a: Double = 1, b: Double = 0, c: Double = 0, d: Double = 1, tx: Double = 0, ty: Double = 0) {
+        self.a = a
+        self.b = b
+        self.c = c
+        self.d = d
+        self.tx = tx
+        self.ty = ty
+    }
+
+    public static let identity = AffineTransform()
+
+    public static func scale(_ sx: Double, _ sy: Double? = nil) -> AffineTransform {
+        return AffineTransform(a: sx, d: sy ?? sx)
+    }
+
+    /// PURPOSE: Clockwise rotation about the origin, matching `rotate(angle:)`
+    public static func rotation(degrees: Double) -> AffineTransform {
+        let radians = degrees * .pi / 180
+        return AffineTransform(a: cos(radians), b: -sin(radians), c: sin(radians), d: cos(radians))
+    }
+
+    public static func translation(x: Double, y: Double) -> AffineTransform {
+        return AffineTransform(tx: x, ty: y)
+    }
+
+    /// PURPOSE: Apply `self`, then `next`.
+    public func then(_ next: AffineTransform) -> AffineTransform {
+        return AffineTransform(
+            a: next.a * a + next.b * c,
+            b: next.a * b + next.b * d,
+            c: next.c * a + next.d * c,
+            d: next.c * b + next.d * d,
+            tx: next.a * tx + next.b * ty + next.tx,
+            ty: next.c * tx + next.d * ty + next.ty
+        )
+    }
+
+    /// PURPOSE: Where `(x, y)` lands
+    public func apply(x: Double, y: Double) -> (x: Double, y: Double) {
+        return (a * x + b * y + tx, c * x + d * y + ty)
+    }
+
+    /// PURPOSE: Axis-aligned bounds of a `width` x `height` image after the transform.
+    func bounds(width: Int, height: Int) -> (minX: Double, minY: Double, maxX: Double, maxY: Double) {
+        let corners = [(0.0, 0.0), (Double(width), 0.0), (0.0, Double(height)), (Double(width), Double(height))]
+            .map { apply(x: $0.0, y: $0.1) }
+        return (
+            corners.map(\.x).min() ?? 0,
+            corners.map(\.y).min() ?? 0,
+            corners.map(\.x).max() ?? 0,
+            corners.map(\.y).max() ?? 0
+        )
+    }
+}
+
+/// PURPOSE: Resampler used by `transform(affine:)`; raw values are libvips interpolator names.
+public enum Interpolator: String, Codable, Sendable, CaseIterable {
+    case nearest
+    case bilinear
+    case bicubic
+    /// PURPOSE: Locally bounded bicubic; no halo on sharp edges
+    case lbb
+    /// PURPOSE: Edge-preserving, best for moderate enlargements
+    case nohalo
+    case vsqbs
+}
+
+/// PURPOSE: Rectangle of the transformed plane to render, in output coordinates.
+public struct OutputArea: Sendable, Equatable, Codable {
+    public var left: Int
+    public var top: Int
+    public var width: Int
+    public var height: Int
+
+    public init(left: Int, top: Int, width: Int, height: Int) {
+        self.left = left
+        self.top = top
+        self.width = width
+        self.height = height
+    }
+}
+
+// MARK: - Codable
+
+/// PURPOSE: Flat `{"a", "b", "c", "d", "tx", "ty"}`; omitted entries default to identity.
+extension AffineTransform: Codable {
+    private enum CodingKeys: String, CodingKey {
+        case a, b, c, d, tx, ty
+    }
+
+    public init(from decoder: Decoder) throws {
+        let container = try decoder.container(keyedBy: CodingKeys.self)
+        self.init(
+            a: try container.decodeIfPresent(Double.self, forKey: .a) ?? 1,
+            b: try container.decodeIfPresent(Double.self, forKey: .b) ?? 0,
+            c: try container.decodeIfPresent(Double.self, forKey: .c) ?? 0,
+            d: try container.decodeIfPresent(Double.self, forKey: .d) ?? 1,
+            tx: try container.decodeIfPresent(Double.self, forKey: .tx) ?? 0,
+            ty: try container.decodeIfPresent(Double.self, forKey: .ty) ?? 0
+        )
+    }
+}
@@ -0,0 +1,47 @@
+import Foundation
+
+/// PURPOSE: Encoder settings for `Hokusai.animate(frames:delays:loop:format:options:)`
+public struct AnimationOptions: Sendable {
+    /// PURPOSE: Quality (1-100, WebP)
+    public var quality: Int
+
+    /// PURPOSE: Lossless WebP frames
+    public var lossless: Bool
+
+    /// PURPOSE: Effort level (GIF 1-10, WebP 0-6)
+    public var effort: Int?
+
+    /// PURPOSE: WebP keyframe distance (`kmin...kmax`); nil keeps libwebp's choice
+    /// CONSTRAINTS: libwebp needs `kmin < kmax`; a single-value or negative range is rejected.
+    public var keyframeInterval: ClosedRange<Int>?
+
+    /// PURPOSE: Search WebP settings for the smallest output (slower)
+    public var minimizeSize: Bool
+
+    /// PURPOSE: GIF pixels within this error of the previous frame become transparent,
+    /// so each frame is stored as its changed area only (0 = identical pixels only)
+    public var frameDifferenceTolerance: Double
+
+    /// PURPOSE: Reuse the GIF's global palette for every frame, however far a frame's
+    /// colours drift from it (libvips 8.15+ `interpalette_maxerror` 255). false keeps
+    /// libvips' default threshold, so frames that differ noticeably get a local palette.
+    public var sharedPalette: Bool
+
+    public init(
+        quality: Int = 75,
+        lossless: Bool = false,
+        effort: Int? = nil,
+        keyframeInterval: ClosedRange<Int>? = nil,
+        minimizeSize: Bool = false,
+        frameDifferenceTolerance: Double = 0,
+        sharedPalette: Bool = true
+    ) {
+        self.quality = quality
+        self.lossless = lossless
+        self.effort = effort
+        self.keyframeInterval = keyframeInterval
+        self.minimizeSize = minimizeSize
+        self.frameDifferenceTolerance = frameDifferenceTolerance
+        self.sharedPalette = sharedPalette
+    }
+}
@@ -0,0 +1,113 @@
+import Foundation
+
+/// PURPOSE: Source of an image processed by batch APIs
+public enum ImageInput: Sendable {
+    /// PURPOSE: Image file on the local filesystem
+    case file(String)
+
+    /// PURPOSE: Encoded image bytes already in memory
+    case data(Data)
+}
+
+extension ImageInput {
+    /// PURPOSE: Open the input as a lazy libvips image (header only until pixels are needed).
+    func load() throws -> HokusaiImage {
+        switch self {
+        case .file(let path):
+            return try Hokusai.loadFromFile(path)
+        case .data(let data):
+            return try Hokusai.loadFromBuffer(data)
+        }
+    }
+
+    /// PURPOSE: Open the input with decoder shrink-on-load (JPEG/WebP only).
+    func load(format: ImageFormat, shrink: Int) throws -> HokusaiImage {
+        switch self {
+        case .file(let path):
+            return HokusaiImage(backend: .vips(try VipsBackend.loadFromFile(path, format: format, shrink: shrink)))
+        case .data(let data):
+            return HokusaiImage(backend: .vips(try VipsBackend.loadFromBuffer(data, format: format, shrink: shrink)))
+        }
+    }
+
+    /// PURPOSE: Decode a thumbnail fitting inside `width` x `height` into memory.
+    /// ALGORITHM: libvips thumbnail (shrink-on-load for JPEG/WebP/HEIF/PDF/SVG), then copy
+    /// to memory so the decoder and any borrowed bytes are released before returning.
+    func thumbnail(width: Int, height: Int) throws -> HokusaiImage {
+        switch self {
+        case .file(let path):
+            let backend = try VipsBackend.thumbnail(path: path, width: width, height: height)
+            return try HokusaiImage(backend: .vips(backend)).materialized()
+        case .data(let data):
+            // PURPOSE: The buffer thumbnail reads `data` lazily; render it while the bytes are pinned.
+            return try data.withUnsafeBytes { bytes in
+                let backend = try VipsBackend.thumbnail(bytes: bytes.baseAddress, count: bytes.count, width: width, height: height)
+                return try HokusaiImage(backend: .vips(backend)).materialized()
+            }
+        }
+    }
+
+    /// PURPOSE: Short label for maps and error messages.
+    var displayName: String {
+        switch self {
+        case .file(let path):
+            return ((path as NSString).lastPathComponent as NSString).deletingPathExtension
+        case .data:
+            return "data"
+        }
+    }
+}
+
+/// PURPOSE: Result of processing one batch input
+public struct BatchOutput: Sendable {
+    /// PURPOSE: Position of the input in the submitted sequence
+    public let index: Int
+
+    /// PURPOSE: The input this output belongs to
+    public let input: ImageInput
+
+    /// PURPOSE: Encoded bytes or the per-item error
+    public let result: Result<Data, Error>
+
+    public init(index: Int, input: ImageInput, result: Result<Data, Error>) {
+        self.index = index
+        self.input = input
+        self.result = result
+    }
+
+    /// PURPOSE: Encoded bytes when the item succeeded
+    public var data: Data? {
+        return try? result.get()
+    }
+}
+
+/// PURPOSE: File I/O strategy for batch prefetching and output writing
+public enum IOBackend: String, CaseIterable, Sendable {
+    /// PURPOSE: io_uring when the kernel supports it, otherwise threads
+    case automatic
+
+    /// PURPOSE: Linux io_uring (5.7+); unavailable elsewhere
+    case ioUring = "io-uring"
+
+    /// PURPOSE: Blocking reads/writes on a small thread pool
+    case threads
+
+    /// PURPOSE: Whether this process can create an io_uring instance
+    public static var isIOUringAvailable: Bool {
+        return IORing.isAvailable
+    }
+}
+
+/// PURPOSE: Read-ahead settings for file inputs in `Hokusai.process`
+public struct PrefetchOptions: Sendable {
+    /// PURPOSE: Files read ahead of the decoders (bounds prefetch memory)
+    public var depth: Int
+
+    /// PURPOSE: I/O strategy
+    public var backend: IOBackend
+
+    public init(depth: Int = 16, backend: IOBackend = .automatic) {
+        self.depth = depth
+        self.backend = backend
+    }
+}
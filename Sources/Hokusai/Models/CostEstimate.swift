@@ -0,0 +1,98 @@
+import Foundation
+
+/// PURPOSE: Predicted cost of one operation within a recipe
+public struct OperationCost: Sendable {
+    /// PURPOSE: Cost model key (e.g. `decode.jpeg`, `resize`, `encode.webp`)
+    public let operation: String
+
+    /// PURPOSE: Pixels the operation touches
+    public let pixels: Int
+
+    /// PURPOSE: Predicted wall time in milliseconds
+    public let estimatedMs: Double
+}
+
+/// PURPOSE: Pre-execution cost prediction used for scheduling and admission control
+public struct CostEstimate: Sendable {
+    /// PURPOSE: Pixels in the source image (first page)
+    public let inputPixels: Int
+
+    /// PURPOSE: Integer reduction applied by the decoder (1 = none)
+    public let decodeShrink: Int
+
+    /// PURPOSE: Pixels actually produced by the decoder
+    public let decodedPixels: Int
+
+    /// PURPOSE: Final output dimensions
+    public let outputWidth: Int
+    public let outputHeight: Int
+
+    /// PURPOSE: Per-operation breakdown in execution order
+    public let operations: [OperationCost]
+
+    /// PURPOSE: Predicted peak resident bytes while the job runs
+    public let peakMemoryBytes: Int
+
+    /// PURPOSE: Pixels in the encoded output
+    public var outputPixels: Int {
+        return outputWidth * outputHeight
+    }
+
+    /// PURPOSE: Sum of per-operation predictions
+    public var estimatedMs: Double {
+        return operations.reduce(0) { $0 + $1.estimatedMs }
+    }
+}
+
+/// PURPOSE: Per-operation pixel cost coefficients.
+/// CONSTRAINTS:
+/// - Keys follow `decode.<format>`, `encode.<format>`, or a step name
+///   (`resize`, `rotate`, `rotate90`, `flip`, `crop`, `autorotate`).
+/// - Defaults are rough single-core reference values; use `calibrated(fromBenchmarkSuite:)`
+///   to fit them to the current machine.
+public struct CostModel: Sendable {
+    /// PURPOSE: Nanoseconds per touched pixel, by operation key
+    public var nanosecondsPerPixel: [String: Double]
+
+    /// PURPOSE: Coefficient for keys missing from the table
+    public var fallbackNanosecondsPerPixel: Double
+
+    public init(nanosecondsPerPixel: [String: Double], fallbackNanosecondsPerPixel: Double = 10) {
+        self.nanosecondsPerPixel = nanosecondsPerPixel
+        self.fallbackNanosecondsPerPixel = fallbackNanosecondsPerPixel
+    }
+
+    /// PURPOSE: Uncalibrated reference coefficients
+    public static let `default` = CostModel(nanosecondsPerPixel: [
+        "decode.jpeg": 6,
+        "decode.png": 10,
+        "decode.webp": 12,
+        "decode.gif": 8,
+        "decode.tiff": 3,
+        "decode.heif": 30,
+        "decode.avif": 30,
+        "decode.pdf": 40,
+        "decode.svg": 40,
+        "resize": 4,
+        "sharpen": 8,
+        "rotate": 12,
+        "rotate90": 2,
+        "affine": 12,
+        "custom": 10,
+        "flip": 1,
+        "crop": 0.2,
+        "autorotate": 2,
+        "encode.jpeg": 5,
+        "encode.png": 20,
+        "encode.webp": 60,
+        "encode.gif": 40,
+        "encode.tiff": 3,
+        "encode.heif": 200,
+        "encode.avif": 250,
+    ])
+
+    /// PURPOSE: Coefficient for an operation key
+    public func coefficient(for operation: String) -> Double {
+        return nanosecondsPerPixel[operation] ?? fallbackNanosecondsPerPixel
+    }
+}
@@ -1,7 +1,7 @@
 import Foundation
 
 /// PURPOSE: How the image should be resized to fit the target dimensions
-public enum ResizeFit: Sendable {
+public enum ResizeFit: String, Codable, Sendable {
     /// PURPOSE: Preserving aspect ratio, resize to be as large as possible while ensuring dimensions are less than or equal to specified
     case inside
 
@@ -19,7 +19,7 @@ public enum ResizeFit: Sendable {
 }
 
 /// PURPOSE: Position for crop and cover operations
-public enum Position: Sendable {
+public enum Position: String, Codable, Sendable {
     case center
     case top
     case bottom
@@ -38,7 +38,7 @@ public enum Position: Sendable {
 }
 
 /// PURPOSE: Interpolation kernel for resize operations
-public enum Kernel: String, Sendable {
+public enum Kernel: String, Codable, Sendable {
     case nearest
     case linear
     case cubic
@@ -48,7 +48,7 @@ public enum Kernel: String, Sendable {
 }
 
 /// PURPOSE: Direction for flip operation
-public enum FlipDirection: Sendable {
+public enum FlipDirection: String, Codable, Sendable {
     case horizontal
     case vertical
     case both
@@ -70,3 +70,21 @@ public enum RotationAngle: Sendable {
         }
     }
 }
+
+/// PURPOSE: Encode rotation as plain degrees so recipe JSON stays readable
+extension RotationAngle: Codable {
+    public init(from decoder: Decoder) throws {
+        let degrees = try decoder.singleValueContainer().decode(Double.self)
+        switch degrees {
+        case 90: self = .degree90
+        case 180: self = .degree180
+        case 270: self = .degree270
+        default: self = .custom(degrees)
+        }
+    }
+
+    public func encode(to encoder: Encoder) throws {
+        var container = encoder.singleValueContainer()
+        try container.encode(degrees)
+    }
+}
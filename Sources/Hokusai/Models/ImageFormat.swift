@@ -1,7 +1,7 @@
 import Foundation
 
 /// PURPOSE: Supported image formats
-public enum ImageFormat: String, CaseIterable, Sendable {
+public enum ImageFormat: String, CaseIterable, Codable, Sendable {
     case jpeg = "jpeg"
     case png = "png"
     case webp = "webp"
@@ -0,0 +1,45 @@
+import Foundation
+
+/// PURPOSE: Digests to compute while encoder output is written
+public struct HashAlgorithms: OptionSet, Sendable {
+    public let rawValue: Int
+
+    public init(rawValue: Int) {
+        self.rawValue = rawValue
+    }
+
+    /// PURPOSE: SHA-256, for strong ETags and content addressing
+    public static let sha256 = HashAlgorithms(rawValue: 1 << 0)
+
+    /// PURPOSE: XXH64 (seed 0), for fast dedup keys
+    public static let xxHash64 = HashAlgorithms(rawValue: 1 << 1)
+}
+
+/// PURPOSE: Digests of one encoded output, as lowercase hex
+public struct OutputDigest: Sendable, Equatable {
+    /// PURPOSE: SHA-256 (64 hex digits) when requested
+    public let sha256: String?
+
+    /// PURPOSE: XXH64 (16 hex digits) when requested
+    public let xxHash64: String?
+
+    /// PURPOSE: Encoded size in bytes
+    public let byteCount: Int
+
+    public init(sha256: String?, xxHash64: String?, byteCount: Int) {
+        self.sha256 = sha256
+        self.xxHash64 = xxHash64
+        self.byteCount = byteCount
+    }
+
+    /// PURPOSE: Quoted strong ETag from the strongest available digest
+    public var etag: String? {
+        return (sha256 ?? xxHash64).map { "\"\($0)\"" }
+    }
+}
+
+/// PURPOSE: Encoded bytes together with their digests
+public struct EncodedOutput: Sendable {
+    public let data: Data
+    public let digest: OutputDigest
+}
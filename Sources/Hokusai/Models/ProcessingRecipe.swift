@@ -0,0 +1,201 @@
+import Foundation
+
+/// PURPOSE: Single transform step applied by a `ProcessingRecipe`
+public enum ProcessingStep: Sendable {
+    /// PURPOSE: Resize using the dimensions and fit carried by the options
+    case resize(ResizeOptions)
+
+    /// PURPOSE: Extract a fixed rectangle
+    case crop(CropOptions)
+
+    /// PURPOSE: Rotate by angle with optional background for arbitrary angles
+    case rotate(RotationAngle, background: [Double]? = nil)
+
+    /// PURPOSE: Mirror the image
+    case flip(FlipDirection)
+
+    /// PURPOSE: Apply EXIF orientation and clear it
+    case autoRotate
+
+    /// PURPOSE: Resample through an affine map (see `HokusaiImage.transform(affine:)`)
+    case affine(AffineTransform, interpolator: Interpolator = .bicubic, background: [Double]? = nil)
+
+    /// PURPOSE: Run a custom operation registered with `RegionOperation.register`
+    case custom(String)
+}
+
+/// PURPOSE: Declarative transform + encode description shared by batch APIs.
+/// CONSTRAINTS:
+/// - `output.format` must be set; batch outputs are always encoded to buffers.
+/// AI HINTS:
+/// - Keep steps value-typed so a recipe can be reused across tasks.
+public struct ProcessingRecipe: Codable, Sendable {
+    /// PURPOSE: Ordered transform steps
+    public var steps: [ProcessingStep]
+
+    /// PURPOSE: Encoder settings for the final output
+    public var output: SaveOptions
+
+    public init(steps: [ProcessingStep] = [], output: SaveOptions) {
+        self.steps = steps
+        self.output = output
+    }
+}
+
+extension ProcessingRecipe {
+    /// PURPOSE: Apply all transform steps in order.
+    /// ALGORITHM: Consecutive scale/rotate/affine steps are merged into a single
+    /// affine resample (see `AffineRun`); everything else runs step by step.
+    /// CONSTRAINTS: A default (lanczos3) resize inside a fused run is resampled with the
+    /// run's interpolator, bicubic unless an `.affine` step sets one. That is slightly
+    /// softer than lanczos3 but saves the intermediate passes; the run never reduces by
+    /// more than 2x, where bicubic would start to alias. A lone resize keeps lanczos3.
+    /// OUTPUT: Lazy libvips pipeline; no pixels are computed until encode.
+    func transform(_ image: HokusaiImage) throws -> HokusaiImage {
+        var current = image
+        var index = steps.startIndex
+        while index < steps.endIndex {
+            let run = try AffineRun.plan(steps[index...], width: current.width, height: current.height)
+            if run.count > 1 {
+                current = try current.transform(
+                    affine: run.transform,
+                    interpolator: run.interpolator,
+                    outputArea: run.outputArea,
+                    background: run.background
+                )
+                index += run.count
+                continue
+            }
+
+            switch steps[index] {
+            case .resize(let options):
+                current = try current.resize(options: options)
+            case .crop(let options):
+                current = try current.crop(options: options)
+            case .rotate(let angle, let background):
+                current = try current.rotate(angle: angle, background: background)
+            case .flip(let direction):
+                current = try current.flip(direction: direction)
+            case .autoRotate:
+                current = try current.autoRotate()
+            case .affine(let affine, let interpolator, let background):
+                current = try current.transform(affine: affine, interpolator: interpolator, background: background)
+            case .custom(let name):
+                current = try current.apply(operation: name)
+            }
+            index += 1
+        }
+        return current
+    }
+
+    /// PURPOSE: Encode a transformed image with the recipe output options.
+    func encode(_ image: HokusaiImage) throws -> Data {
+        return try image.toBuffer(options: output)
+    }
+
+    /// PURPOSE: Load (with shrink-on-load when possible), transform, and encode a single input.
+    /// INPUT: `concurrentRuns`: how many `run` calls the caller executes at once; above 1,
+    /// each image is held to its share of libvips threads so workers don't oversubscribe cores.
+    /// CONSTRAINTS: Synchronous; callers own threading (batch APIs, daemon workers).
+    public func run(_ input: ImageInput, concurrentRuns: Int = 1) throws -> Data {
+        let image = try transform(load(input))
+        guard concurrentRuns > 1 else {
+            return try encode(image)
+        }
+        return try encode(image.limitingConcurrency(BatchLimits.vipsThreads(forWorkers: concurrentRuns)))
+    }
+}
+
+// MARK: - Codable
+
+extension ProcessingRecipe {
+    /// PURPOSE: `steps` may be omitted for pure format conversion recipes.
+    public init(from decoder: Decoder) throws {
+        let container = try decoder.container(keyedBy: CodingKeys.self)
+        self.init(
+            steps: try container.decodeIfPresent([ProcessingStep].self, forKey: .steps) ?? [],
+            output: try container.decode(SaveOptions.self, forKey: .output)
+        )
+    }
+}
+
+/// PURPOSE: Flat `op`-tagged JSON so non-Swift clients can author recipes by hand.
+/// ```json
+/// {"steps": [{"op": "resize", "width": 320, "fit": "cover"},
+///            {"op": "rotate", "angle": 90},
+///            {"op": "flip", "direction": "horizontal"},
+///            {"op": "autoRotate"},
+///            {"op": "affine", "a": 0.9, "b": -0.1, "c": 0.1, "d": 0.9, "interpolator": "lbb"},
+///            {"op": "custom", "name": "invert"}],
+///  "output": {"format": "webp", "quality": 80}}
+/// ```
+extension ProcessingStep: Codable {
+    private enum CodingKeys: String, CodingKey {
+        case op, angle, background, direction, interpolator, name
+    }
+
+    public init(from decoder: Decoder) throws {
+        let container = try decoder.container(keyedBy: CodingKeys.self)
+        let op = try container.decode(String.self, forKey: .op)
+
+        switch op {
+        case "resize":
+            self = .resize(try ResizeOptions(from: decoder))
+        case "crop":
+            self = .crop(try CropOptions(from: decoder))
+        case "rotate":
+            self = .rotate(
+                try container.decode(RotationAngle.self, forKey: .angle),
+                background: try container.decodeIfPresent([Double].self, forKey: .background)
+            )
+        case "flip":
+            self = .flip(try container.decode(FlipDirection.self, forKey: .direction))
+        case "autoRotate":
+            self = .autoRotate
+        case "custom":
+            self = .custom(try container.decode(String.self, forKey: .name))
+        case "affine":
+            self = .affine(
+                try AffineTransform(from: decoder),
+                interpolator: try container.decodeIfPresent(Interpolator.self, forKey: .interpolator) ?? .bicubic,
+                background: try container.decodeIfPresent([Double].self, forKey: .background)
+            )
+        default:
+            throw DecodingError.dataCorruptedError(
+                forKey: .op,
+                in: container,
+                debugDescription: "Unknown processing step '\(op)'"
+            )
+        }
+    }
+
+    public func encode(to encoder: Encoder) throws {
+        var container = encoder.container(keyedBy: CodingKeys.self)
+
+        switch self {
+        case .resize(let options):
+            try container.encode("resize", forKey: .op)
+            try options.encode(to: encoder)
+        case .crop(let options):
+            try container.encode("crop", forKey: .op)
+            try options.encode(to: encoder)
+        case .rotate(let angle, let background):
+            try container.encode("rotate", forKey: .op)
+            try container.encode(angle, forKey: .angle)
+            try container.encodeIfPresent(background, forKey: .background)
+        case .flip(let direction):
+            try container.encode("flip", forKey: .op)
+            try container.encode(direction, forKey: .direction)
+        case .autoRotate:
+            try container.encode("autoRotate", forKey: .op)
+        case .custom(let name):
+            try container.encode("custom", forKey: .op)
+            try container.encode(name, forKey: .name)
+        case .affine(let affine, let interpolator, let background):
+            try container.encode("affine", forKey: .op)
+            try affine.encode(to: encoder)
+            try container.encode(interpolator, forKey: .interpolator)
+            try container.encodeIfPresent(background, forKey: .background)
+        }
+    }
+}
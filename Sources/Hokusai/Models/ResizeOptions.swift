@@ -26,6 +26,9 @@ public struct ResizeOptions: Sendable {
     /// PURPOSE: Background color for contain mode [R, G, B, A]
     public var background: [Double]?
 
+    /// PURPOSE: Sharpen the resized pixels in the same pipeline (nil = off)
+    public var sharpen: SharpenMode?
+
     public init(
         width: Int? = nil,
         height: Int? = nil,
@@ -34,7 +37,8 @@ public struct ResizeOptions: Sendable {
         kernel: Kernel = .lanczos3,
         withoutEnlargement: Bool = false,
         withoutReduction: Bool = false,
-        background: [Double]? = nil
+        background: [Double]? = nil,
+        sharpen: SharpenMode? = nil
     ) {
         self.width = width
         self.height = height
@@ -44,6 +48,32 @@ public struct ResizeOptions: Sendable {
         self.withoutEnlargement = withoutEnlargement
         self.withoutReduction = withoutReduction
         self.background = background
+        self.sharpen = sharpen
+    }
+}
+
+/// PURPOSE: Post-resize sharpening for `ResizeOptions.sharpen`
+public enum SharpenMode: Sendable, Equatable {
+    /// PURPOSE: Strength derived from the reduction factor; skipped when enlarging
+    case auto
+
+    /// PURPOSE: Explicit `vips_sharpen` parameters: radius `sigma`, flat-area
+    /// gain `m1`, and jagged-area gain `m2`
+    case custom(sigma: Double, m1: Double, m2: Double)
+
+    /// PURPOSE: Resolve to sharpen parameters for a resize by `reduction` (input/output size).
+    /// ALGORITHM (`.auto`): `sigma` grows 0.5 → 1.0 and `m2` 1 → 3 as the reduction goes
+    /// from 1x to 4x; flat areas get a light `m1` of 0.5 so noise is not amplified.
+    /// OUTPUT: nil when no sharpening should run.
+    func parameters(reduction: Double) -> (sigma: Double, m1: Double, m2: Double)? {
+        switch self {
+        case .auto:
+            guard reduction > 1 else { return nil }
+            let octaves = min(log2(reduction), 2)
+            return (0.5 + 0.25 * octaves, 0.5, 1 + octaves)
+        case .custom(let sigma, let m1, let m2):
+            return (sigma, m1, m2)
+        }
     }
 }
 
@@ -61,8 +91,14 @@ public struct SaveOptions: Sendable {
     /// PURPOSE: Enable progressive/interlaced output
     public var progressive: Bool
 
-    /// PURPOSE: Strip metadata
-    public var stripMetadata: Bool
+    /// PURPOSE: Which metadata to write (all formats, file and buffer saves)
+    public var metadata: MetadataPolicy
+
+    /// PURPOSE: Strip metadata; shorthand for `metadata = .strip`
+    public var stripMetadata: Bool {
+        get { metadata == .strip }
+        set { metadata = newValue ? .strip : .all }
+    }
 
     /// PURPOSE: Enable lossless compression (for WebP)
     public var lossless: Bool
@@ -77,18 +113,66 @@ public struct SaveOptions: Sendable {
         progressive: Bool = false,
         stripMetadata: Bool = false,
         lossless: Bool = false,
-        effort: Int? = nil
+        effort: Int? = nil,
+        metadata: MetadataPolicy = .all
     ) {
         self.format = format
         self.quality = quality
         self.compression = compression
         self.progressive = progressive
-        self.stripMetadata = stripMetadata
+        self.metadata = stripMetadata ? .strip : metadata
         self.lossless = lossless
         self.effort = effort
     }
 }
 
+/// PURPOSE: Metadata categories that can be kept on save
+public struct MetadataKinds: OptionSet, Sendable, Hashable {
+    public let rawValue: Int
+
+    public init(rawValue: Int) {
+        self.rawValue = rawValue
+    }
+
+    /// PURPOSE: Full EXIF block (includes orientation and copyright)
+    public static let exif = MetadataKinds(rawValue: 1 << 0)
+
+    /// PURPOSE: XMP packet
+    public static let xmp = MetadataKinds(rawValue: 1 << 1)
+
+    /// PURPOSE: IPTC block
+    public static let iptc = MetadataKinds(rawValue: 1 << 2)
+
+    /// PURPOSE: Embedded ICC profile (keeps colours accurate)
+    public static let icc = MetadataKinds(rawValue: 1 << 3)
+
+    /// PURPOSE: Format-specific extras such as PNG text chunks and GIF comments (libvips 8.15+)
+    public static let other = MetadataKinds(rawValue: 1 << 4)
+
+    /// PURPOSE: EXIF Copyright only
+    public static let copyright = MetadataKinds(rawValue: 1 << 5)
+
+    /// PURPOSE: EXIF Orientation only
+    public static let orientation = MetadataKinds(rawValue: 1 << 6)
+
+    static let names: [(String, MetadataKinds)] = [
+        ("exif", .exif), ("xmp", .xmp), ("iptc", .iptc), ("icc", .icc),
+        ("other", .other), ("copyright", .copyright), ("orientation", .orientation),
+    ]
+}
+
+/// PURPOSE: Metadata retention policy for saves
+public enum MetadataPolicy: Sendable, Equatable {
+    /// PURPOSE: Write everything the image carries
+    case all
+
+    /// PURPOSE: Write no metadata
+    case strip
+
+    /// PURPOSE: Write only these categories
+    case keep(MetadataKinds)
+}
+
 /// PURPOSE: Options for crop operations
 public struct CropOptions: Sendable {
     /// PURPOSE: Left offset
@@ -110,3 +194,132 @@ public struct CropOptions: Sendable {
         self.height = height
     }
 }
+
+// MARK: - Codable
+
+/// PURPOSE: Recipe JSON may omit any field that has an initializer default.
+extension ResizeOptions: Codable {
+    public init(from decoder: Decoder) throws {
+        let container = try decoder.container(keyedBy: CodingKeys.self)
+        self.init(
+            width: try container.decodeIfPresent(Int.self, forKey: .width),
+            height: try container.decodeIfPresent(Int.self, forKey: .height),
+            fit: try container.decodeIfPresent(ResizeFit.self, forKey: .fit) ?? .cover,
+            position: try container.decodeIfPresent(Position.self, forKey: .position) ?? .center,
+            kernel: try container.decodeIfPresent(Kernel.self, forKey: .kernel) ?? .lanczos3,
+            withoutEnlargement: try container.decodeIfPresent(Bool.self, forKey: .withoutEnlargement) ?? false,
+            withoutReduction: try container.decodeIfPresent(Bool.self, forKey: .withoutReduction) ?? false,
+            background: try container.decodeIfPresent([Double].self, forKey: .background),
+            sharpen: try container.decodeIfPresent(SharpenMode.self, forKey: .sharpen)
+        )
+    }
+}
+
+/// PURPOSE: Recipe JSON may omit any field that has an initializer default.
+extension SaveOptions: Codable {
+    public init(from decoder: Decoder) throws {
+        let container = try decoder.container(keyedBy: CodingKeys.self)
+        self.init(
+            format: try container.decodeIfPresent(ImageFormat.self, forKey: .format),
+            quality: try container.decodeIfPresent(Int.self, forKey: .quality),
+            compression: try container.decodeIfPresent(Int.self, forKey: .compression),
+            progressive: try container.decodeIfPresent(Bool.self, forKey: .progressive) ?? false,
+            stripMetadata: try container.decodeIfPresent(Bool.self, forKey: .stripMetadata) ?? false,
+            lossless: try container.decodeIfPresent(Bool.self, forKey: .lossless) ?? false,
+            effort: try container.decodeIfPresent(Int.self, forKey: .effort),
+            metadata: try container.decodeIfPresent(MetadataPolicy.self, forKey: .metadata) ?? .all
+        )
+    }
+
+    public func encode(to encoder: Encoder) throws {
+        var container = encoder.container(keyedBy: CodingKeys.self)
+        try container.encodeIfPresent(format, forKey: .format)
+        try container.encodeIfPresent(quality, forKey: .quality)
+        try container.encodeIfPresent(compression, forKey: .compression)
+        try container.encode(progressive, forKey: .progressive)
+        try container.encode(metadata, forKey: .metadata)
+        try container.encode(lossless, forKey: .lossless)
+        try container.encodeIfPresent(effort, forKey: .effort)
+    }
+
+    /// PURPOSE: `stripMetadata` is still accepted from older recipes.
+    private enum CodingKeys: String, CodingKey {
+        case format, quality, compression, progressive, stripMetadata, metadata, lossless, effort
+    }
+}
+
+/// PURPOSE: `"all"`, `"strip"` (`"none"` is accepted as an alias), or a list such as `["icc", "orientation"]`.
+extension MetadataPolicy: Codable {
+    public init(from decoder: Decoder) throws {
+        let container = try decoder.singleValueContainer()
+        if let keyword = try? container.decode(String.self) {
+            switch keyword {
+            case "all": self = .all
+            case "strip", "none": self = .strip
+            default:
+                throw DecodingError.dataCorruptedError(in: container, debugDescription: "Unknown metadata policy \(keyword)")
+            }
+            return
+        }
+
+        var kinds: MetadataKinds = []
+        for name in try container.decode([String].self) {
+            guard let kind = MetadataKinds.names.first(where: { $0.0 == name })?.1 else {
+                throw DecodingError.dataCorruptedError(in: container, debugDescription: "Unknown metadata kind \(name)")
+            }
+            kinds.insert(kind)
+        }
+        self = .keep(kinds)
+    }
+
+    public func encode(to encoder: Encoder) throws {
+        var container = encoder.singleValueContainer()
+        switch self {
+        case .all:
+            try container.encode("all")
+        case .strip:
+            try container.encode("strip")
+        case .keep(let kinds):
+            try container.encode(MetadataKinds.names.filter { kinds.contains($0.1) }.map(\.0))
+        }
+    }
+}
+
+/// PURPOSE: `"auto"` or `{"sigma": 0.8, "m1": 0.5, "m2": 2}`.
+extension SharpenMode: Codable {
+    private enum CodingKeys: String, CodingKey {
+        case sigma, m1, m2
+    }
+
+    public init(from decoder: Decoder) throws {
+        if let keyword = try? decoder.singleValueContainer().decode(String.self) {
+            guard keyword == "auto" else {
+                throw DecodingError.dataCorrupted(.init(codingPath: decoder.codingPath, debugDescription: "Unknown sharpen mode \(keyword)"))
+            }
+            self = .auto
+            return
+        }
+
+        let container = try decoder.container(keyedBy: CodingKeys.self)
+        self = .custom(
+            sigma: try container.decode(Double.self, forKey: .sigma),
+            m1: try container.decode(Double.self, forKey: .m1),
+            m2: try container.decode(Double.self, forKey: .m2)
+        )
+    }
+
+    public func encode(to encoder: Encoder) throws {
+        switch self {
+        case .auto:
+            var container = encoder.singleValueContainer()
+            try container.encode("auto")
+        case .custom(let sigma, let m1, let m2):
+            var container = encoder.container(keyedBy: CodingKeys.self)
+            try container.encode(sigma, forKey: .sigma)
+            try container.encode(m1, forKey: .m1)
+            try container.encode(m2, forKey: .m2)
+        }
+    }
+}
+
+extension CropOptions: Codable {}
@@ -0,0 +1,40 @@
+import Foundation
+
+/// PURPOSE: Placement of one input inside a sprite atlas, in atlas pixels.
+public struct SpriteFrame: Codable, Sendable, Equatable {
+    public let name: String
+    public let x: Int
+    public let y: Int
+    public let width: Int
+    public let height: Int
+
+    public init(name: String, x: Int, y: Int, width: Int, height: Int) {
+        self.name = name
+        self.x = x
+        self.y = y
+        self.width = width
+        self.height = height
+    }
+}
+
+/// PURPOSE: Packed atlas image plus the coordinate map for its sprites.
+/// CONSTRAINTS: `frames` follow the order of the inputs passed to `Hokusai.spriteAtlas`.
+public struct SpriteAtlas: Sendable {
+    public let image: HokusaiImage
+    public let width: Int
+    public let height: Int
+    public let frames: [SpriteFrame]
+
+    private struct Map: Codable {
+        let width: Int
+        let height: Int
+        let frames: [SpriteFrame]
+    }
+
+    /// PURPOSE: Coordinate map as JSON: `{"width", "height", "frames": [{name, x, y, width, height}]}`.
+    public func jsonMap(prettyPrinted: Bool = false) throws -> Data {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = prettyPrinted ? [.prettyPrinted, .sortedKeys] : [.sortedKeys]
+        return try encoder.encode(Map(width: width, height: height, frames: frames))
+    }
+}
@@ -0,0 +1,210 @@
+import Foundation
+import CVips
+
+/// PURPOSE: Input/output range remap for `adjust(...)`, on a 0...1 scale.
+/// CONSTRAINTS: Values below `inputBlack` clip to `outputBlack`, above `inputWhite` to `outputWhite`;
+/// both outputs must lie within 0...1.
+public struct ToneLevels: Sendable, Hashable {
+    public var inputBlack: Double
+    public var inputWhite: Double
+    public var outputBlack: Double
+    public var outputWhite: Double
+
+    public init(inputBlack: Double = 0, inputWhite: Double = 1, outputBlack: Double = 0, outputWhite: Double = 1) {
+        self.inputBlack = inputBlack
+        self.inputWhite = inputWhite
+        self.outputBlack = outputBlack
+        self.outputWhite = outputWhite
+    }
+
+    public static let identity = ToneLevels()
+}
+
+extension HokusaiImage {
+    /// PURPOSE: Brightness, contrast, gamma, and levels in one pixel pass.
+    /// ALGORITHM:
+    /// - All parameters compile into one lookup table (256 entries for 8-bit,
+    ///   65536 for 16-bit): levels in → gamma → contrast → brightness → levels out.
+    /// - The table has one band per image band (alpha is identity) and is applied
+    ///   with a single `maplut`; tables are shared through `ToneCurveCache`.
+    /// INPUT:
+    /// - `brightness`: offset on a 0...1 scale (-1...1, 0 = unchanged).
+    /// - `contrast`: slope around mid-grey (1 = unchanged).
+    /// - `gamma`: output = input^(1/gamma) (1 = unchanged).
+    /// CONSTRAINTS: 8- and 16-bit unsigned images only.
+    ///
+    /// Example:
+    /// ```swift
+    /// let punchy = try image.adjust(brightness: 0.05, contrast: 1.2, gamma: 1.1)
+    /// let lifted = try image.adjust(levels: ToneLevels(inputBlack: 0.05, inputWhite: 0.95))
+    /// ```
+    public func adjust(
+        brightness: Double = 0,
+        contrast: Double = 1,
+        gamma: Double = 1,
+        levels: ToneLevels = .identity
+    ) throws -> HokusaiImage {
+        guard gamma > 0, levels.inputWhite > levels.inputBlack else {
+            throw HokusaiError.invalidOperation("gamma must be positive and inputWhite above inputBlack")
+        }
+        let outputRange = 0.0...1.0
+        guard outputRange.contains(levels.outputBlack), outputRange.contains(levels.outputWhite) else {
+            throw HokusaiError.invalidOperation("outputBlack and outputWhite must be within 0...1")
+        }
+        let pointer = try ensureVipsBackend().getPointer()
+
+        let curve = ToneCurve(brightness: brightness, contrast: contrast, gamma: gamma, levels: levels)
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        if curve.isIdentity {
+            guard swift_vips_copy(pointer, &output) == 0, let out = output else {
+                throw HokusaiError.vipsError(VipsBackend.getLastError())
+            }
+            return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
+        }
+
+        let format = swift_vips_image_get_band_format(pointer)
+        let entries: Int
+        switch format {
+        case Int32(VIPS_FORMAT_UCHAR.rawValue): entries = 256
+        case Int32(VIPS_FORMAT_USHORT.rawValue): entries = 65536
+        default:
+            throw HokusaiError.notSupported("adjust needs an 8- or 16-bit unsigned image")
+        }
+
+        let bands = Int(vips_image_get_bands(pointer))
+        let alphaBand = vips_image_hasalpha(pointer) != 0 ? bands - 1 : nil
+        let key = ToneCurveCache.Key(curve: curve, entries: entries, bands: bands, alphaBand: alphaBand)
+        let lut = try ToneCurveCache.shared.table(for: key)
+
+        let result = withExtendedLifetime(lut) {
+            swift_vips_maplut(pointer, &output, lut.image)
+        }
+        guard result == 0, let out = output else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
+    }
+}
+
+/// PURPOSE: Tone parameters as a pure 0...1 → 0...1 function.
+struct ToneCurve: Hashable {
+    let brightness: Double
+    let contrast: Double
+    let gamma: Double
+    let levels: ToneLevels
+
+    var isIdentity: Bool {
+        return brightness == 0 && contrast == 1 && gamma == 1 && levels == .identity
+    }
+
+    func apply(_ value: Double) -> Double {
+        var x = (value - levels.inputBlack) / (levels.inputWhite - levels.inputBlack)
+        x = min(max(x, 0), 1)
+        if gamma != 1 {
+            x = pow(x, 1 / gamma)
+        }
+        x = (x - 0.5) * contrast + 0.5 + brightness
+        x = min(max(x, 0), 1)
+        return levels.outputBlack + x * (levels.outputWhite - levels.outputBlack)
+    }
+}
+
+/// PURPOSE: Small LRU of built lookup-table images keyed by curve and pixel layout.
+/// CONSTRAINTS: Thread-safe. `maplut` takes its own reference, so eviction never
+/// invalidates an image that is still being rendered.
+final class ToneCurveCache: @unchecked Sendable {
+    struct Key: Hashable {
+        let curve: ToneCurve
+        let entries: Int
+        let bands: Int
+        let alphaBand: Int?
+    }
+
+    /// PURPOSE: Owns one reference to a LUT image.
+    final class Table: @unchecked Sendable {
+        let image: UnsafeMutablePointer<CVips.VipsImage>
+
+        init(image: UnsafeMutablePointer<CVips.VipsImage>) {
+            self.image = image
+        }
+
+        deinit {
+            g_object_unref(image)
+        }
+    }
+
+    static let shared = ToneCurveCache(capacity: 32)
+
+    private let capacity: Int
+    private let lock = NSLock()
+    private var tables: [Key: Table] = [:]
+    private var order: [Key] = []
+
+    init(capacity: Int) {
+        self.capacity = capacity
+    }
+
+    var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return tables.count
+    }
+
+    func table(for key: Key) throws -> Table {
+        lock.lock()
+        if let table = tables[key] {
+            order.removeAll { $0 == key }
+            order.append(key)
+            lock.unlock()
+            return table
+        }
+        lock.unlock()
+
+        let table = try Self.build(key)
+
+        lock.lock()
+        defer { lock.unlock() }
+        if let existing = tables[key] {
+            return existing
+        }
+        tables[key] = table
+        order.append(key)
+        if order.count > capacity {
+            tables.removeValue(forKey: order.removeFirst())
+        }
+        return table
+    }
+
+    private static func build(_ key: Key) throws -> Table {
+        let maximum = Double(key.entries - 1)
+        // PURPOSE: Clamp so non-finite or out-of-range values can never trap the integer conversion.
+        let curve = (0..<key.entries).map { index in
+            let value = (key.curve.apply(Double(index) / maximum) * maximum).rounded()
+            return value.isFinite ? min(max(value, 0), maximum) : 0
+        }
+
+        let image: UnsafeMutablePointer<CVips.VipsImage>?
+        if key.entries == 256 {
+            var samples = [UInt8](repeating: 0, count: key.entries * key.bands)
+            for index in 0..<key.entries {
+                for band in 0..<key.bands {
+                    samples[index * key.bands + band] = band == key.alphaBand ? UInt8(index) : UInt8(curve[index])
+                }
+            }
+            image = swift_vips_lut_new(samples, Int32(key.entries), Int32(key.bands), VIPS_FORMAT_UCHAR)
+        } else {
+            var samples = [UInt16](repeating: 0, count: key.entries * key.bands)
+            for index in 0..<key.entries {
+                for band in 0..<key.bands {
+                    samples[index * key.bands + band] = band == key.alphaBand ? UInt16(index) : UInt16(curve[index])
+                }
+            }
+            image = swift_vips_lut_new(samples, Int32(key.entries), Int32(key.bands), VIPS_FORMAT_USHORT)
+        }
+
+        guard let image else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return Table(image: image)
+    }
+}
@@ -0,0 +1,98 @@
+import Foundation
+import CVips
+
+extension Hokusai {
+    /// PURPOSE: Encode a frame sequence as one animated GIF or WebP, in memory.
+    /// ALGORITHM:
+    /// - Frames are normalised to sRGB RGBA and stacked into a single multi-page
+    ///   image (`page-height`, per-frame `delay`, `loop`), then encoded in one save.
+    /// - GIF: frame differencing against the previous frame and a shared palette.
+    /// - WebP: keyframe interval and `min_size` search from `options`.
+    /// INPUT:
+    /// - `delays`: milliseconds per frame; a single value applies to every frame.
+    /// - `loop`: repeat count, 0 loops forever.
+    /// CONSTRAINTS: Every frame must have the same dimensions; no temp files are written.
+    ///
+    /// Example:
+    /// ```swift
+    /// let reel = try Hokusai.animate(frames: previews, delays: [120], loop: 0, format: .webp)
+    /// ```
+    public static func animate(
+        frames: [HokusaiImage],
+        delays: [Int],
+        loop: Int = 0,
+        format: ImageFormat = .webp,
+        options: AnimationOptions = AnimationOptions()
+    ) throws -> Data {
+        guard let first = frames.first else {
+            throw HokusaiError.invalidOperation("animate needs at least one frame")
+        }
+        guard format == .gif || format == .webp else {
+            throw HokusaiError.unsupportedFormat("animation output must be gif or webp, got \(format.rawValue)")
+        }
+        guard delays.count == 1 || delays.count == frames.count, delays.allSatisfy({ $0 >= 0 }) else {
+            throw HokusaiError.invalidOperation("delays needs one value or one per frame")
+        }
+        if let interval = options.keyframeInterval, interval.lowerBound < 0 || interval.lowerBound >= interval.upperBound {
+            throw HokusaiError.invalidOperation("keyframeInterval needs 0 <= kmin < kmax, got \(interval)")
+        }
+
+        let width = try first.width
+        let height = try first.height
+        for (index, frame) in frames.enumerated() {
+            let size = (try frame.width, try frame.height)
+            guard size == (width, height) else {
+                throw HokusaiError.invalidOperation("frame \(index) is \(size.0)x\(size.1), expected \(width)x\(height)")
+            }
+        }
+
+        let normalized = try frames.map(Montage.rgba)
+        var pointers: [UnsafeMutablePointer<CVips.VipsImage>?] = try normalized.map { try $0.getVipsPointer() }
+        let frameDelays = (delays.count == 1 ? Array(repeating: delays[0], count: frames.count) : delays).map { Int32($0) }
+
+        var assembled: UnsafeMutablePointer<CVips.VipsImage>?
+        let assembleResult = pointers.withUnsafeMutableBufferPointer { buffer in
+            swift_vips_animation_assemble(buffer.baseAddress, Int32(buffer.count), frameDelays, Int32(loop), &assembled)
+        }
+        guard assembleResult == 0, let animation = assembled else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        defer { g_object_unref(animation) }
+
+        var buffer: UnsafeMutableRawPointer?
+        var length = 0
+        let result: Int32
+        if format == .gif {
+            result = swift_vips_gifsave_buffer_animated(
+                animation,
+                &buffer,
+                &length,
+                Int32(options.effort ?? 7),
+                options.frameDifferenceTolerance,
+                options.sharedPalette ? 1 : 0,
+                SWIFT_VIPS_KEEP_NONE
+            )
+        } else {
+            result = swift_vips_webpsave_buffer_animated(
+                animation,
+                &buffer,
+                &length,
+                Int32(options.quality),
+                options.lossless ? 1 : 0,
+                Int32(options.effort ?? 4),
+                Int32(options.keyframeInterval?.lowerBound ?? Int(Int32.max) - 1),
+                Int32(options.keyframeInterval?.upperBound ?? Int(Int32.max)),
+                options.minimizeSize ? 1 : 0,
+                SWIFT_VIPS_KEEP_NONE
+            )
+        }
+
+        guard result == 0, let buf = buffer else {
+            throw HokusaiError.saveFailed(VipsBackend.getLastError())
+        }
+        defer { g_free(buf) }
+        return withExtendedLifetime(normalized) {
+            Data(bytes: buf, count: length)
+        }
+    }
+}
@@ -0,0 +1,227 @@
+import Foundation
+import CVips
+
+/// PURPOSE: Destination colour space for `toColorspace(_:intent:inputProfile:)`.
+/// CONSTRAINTS: `.profile` bytes, like embedded input profiles, are materialised once per
+/// distinct profile (see `ICCProfileCache`).
+public enum ColorSpace: Sendable, Hashable {
+    case sRGB
+    case displayP3
+    case cmyk
+    case profile(Data)
+}
+
+/// PURPOSE: ICC rendering intent used when gamuts differ.
+public enum RenderingIntent: String, Sendable, Codable, CaseIterable {
+    case perceptual
+    case relative
+    case saturation
+    case absolute
+
+    var vipsIntent: VipsIntent {
+        switch self {
+        case .perceptual: return VIPS_INTENT_PERCEPTUAL
+        case .relative: return VIPS_INTENT_RELATIVE
+        case .saturation: return VIPS_INTENT_SATURATION
+        case .absolute: return VIPS_INTENT_ABSOLUTE
+        }
+    }
+}
+
+extension HokusaiImage {
+    /// PURPOSE: Convert pixels into `target` through the image's colour profile.
+    /// ALGORITHM:
+    /// - The embedded ICC profile is used when present; otherwise `inputProfile`,
+    ///   otherwise the libvips default for the interpretation (`cmyk` or `srgb`).
+    /// - An explicit `inputProfile` overrides any embedded profile.
+    /// - Untagged sRGB going to `.sRGB` skips LCMS entirely.
+    /// CONSTRAINTS:
+    /// - Requires libvips built with LCMS for anything but the untagged/greyscale sRGB paths.
+    /// - Alpha is carried through unchanged.
+    ///
+    /// Example:
+    /// ```swift
+    /// let web = try image.toColorspace(.sRGB, intent: .perceptual)
+    /// let print = try image.toColorspace(.profile(fograProfile), intent: .relative)
+    /// ```
+    public func toColorspace(
+        _ target: ColorSpace,
+        intent: RenderingIntent = .relative,
+        inputProfile: Data? = nil
+    ) throws -> HokusaiImage {
+        let pointer = try ensureVipsBackend().getPointer()
+        let output = try ColorManagement.transform(pointer, to: target, intent: intent, inputProfile: inputProfile)
+        return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: output)))
+    }
+}
+
+/// PURPOSE: Shared ICC plumbing for `toColorspace` and the compositing input normaliser.
+enum ColorManagement {
+    /// PURPOSE: New image in `target`; the caller owns the returned reference.
+    static func transform(
+        _ image: UnsafeMutablePointer<CVips.VipsImage>,
+        to target: ColorSpace,
+        intent: RenderingIntent,
+        inputProfile: Data?
+    ) throws -> UnsafeMutablePointer<CVips.VipsImage> {
+        let interpretation = swift_vips_image_get_interpretation(image)
+        let embedded = embeddedProfile(image)
+        let tagged = embedded != nil
+        let isGrey = interpretation == Int32(VIPS_INTERPRETATION_B_W.rawValue)
+            || interpretation == Int32(VIPS_INTERPRETATION_GREY16.rawValue)
+
+        // PURPOSE: Untagged sRGB/greyscale needs no profile maths to reach sRGB.
+        if target == .sRGB, !tagged, inputProfile == nil, interpretation != Int32(VIPS_INTERPRETATION_CMYK.rawValue) {
+            var output: UnsafeMutablePointer<CVips.VipsImage>?
+            let result = interpretation == Int32(VIPS_INTERPRETATION_sRGB.rawValue)
+                ? swift_vips_copy(image, &output)
+                : swift_vips_colourspace(image, &output, VIPS_INTERPRETATION_sRGB)
+            guard result == 0, let out = output else {
+                throw HokusaiError.vipsError(VipsBackend.getLastError())
+            }
+            return out
+        }
+
+        guard swift_vips_icc_present() != 0 else {
+            throw HokusaiError.notSupported("libvips was built without LCMS; ICC transforms are unavailable")
+        }
+
+        // PURPOSE: Untagged greyscale has no profile of its own; widen to sRGB first and use that.
+        var source = image
+        if isGrey, !tagged, inputProfile == nil {
+            var widened: UnsafeMutablePointer<CVips.VipsImage>?
+            guard swift_vips_colourspace(image, &widened, VIPS_INTERPRETATION_sRGB) == 0, let widened else {
+                throw HokusaiError.vipsError(VipsBackend.getLastError())
+            }
+            source = widened
+        }
+        defer {
+            if source != image {
+                g_object_unref(source)
+            }
+        }
+
+        let outputName = try ICCProfileCache.shared.name(for: target)
+        // PURPOSE: Embedded profiles go through the cache too, so libvips parses each
+        // distinct profile once instead of once per image.
+        let inputName: String
+        if let profile = inputProfile ?? embedded {
+            inputName = try ICCProfileCache.shared.name(for: .profile(profile))
+        } else {
+            inputName = interpretation == Int32(VIPS_INTERPRETATION_CMYK.rawValue) ? "cmyk" : "srgb"
+        }
+
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        let result = swift_vips_icc_transform(
+            source,
+            &output,
+            outputName,
+            inputName,
+            intent.vipsIntent,
+            0
+        )
+        guard result == 0, let out = output else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return out
+    }
+
+    /// PURPOSE: Copy of the embedded ICC profile, or nil when the image is untagged.
+    static func embeddedProfile(_ image: UnsafeMutablePointer<CVips.VipsImage>) -> Data? {
+        var bytes: UnsafeRawPointer?
+        var length = 0
+        guard swift_vips_image_get_blob_field(image, "icc-profile-data", &bytes, &length) == 0,
+              let bytes, length > 0 else {
+            return nil
+        }
+        return Data(bytes: bytes, count: length)
+    }
+}
+
+/// PURPOSE: Process-wide map from profile content hash to a libvips profile name.
+/// ALGORITHM:
+/// - Builtin targets map to libvips' builtin names (`srgb`, `p3`, `cmyk`).
+/// - Supplied and embedded profiles are hashed (SHA-256) and written once to a content-addressed
+///   file; later calls with the same bytes reuse that path without touching disk.
+/// CONSTRAINTS:
+/// - Thread-safe. libvips takes profiles by name, so the LCMS transform itself is
+///   still built per image inside `vips_icc_transform`; what is shared is the profile
+///   file and libvips' own cache of loaded profiles keyed by that name.
+/// - Files live in a private `mkdtemp` directory (mode 0700) owned by this process,
+///   so no other user can plant or swap a profile under a predictable name, and
+///   `purge()` only ever deletes files this process wrote.
+final class ICCProfileCache: @unchecked Sendable {
+    static let shared = ICCProfileCache()
+
+    private let lock = NSLock()
+    private var paths: [String: String] = [:]
+    private var directory: String?
+
+    /// PURPOSE: Distinct supplied profiles materialised so far
+    var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return paths.count
+    }
+
+    func name(for space: ColorSpace) throws -> String {
+        switch space {
+        case .sRGB: return "srgb"
+        case .displayP3: return "p3"
+        case .cmyk: return "cmyk"
+        case .profile(let data):
+            return try path(for: data)
+        }
+    }
+
+    /// PURPOSE: Path of the materialised profile for `data`, writing it on first use.
+    func path(for data: Data) throws -> String {
+        guard !data.isEmpty else {
+            throw HokusaiError.invalidOperation("ICC profile is empty")
+        }
+        let key = StreamingDigest.digest(of: data, algorithms: .sha256).sha256 ?? ""
+
+        lock.lock()
+        defer { lock.unlock() }
+        if let path = paths[key] {
+            return path
+        }
+
+        let path = (try privateDirectory() as NSString).appendingPathComponent("\(key).icc")
+        do {
+            try data.write(to: URL(fileURLWithPath: path), options: .atomic)
+        } catch {
+            throw HokusaiError.saveFailed("ICC profile \(path): \(error)")
+        }
+        paths[key] = path
+        return path
+    }
+
+    /// PURPOSE: Forget cached profiles and delete their files.
+    func purge() {
+        lock.lock()
+        let stale = Array(paths.values)
+        paths.removeAll()
+        lock.unlock()
+        stale.forEach { try? FileManager.default.removeItem(atPath: $0) }
+    }
+
+    // MARK: - Private Helpers
+
+    /// PURPOSE: Create this process's profile directory on first use.
+    /// CONSTRAINTS: Caller holds `lock`.
+    private func privateDirectory() throws -> String {
+        if let directory {
+            return directory
+        }
+        var template = Array((NSTemporaryDirectory() as NSString).appendingPathComponent("hokusai-icc-XXXXXX").utf8CString)
+        let created = template.withUnsafeMutableBufferPointer { buffer in
+            mkdtemp(buffer.baseAddress).map { String(cString: $0) }
+        }
+        guard let path = created else {
+            throw HokusaiError.saveFailed("ICC profile directory: \(String(cString: strerror(errno)))")
+        }
+        directory = path
+        return path
+    }
+}
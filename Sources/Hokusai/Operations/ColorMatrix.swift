@@ -0,0 +1,153 @@
+import Foundation
+import CVips
+
+/// PURPOSE: Affine RGB colour filter: `out = matrix * rgb + offset`, on a 0...1 scale.
+/// ALGORITHM: Filters compose by matrix multiplication, so any chain of presets
+/// reduces to one 3×3 matrix plus offset before touching pixels.
+///
+/// Example:
+/// ```swift
+/// let look = ColorMatrix.saturation(1.3).then(.hueRotate(degrees: 10)).then(.sepia(0.2))
+/// let filtered = try image.colorMatrix(look)
+/// ```
+public struct ColorMatrix: Sendable, Equatable {
+    /// PURPOSE: Row-major 3×3 matrix
+    public var matrix: [Double]
+
+    /// PURPOSE: Per-channel offset (0...1 scale)
+    public var offset: [Double]
+
+    public init(matrix: [Double], offset: [Double] = [0, 0, 0]) {
+        self.matrix = Array((matrix + Array(repeating: 0, count: 9)).prefix(9))
+        self.offset = Array((offset + [0, 0, 0]).prefix(3))
+    }
+
+    /// PURPOSE: Apply `self`, then `next`.
+    public func then(_ next: ColorMatrix) -> ColorMatrix {
+        var product = [Double](repeating: 0, count: 9)
+        var shifted = next.offset
+        for row in 0..<3 {
+            for column in 0..<3 {
+                product[row * 3 + column] = (0..<3).reduce(0) { $0 + next.matrix[row * 3 + $1] * matrix[$1 * 3 + column] }
+                shifted[row] += next.matrix[row * 3 + column] * offset[column]
+            }
+        }
+        return ColorMatrix(matrix: product, offset: shifted)
+    }
+
+    /// PURPOSE: Compose a preset stack in order.
+    public static func chain(_ filters: [ColorMatrix]) -> ColorMatrix {
+        return filters.reduce(.identity) { $0.then($1) }
+    }
+
+    // MARK: - Presets
+
+    private static let luma = [0.2126, 0.7152, 0.0722]
+
+    public static let identity = ColorMatrix(matrix: [1, 0, 0, 0, 1, 0, 0, 0, 1])
+
+    /// PURPOSE: Rec. 709 luma in every channel
+    public static let grayscale = ColorMatrix(matrix: luma + luma + luma)
+
+    /// PURPOSE: Sepia tone blended with the original by `amount` (0...1)
+    public static func sepia(_ amount: Double = 1) -> ColorMatrix {
+        let sepia: [Double] = [0.393, 0.769, 0.189, 0.349, 0.686, 0.168, 0.272, 0.534, 0.131]
+        return ColorMatrix(matrix: zip(sepia, identity.matrix).map { amount * $0 + (1 - amount) * $1 })
+    }
+
+    /// PURPOSE: Scale saturation (0 = grey, 1 = unchanged, >1 = more vivid)
+    public static func saturation(_ amount: Double) -> ColorMatrix {
+        let s = amount
+        return ColorMatrix(matrix: [
+            0.213 + 0.787 * s, 0.715 - 0.715 * s, 0.072 - 0.072 * s,
+            0.213 - 0.213 * s, 0.715 + 0.285 * s, 0.072 - 0.072 * s,
+            0.213 - 0.213 * s, 0.715 - 0.715 * s, 0.072 + 0.928 * s,
+        ])
+    }
+
+    /// PURPOSE: Rotate hue while preserving luminance (CSS `hue-rotate`)
+    public static func hueRotate(degrees: Double) -> ColorMatrix {
+        let c = cos(degrees * .pi / 180)
+        let s = sin(degrees * .pi / 180)
+        return ColorMatrix(matrix: [
+            0.213 + c * 0.787 - s * 0.213, 0.715 - c * 0.715 - s * 0.715, 0.072 - c * 0.072 + s * 0.928,
+            0.213 - c * 0.213 + s * 0.143, 0.715 + c * 0.285 + s * 0.140, 0.072 - c * 0.072 - s * 0.283,
+            0.213 - c * 0.213 - s * 0.787, 0.715 - c * 0.715 + s * 0.715, 0.072 + c * 0.928 + s * 0.072,
+        ])
+    }
+
+    /// PURPOSE: Map luma onto a gradient from `shadow` to `highlight` (RGB, 0...1)
+    public static func duotone(shadow: [Double], highlight: [Double]) -> ColorMatrix {
+        let low = Array((shadow + [0, 0, 0]).prefix(3))
+        let high = Array((highlight + [1, 1, 1]).prefix(3))
+        let rows = (0..<3).flatMap { channel in luma.map { $0 * (high[channel] - low[channel]) } }
+        return ColorMatrix(matrix: rows, offset: low)
+    }
+}
+
+extension HokusaiImage {
+    /// PURPOSE: Apply a colour filter (or a composed stack) in one `recomb` pass.
+    /// ALGORITHM:
+    /// - Non-RGB inputs are brought to sRGB first (CMYK through ICC).
+    /// - The 3×3 matrix and offset become one affine band matrix over
+    ///   `[R, G, B, (A), 1]`, with alpha passed through, then cast back to the
+    ///   input's band format (clipping out-of-range values).
+    /// CONSTRAINTS: Offsets are scaled to the format's range (255 for 8-bit, 65535 for 16-bit).
+    ///
+    /// Example:
+    /// ```swift
+    /// let toned = try image.colorMatrix(.duotone(shadow: [0.1, 0.0, 0.3], highlight: [1.0, 0.9, 0.6]))
+    /// ```
+    public func colorMatrix(_ filter: ColorMatrix) throws -> HokusaiImage {
+        let pointer = try ensureVipsBackend().getPointer()
+
+        var source = pointer
+        let interpretation = swift_vips_image_get_interpretation(pointer)
+        let isRGB = interpretation == Int32(VIPS_INTERPRETATION_sRGB.rawValue)
+            || interpretation == Int32(VIPS_INTERPRETATION_RGB16.rawValue)
+        if !isRGB {
+            source = try ColorManagement.transform(pointer, to: .sRGB, intent: .relative, inputProfile: nil)
+        }
+        defer {
+            if source != pointer {
+                g_object_unref(source)
+            }
+        }
+
+        let bands = Int(vips_image_get_bands(source))
+        guard bands == 3 || bands == 4 else {
+            throw HokusaiError.notSupported("colorMatrix needs RGB or RGBA, got \(bands) bands")
+        }
+
+        let scale: Double
+        switch swift_vips_image_get_band_format(source) {
+        case Int32(VIPS_FORMAT_UCHAR.rawValue): scale = 255
+        case Int32(VIPS_FORMAT_USHORT.rawValue): scale = 65535
+        default: scale = 1
+        }
+
+        // PURPOSE: `bands` output rows over `bands + 1` inputs; the last column is the offset.
+        let columns = bands + 1
+        var affine = [Double](repeating: 0, count: bands * columns)
+        for row in 0..<3 {
+            for column in 0..<3 {
+                affine[row * columns + column] = filter.matrix[row * 3 + column]
+            }
+            affine[row * columns + bands] = filter.offset[row] * scale
+        }
+        if bands == 4 {
+            affine[3 * columns + 3] = 1
+        }
+
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        guard swift_vips_recomb_affine(source, &output, affine, Int32(bands)) == 0, let out = output else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
+    }
+
+    /// PURPOSE: Apply a filter stack as a single pass; same as `colorMatrix(.chain(filters))`.
+    public func colorMatrix(_ filters: [ColorMatrix]) throws -> HokusaiImage {
+        return try colorMatrix(.chain(filters))
+    }
+}
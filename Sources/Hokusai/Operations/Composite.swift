@@ -68,7 +68,12 @@ extension HokusaiImage {
         let overlayWithAlpha = try ensureRGBA(overlayPointer)
         var overlayForComposite = overlayWithAlpha
         if options.opacity < 1.0 {
-            overlayForComposite = try applyOpacity(overlayWithAlpha, opacity: options.opacity)
+            do {
+                overlayForComposite = try applyOpacity(overlayWithAlpha, opacity: options.opacity)
+            } catch {
+                g_object_unref(overlayWithAlpha)
+                throw error
+            }
             if overlayForComposite != overlayWithAlpha {
                 g_object_unref(overlayWithAlpha)
             }
@@ -102,8 +107,99 @@ extension HokusaiImage {
         return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
     }
 
+    /// PURPOSE: Repeat a watermark across the whole image at an angle, in one composite.
+    /// ALGORITHM:
+    /// - Pad the overlay by `spacing` into one transparent pattern tile.
+    /// - `replicate` the tile lazily over a square covering the image diagonal,
+    ///   rotate that plane by `angle`, and cut out the image-sized centre.
+    /// - Blend the pattern over the image with a single `composite`.
+    /// CONSTRAINTS: Work is proportional to the output size, not the number of repeats;
+    /// only the tiles under each output region are ever computed.
+    ///
+    /// Example:
+    /// ```swift
+    /// let protected = try photo.tiledWatermark(overlay: logo, spacing: 120, angle: -30, opacity: 0.25)
+    /// ```
+    public func tiledWatermark(
+        overlay: HokusaiImage,
+        spacing: Int = 64,
+        angle: Double = -30,
+        opacity: Double = 0.3
+    ) throws -> HokusaiImage {
+        guard spacing >= 0 else {
+            throw HokusaiError.invalidOperation("spacing must not be negative")
+        }
+        let basePointer = try ensureVipsBackend().getPointer()
+        let overlayPointer = try overlay.ensureVipsBackend().getPointer()
+        let width = Int(vips_image_get_width(basePointer))
+        let height = Int(vips_image_get_height(basePointer))
+
+        let baseWithAlpha = try ensureRGBA(basePointer)
+        defer { g_object_unref(baseWithAlpha) }
+
+        let overlayWithAlpha = try ensureRGBA(overlayPointer)
+        var pattern = overlayWithAlpha
+        let clamped = min(max(opacity, 0.0), 1.0)
+        if clamped < 1.0 {
+            do {
+                pattern = try applyOpacity(overlayWithAlpha, opacity: clamped)
+            } catch {
+                g_object_unref(overlayWithAlpha)
+                throw error
+            }
+            if pattern != overlayWithAlpha {
+                g_object_unref(overlayWithAlpha)
+            }
+        }
+
+        let transparent: [Double] = [0, 0, 0, 0]
+        guard let background = transparent.withUnsafeBufferPointer({ swift_vips_array_double_new($0.baseAddress, 4) }) else {
+            g_object_unref(pattern)
+            throw HokusaiError.vipsError("Failed to create background array")
+        }
+        defer {
+            vips_area_unref(UnsafeMutablePointer(mutating: UnsafeRawPointer(background).assumingMemoryBound(to: VipsArea.self)))
+        }
+
+        let tileWidth = Int(vips_image_get_width(pattern)) + spacing
+        let tileHeight = Int(vips_image_get_height(pattern)) + spacing
+        let diagonal = Int(Double(width * width + height * height).squareRoot().rounded(.up)) + 1
+        let across = (diagonal + tileWidth - 1) / tileWidth
+        let down = (diagonal + tileHeight - 1) / tileHeight
+
+        pattern = try Self.chain(pattern) { swift_vips_embed($0, $1, Int32(spacing / 2), Int32(spacing / 2), Int32(tileWidth), Int32(tileHeight), background) }
+        pattern = try Self.chain(pattern) { swift_vips_replicate($0, $1, Int32(across), Int32(down)) }
+        if angle.truncatingRemainder(dividingBy: 360) != 0 {
+            pattern = try Self.chain(pattern) { swift_vips_similarity_background($0, $1, angle, background) }
+        }
+        let left = (Int(vips_image_get_width(pattern)) - width) / 2
+        let top = (Int(vips_image_get_height(pattern)) - height) / 2
+        pattern = try Self.chain(pattern) { swift_vips_extract_area($0, $1, Int32(left), Int32(top), Int32(width), Int32(height)) }
+        defer { g_object_unref(pattern) }
+
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        guard swift_vips_composite2(baseWithAlpha, pattern, &output, VIPS_BLEND_MODE_OVER, 0, 0) == 0, let out = output else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
+    }
+
     // MARK: - Private Helpers
 
+    /// PURPOSE: Run one libvips op on an owned image, releasing the input either way.
+    private static func chain(
+        _ input: UnsafeMutablePointer<CVips.VipsImage>,
+        _ operation: (UnsafeMutablePointer<CVips.VipsImage>, UnsafeMutablePointer<UnsafeMutablePointer<CVips.VipsImage>?>) -> Int32
+    ) throws -> UnsafeMutablePointer<CVips.VipsImage> {
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        let result = operation(input, &output)
+        g_object_unref(input)
+        guard result == 0, let out = output else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return out
+    }
+
     private func applyOpacity(
         _ image: UnsafeMutablePointer<CVips.VipsImage>,
         opacity: Double
@@ -153,9 +249,21 @@ extension HokusaiImage {
 
     /// PURPOSE: Ensure the input image is RGBA (4 bands).
     /// ALGORITHM:
+    /// - Move CMYK inputs into sRGB through their ICC profile first; four CMYK
+    ///   bands are not RGBA.
     /// - Convert grayscale inputs to RGB when needed.
     /// - Append alpha channel when missing.
-    private func ensureRGBA(_ image: UnsafeMutablePointer<CVips.VipsImage>) throws -> UnsafeMutablePointer<CVips.VipsImage> {
+    private func ensureRGBA(_ input: UnsafeMutablePointer<CVips.VipsImage>) throws -> UnsafeMutablePointer<CVips.VipsImage> {
+        var image = input
+        if swift_vips_image_get_interpretation(input) == Int32(VIPS_INTERPRETATION_CMYK.rawValue) {
+            image = try ColorManagement.transform(input, to: .sRGB, intent: .relative, inputProfile: nil)
+        }
+        defer {
+            if image != input {
+                g_object_unref(image)
+            }
+        }
+
         let bands = vips_image_get_bands(image)
 
         // PURPOSE: If already RGBA (4 bands), return a copy.
@@ -198,6 +306,10 @@ extension HokusaiImage {
             return out
         }
 
+        // PURPOSE: The caller releases the result, so hand back a reference of its own.
+        if rgbImage == image {
+            g_object_ref(image)
+        }
         return rgbImage
     }
 }
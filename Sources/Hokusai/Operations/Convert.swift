@@ -11,8 +11,9 @@ extension HokusaiImage {
     }
 
     /// PURPOSE: Save image to file
+    /// CONSTRAINTS: `options.metadata` decides which metadata is written, for every format.
     public func toFile(_ path: String, options: SaveOptions = SaveOptions()) throws {
-        let pointer = try ensureVipsBackend().getPointer()
+        let backend = try ensureVipsBackend()
 
         // PURPOSE: Determine format from path extension or options
         let format = options.format ?? ImageFormat.from(fileExtension: (path as NSString).pathExtension)
@@ -21,156 +22,170 @@ extension HokusaiImage {
             throw HokusaiError.unsupportedFormat("Could not determine format from path: \(path)")
         }
 
-        switch outputFormat {
-        case .jpeg:
-            let quality = Int32(options.quality ?? 85)
-            let interlace = options.progressive ? 1 : 0
-            let strip = options.stripMetadata ? 1 : 0
-
-            let result = swift_vips_jpegsave(pointer, path, quality, Int32(interlace), Int32(strip))
-            guard result == 0 else {
-                throw HokusaiError.saveFailed(VipsBackend.getLastError())
+        let result: Int32 = try backend.withMetadataPolicy(options.metadata) { pointer, keep in
+            switch outputFormat {
+            case .jpeg:
+                let quality = Int32(options.quality ?? 85)
+                let interlace = options.progressive ? 1 : 0
+                return swift_vips_jpegsave(pointer, path, quality, Int32(interlace), keep)
+
+            case .png:
+                let compression = Int32(options.compression ?? 6)
+                let interlace = options.progressive ? 1 : 0
+                return swift_vips_pngsave(pointer, path, compression, Int32(interlace), keep)
+
+            case .webp:
+                let quality = Int32(options.quality ?? 80)
+                let lossless = options.lossless ? 1 : 0
+                let effort = Int32(options.effort ?? 4)
+                return swift_vips_webpsave(pointer, path, quality, Int32(lossless), effort, keep)
+
+            case .tiff:
+                let compression = Int32(options.compression ?? 0)
+                return swift_vips_tiffsave(pointer, path, compression, keep)
+
+            case .avif:
+                let quality = Int32(options.quality ?? 80)
+                let lossless = options.lossless ? 1 : 0
+                let effort = Int32(options.effort ?? 4)
+                return swift_vips_heifsave(pointer, path, quality, Int32(lossless), effort, keep)
+
+            case .heif:
+                let quality = Int32(options.quality ?? 80)
+                let lossless = 0
+                let effort = Int32(4)
+                return swift_vips_heifsave(pointer, path, quality, Int32(lossless), effort, keep)
+
+            case .gif:
+                return swift_vips_gifsave(pointer, path, keep)
+
+            default:
+                throw HokusaiError.unsupportedFormat("Saving to \(outputFormat.rawValue) is not yet implemented")
             }
+        }
 
-        case .png:
-            let compression = Int32(options.compression ?? 6)
-            let interlace = options.progressive ? 1 : 0
+        guard result == 0 else {
+            throw VipsBackend.evaluationError(HokusaiError.saveFailed)
+        }
+    }
 
-            let result = swift_vips_pngsave(pointer, path, compression, Int32(interlace))
-            guard result == 0 else {
-                throw HokusaiError.saveFailed(VipsBackend.getLastError())
-            }
+    /// PURPOSE: Save image to Data buffer
+    /// CONSTRAINTS:
+    /// - Output lives in pooled memory returned on `Data` release when libvips
+    ///   supports target saving for the format; otherwise it is copied once.
+    /// - `options.metadata` decides which metadata is written, for every format.
+    public func toBuffer(options: SaveOptions = SaveOptions()) throws -> Data {
+        let backend = try ensureVipsBackend()
 
-        case .webp:
-            let quality = Int32(options.quality ?? 80)
-            let lossless = options.lossless ? 1 : 0
-            let effort = Int32(options.effort ?? 4)
+        guard let format = options.format else {
+            throw HokusaiError.invalidOperation("Must specify format when saving to buffer")
+        }
 
-            let result = swift_vips_webpsave(pointer, path, quality, Int32(lossless), effort)
-            guard result == 0 else {
-                throw HokusaiError.saveFailed(VipsBackend.getLastError())
-            }
+        if let encoded = try backend.saveToPooledBuffer(format: format, options: options) {
+            return encoded.data
+        }
 
-        case .tiff:
-            let compression = Int32(options.compression ?? 0)
+        var buffer: UnsafeMutableRawPointer?
+        var bufferSize: Int = 0
 
-            let result = swift_vips_tiffsave(pointer, path, compression)
-            guard result == 0 else {
-                throw HokusaiError.saveFailed(VipsBackend.getLastError())
-            }
+        let result: Int32 = try backend.withMetadataPolicy(options.metadata) { pointer, keep in
+            switch format {
+            case .jpeg:
+                let quality = Int32(options.quality ?? 85)
+                return swift_vips_jpegsave_buffer(pointer, &buffer, &bufferSize, quality, keep)
 
-        case .avif:
-            let quality = Int32(options.quality ?? 80)
-            let lossless = options.lossless ? 1 : 0
-            let effort = Int32(options.effort ?? 4)
+            case .png:
+                let compression = Int32(options.compression ?? 6)
+                return swift_vips_pngsave_buffer(pointer, &buffer, &bufferSize, compression, keep)
 
-            let result = swift_vips_heifsave(pointer, path, quality, Int32(lossless), effort)
-            guard result == 0 else {
-                throw HokusaiError.saveFailed(VipsBackend.getLastError())
-            }
+            case .webp:
+                let quality = Int32(options.quality ?? 80)
+                let lossless = options.lossless ? 1 : 0
+                return swift_vips_webpsave_buffer(pointer, &buffer, &bufferSize, quality, Int32(lossless), keep)
 
-        case .heif:
-            let quality = Int32(options.quality ?? 80)
-            let lossless = 0
-            let effort = Int32(4)
+            case .tiff:
+                return swift_vips_tiffsave_buffer(pointer, &buffer, &bufferSize, keep)
 
-            let result = swift_vips_heifsave(pointer, path, quality, Int32(lossless), effort)
-            guard result == 0 else {
-                throw HokusaiError.saveFailed(VipsBackend.getLastError())
-            }
+            case .avif, .heif:
+                let quality = Int32(options.quality ?? 80)
+                return swift_vips_heifsave_buffer(pointer, &buffer, &bufferSize, quality, keep)
 
-        case .gif:
-            let result = swift_vips_gifsave(pointer, path)
-            guard result == 0 else {
-                throw HokusaiError.saveFailed(VipsBackend.getLastError())
+            case .gif:
+                return swift_vips_gifsave_buffer(pointer, &buffer, &bufferSize, keep)
+
+            default:
+                throw HokusaiError.unsupportedFormat("Saving to \(format.rawValue) buffer is not yet implemented")
             }
+        }
 
-        default:
-            throw HokusaiError.unsupportedFormat("Saving to \(outputFormat.rawValue) is not yet implemented")
+        guard result == 0, let buf = buffer else {
+            throw VipsBackend.evaluationError { errorMsg in
+                // PURPOSE: Debug: include result code in error
+                HokusaiError.saveFailed(errorMsg.isEmpty ? "result code: \(result)" : errorMsg)
+            }
         }
-    }
 
-    /// PURPOSE: Save image to Data buffer
-    public func toBuffer(options: SaveOptions = SaveOptions()) throws -> Data {
-        let pointer = try ensureVipsBackend().getPointer()
+        let data = Data(bytes: buf, count: bufferSize)
+        g_free(buf)
 
+        return data
+    }
+
+    /// PURPOSE: Encode to memory and hash the bytes as the encoder writes them.
+    /// OUTPUT: Same bytes as `toBuffer(options:)` plus the requested digests.
+    /// CONSTRAINTS: Falls back to one hashing pass over the result on libvips
+    /// releases without target saving for the format.
+    ///
+    /// Example:
+    /// ```swift
+    /// let encoded = try image.toBuffer(options: SaveOptions(format: .webp), hashing: [.sha256])
+    /// response.headers["ETag"] = encoded.digest.etag
+    /// ```
+    public func toBuffer(options: SaveOptions, hashing algorithms: HashAlgorithms) throws -> EncodedOutput {
         guard let format = options.format else {
             throw HokusaiError.invalidOperation("Must specify format when saving to buffer")
         }
+        if let encoded = try ensureVipsBackend().saveToPooledBuffer(format: format, options: options, hashing: algorithms) {
+            return encoded
+        }
 
-        var buffer: UnsafeMutableRawPointer?
-        var bufferSize: Int = 0
+        let data = try toBuffer(options: options)
+        return EncodedOutput(data: data, digest: StreamingDigest.digest(of: data, algorithms: algorithms))
+    }
 
-        let result: Int32
-
-        switch format {
-        case .jpeg:
-            let quality = Int32(options.quality ?? 85)
-            result = swift_vips_jpegsave_buffer(
-                pointer,
-                &buffer,
-                &bufferSize,
-                quality
-            )
-
-        case .png:
-            let compression = Int32(options.compression ?? 6)
-            result = swift_vips_pngsave_buffer(
-                pointer,
-                &buffer,
-                &bufferSize,
-                compression
-            )
-
-        case .webp:
-            let quality = Int32(options.quality ?? 80)
-            let lossless = options.lossless ? 1 : 0
-            result = swift_vips_webpsave_buffer(
-                pointer,
-                &buffer,
-                &bufferSize,
-                quality,
-                Int32(lossless)
-            )
-
-        case .tiff:
-            result = swift_vips_tiffsave_buffer(
-                pointer,
-                &buffer,
-                &bufferSize
-            )
-
-        case .avif, .heif:
-            let quality = Int32(options.quality ?? 80)
-            result = swift_vips_heifsave_buffer(
-                pointer,
-                &buffer,
-                &bufferSize,
-                quality
-            )
-
-        case .gif:
-            result = swift_vips_gifsave_buffer(
-                pointer,
-                &buffer,
-                &bufferSize
-            )
-
-        default:
-            throw HokusaiError.unsupportedFormat("Saving to \(format.rawValue) buffer is not yet implemented")
+    /// PURPOSE: Save to `path` and hash the bytes on their way to disk.
+    /// OUTPUT: Digests of the file contents.
+    /// CONSTRAINTS: Honours the same options as `toFile(_:options:)`; without target
+    /// saving for the format, the written file is read back once to hash it.
+    public func toFile(_ path: String, options: SaveOptions = SaveOptions(), hashing algorithms: HashAlgorithms) throws -> OutputDigest {
+        let format = options.format ?? ImageFormat.from(fileExtension: (path as NSString).pathExtension)
+        guard let outputFormat = format else {
+            throw HokusaiError.unsupportedFormat("Could not determine format from path: \(path)")
         }
 
-        guard result == 0, let buf = buffer else {
-            let errorMsg = VipsBackend.getLastError()
-            // PURPOSE: Debug: include result code in error
-            let debugMsg = errorMsg.isEmpty ? "result code: \(result)" : errorMsg
-            throw HokusaiError.saveFailed(debugMsg)
+        let descriptor = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0o644)
+        guard descriptor >= 0 else {
+            throw HokusaiError.saveFailed("open \(path): \(String(cString: strerror(errno)))")
         }
 
-        let data = Data(bytes: buf, count: bufferSize)
-        g_free(buf)
+        let sink = FileEncodeSink(descriptor: descriptor, hashing: algorithms)
+        let streamed: Bool
+        do {
+            streamed = try ensureVipsBackend().saveToTarget(sink, format: outputFormat, options: options, honoringFileOptions: true)
+        } catch {
+            close(descriptor)
+            if sink.failure != 0 {
+                throw HokusaiError.saveFailed("write \(path): \(String(cString: strerror(sink.failure)))")
+            }
+            throw error
+        }
+        close(descriptor)
 
-        return data
+        if streamed {
+            return sink.digest.finish()
+        }
+        try toFile(path, options: options)
+        return StreamingDigest.digest(of: try Data(contentsOf: URL(fileURLWithPath: path)), algorithms: algorithms)
     }
 
     /// PURPOSE: Convenience method to save as JPEG
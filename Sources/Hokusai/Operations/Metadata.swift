@@ -0,0 +1,85 @@
+import Foundation
+
+extension HokusaiImage {
+    /// PURPOSE: EXIF orientation (1–8); 1 when the header carries none.
+    /// CONSTRAINTS: Reads one integer field; nothing else is converted.
+    public var orientation: Int {
+        get throws {
+            return try ensureVipsBackend().intField("orientation") ?? 1
+        }
+    }
+
+    /// PURPOSE: Read a single EXIF tag.
+    /// INPUT: `tag` is a tag name (`"Model"`, `"DateTimeOriginal"`) searched across
+    /// IFDs, or a full libvips field name (`"exif-ifd2-ExposureTime"`).
+    /// OUTPUT: The tag's value without libvips' `(description, type, size)` suffix; nil if absent.
+    ///
+    /// Example:
+    /// ```swift
+    /// let camera = try image.exif(tag: "Model")
+    /// ```
+    public func exif(tag: String) throws -> String? {
+        let backend = try ensureVipsBackend()
+        let names = tag.hasPrefix("exif-") ? [tag] : (0...4).map { "exif-ifd\($0)-\(tag)" }
+        for name in names {
+            if let raw = try backend.stringField(name) {
+                return Self.exifValue(raw)
+            }
+        }
+        return nil
+    }
+
+    /// PURPOSE: Embedded ICC profile bytes, without copying them out of the image header.
+    /// OUTPUT: nil when no profile is attached. The returned `Data` keeps the image alive.
+    public func iccProfile() throws -> Data? {
+        return try ensureVipsBackend().blobField("icc-profile-data")
+    }
+
+    /// PURPOSE: Embedded XMP packet as text; nil when absent.
+    public func xmp() throws -> String? {
+        guard let data = try ensureVipsBackend().blobField("xmp-data") else {
+            return nil
+        }
+        // PURPOSE: Some writers include the trailing NUL in the blob.
+        return String(decoding: data.prefix { $0 != 0 }, as: UTF8.self)
+    }
+
+    /// PURPOSE: String values for header fields whose names match a glob pattern.
+    /// INPUT: `pattern` uses `fnmatch` syntax, e.g. `"exif-ifd0-*"` or `"*-profile-*"`.
+    /// CONSTRAINTS: Only matching fields are converted, unlike `extendedMetadata()`.
+    ///
+    /// Example:
+    /// ```swift
+    /// let gps = try image.fields(matching: "exif-ifd3-*")
+    /// ```
+    public func fields(matching pattern: String) throws -> [String: String] {
+        let backend = try ensureVipsBackend()
+        var fields: [String: String] = [:]
+        for name in try backend.fieldNames() where fnmatch(pattern, name, 0) == 0 {
+            fields[name] = try backend.fieldDescription(name)
+        }
+        return fields
+    }
+
+    // MARK: - Helpers
+
+    /// PURPOSE: Drop libvips' `" (<readable>, <type>, N components, N bytes)"` suffix.
+    /// ALGORITHM: Strip the fixed type/size tail, leaving `"<value> (<readable>"`; when the
+    /// two halves are equal (ASCII tags) either will do, otherwise split at the first `" ("`.
+    static func exifValue(_ raw: String) -> String {
+        guard let tail = raw.range(of: #", [^,]+, \d+ components?, \d+ bytes?\)$"#, options: .regularExpression) else {
+            return raw
+        }
+        let head = raw[..<tail.lowerBound]
+        let half = (head.count - 2) / 2
+        if head.count >= 2, head.count % 2 == 0,
+           head.prefix(half) == head.suffix(half),
+           head.dropFirst(half).hasPrefix(" (") {
+            return String(head.prefix(half))
+        }
+        guard let split = head.range(of: " (") else {
+            return String(head)
+        }
+        return String(head[..<split.lowerBound])
+    }
+}
@@ -0,0 +1,328 @@
+import Foundation
+import CVips
+
+extension Hokusai {
+    /// PURPOSE: Grid of thumbnails built as one libvips `arrayjoin`.
+    /// ALGORITHM:
+    /// - Inputs are thumbnailed in parallel with shrink-on-load to fit `cellSize`.
+    /// - Each thumbnail is normalised to sRGB RGBA, then all are joined in one
+    ///   operation, centred in `cellSize` cells with `spacing` between them.
+    /// CONSTRAINTS: The pipeline depth stays constant however many inputs there are.
+    ///
+    /// Example:
+    /// ```swift
+    /// let sheet = try Hokusai.contactSheet(images: paths.map(ImageInput.file), columns: 6, cellSize: 240)
+    /// try sheet.toFile("sheet.jpg")
+    /// ```
+    public static func contactSheet(
+        images: [ImageInput],
+        columns: Int,
+        cellSize: Int,
+        spacing: Int = 8,
+        background: [Double] = [255, 255, 255, 255]
+    ) throws -> HokusaiImage {
+        guard !images.isEmpty else {
+            throw HokusaiError.invalidOperation("contactSheet needs at least one image")
+        }
+        guard columns > 0, cellSize > 0, spacing >= 0 else {
+            throw HokusaiError.invalidOperation("columns and cellSize must be positive")
+        }
+
+        let cells = try Montage.loadThumbnails(images, width: cellSize, height: cellSize)
+        let pointers = try cells.map { try $0.getVipsPointer() }
+
+        let fill = background.count == 4 ? background : Array(background.prefix(3)) + [255]
+        guard let backgroundArray = fill.withUnsafeBufferPointer({ swift_vips_array_double_new($0.baseAddress, Int32(fill.count)) }) else {
+            throw HokusaiError.vipsError("Failed to create background array")
+        }
+        defer {
+            vips_area_unref(UnsafeMutablePointer(mutating: UnsafeRawPointer(backgroundArray).assumingMemoryBound(to: VipsArea.self)))
+        }
+
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        var inputs: [UnsafeMutablePointer<CVips.VipsImage>?] = pointers
+        let result = inputs.withUnsafeMutableBufferPointer { buffer in
+            swift_vips_arrayjoin(
+                buffer.baseAddress,
+                &output,
+                Int32(buffer.count),
+                Int32(min(columns, buffer.count)),
+                Int32(spacing),
+                Int32(cellSize),
+                Int32(cellSize),
+                backgroundArray
+            )
+        }
+        guard result == 0, let out = output else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return withExtendedLifetime(cells) {
+            HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
+        }
+    }
+
+    /// PURPOSE: Pack inputs into one transparent atlas with a JSON coordinate map.
+    /// ALGORITHM:
+    /// - Inputs are decoded in parallel with shrink-on-load; sprites larger than
+    ///   `maxSize` are scaled down to fit.
+    /// - Skyline bottom-left packing, tallest first, at the narrowest power-of-two
+    ///   width that holds the total area.
+    /// - Sprites are placed with n-ary `composite` calls of up to 63 overlays each.
+    /// INPUT: `names`: one unique frame name per input. When nil, file inputs use their
+    /// file stem and buffers use `image-<index>`; a repeated name gets `-<index>` appended.
+    /// CONSTRAINTS: Throws when the packed height would exceed `maxSize`.
+    ///
+    /// Example:
+    /// ```swift
+    /// let atlas = try Hokusai.spriteAtlas(images: icons.map(ImageInput.file), maxSize: 2048)
+    /// try atlas.image.toFile("icons.png")
+    /// try atlas.jsonMap().write(to: URL(fileURLWithPath: "icons.json"))
+    /// ```
+    public static func spriteAtlas(
+        images: [ImageInput],
+        names: [String]? = nil,
+        maxSize: Int = 2048,
+        padding: Int = 1
+    ) throws -> SpriteAtlas {
+        guard !images.isEmpty else {
+            throw HokusaiError.invalidOperation("spriteAtlas needs at least one image")
+        }
+        guard maxSize > 0, padding >= 0 else {
+            throw HokusaiError.invalidOperation("maxSize must be positive")
+        }
+        let frameNames = try Montage.frameNames(for: images, names: names)
+
+        let sprites = try Montage.loadThumbnails(images, width: maxSize, height: maxSize)
+        let sizes = try sprites.map { (width: try $0.width + padding, height: try $0.height + padding) }
+
+        let area = sizes.reduce(0) { $0 + $1.width * $1.height }
+        let widest = sizes.map(\.width).max() ?? 1
+        var atlasWidth = 64
+        while atlasWidth * atlasWidth < area { atlasWidth <<= 1 }
+        atlasWidth = min(maxSize, max(atlasWidth, widest))
+
+        var packer = SkylinePacker(width: atlasWidth)
+        var positions = [(x: Int, y: Int)](repeating: (0, 0), count: sprites.count)
+        for index in sizes.indices.sorted(by: { sizes[$0].height > sizes[$1].height }) {
+            guard let position = packer.insert(width: sizes[index].width, height: sizes[index].height) else {
+                throw HokusaiError.invalidOperation("sprite \(images[index].displayName) is wider than the atlas")
+            }
+            positions[index] = position
+        }
+        let atlasHeight = packer.height
+        guard atlasHeight <= maxSize else {
+            throw HokusaiError.invalidOperation("sprites need \(atlasWidth)x\(atlasHeight), larger than maxSize \(maxSize)")
+        }
+
+        var canvas: UnsafeMutablePointer<CVips.VipsImage>?
+        guard swift_vips_canvas_rgba(&canvas, Int32(atlasWidth), Int32(atlasHeight)) == 0, var base = canvas else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+
+        // PURPOSE: libvips composite accepts at most 64 inputs; chain groups of 63 overlays.
+        let pointers = try sprites.map { try $0.getVipsPointer() }
+        for start in stride(from: 0, to: pointers.count, by: 63) {
+            let group = start..<min(start + 63, pointers.count)
+            var inputs: [UnsafeMutablePointer<CVips.VipsImage>?] = [base] + pointers[group].map { Optional($0) }
+            let xs = group.map { Int32(positions[$0].x) }
+            let ys = group.map { Int32(positions[$0].y) }
+
+            var output: UnsafeMutablePointer<CVips.VipsImage>?
+            let result = inputs.withUnsafeMutableBufferPointer { buffer in
+                swift_vips_composite_at(buffer.baseAddress, &output, Int32(buffer.count), xs, ys)
+            }
+            g_object_unref(base)
+            guard result == 0, let out = output else {
+                throw HokusaiError.vipsError(VipsBackend.getLastError())
+            }
+            base = out
+        }
+
+        let frames = sprites.indices.map { index in
+            SpriteFrame(
+                name: frameNames[index],
+                x: positions[index].x,
+                y: positions[index].y,
+                width: sizes[index].width - padding,
+                height: sizes[index].height - padding
+            )
+        }
+        let image = withExtendedLifetime(sprites) {
+            HokusaiImage(backend: .vips(VipsBackend(takingOwnership: base)))
+        }
+        return SpriteAtlas(image: image, width: atlasWidth, height: atlasHeight, frames: frames)
+    }
+}
+
+/// PURPOSE: Shared loading for contact sheets and sprite atlases.
+enum Montage {
+    /// PURPOSE: Thumbnail every input concurrently as in-memory sRGB RGBA images, in input order.
+    /// OUTPUT: Throws the first failure, naming the input.
+    static func loadThumbnails(_ inputs: [ImageInput], width: Int, height: Int) throws -> [HokusaiImage] {
+        let slots = ThumbnailSlots(count: inputs.count)
+        DispatchQueue.concurrentPerform(iterations: inputs.count) { index in
+            do {
+                let thumbnail = try inputs[index].thumbnail(width: width, height: height)
+                slots.set(index, .success(try rgba(thumbnail)))
+            } catch {
+                slots.set(index, .failure(error))
+            }
+        }
+
+        return try slots.values.enumerated().map { index, result in
+            do {
+                return try result.get()
+            } catch {
+                throw HokusaiError.loadFailed("\(inputs[index].displayName): \(error)")
+            }
+        }
+    }
+
+    /// PURPOSE: Unique sprite names: the caller's, or derived from the inputs.
+    static func frameNames(for inputs: [ImageInput], names: [String]?) throws -> [String] {
+        if let names {
+            guard names.count == inputs.count else {
+                throw HokusaiError.invalidOperation("spriteAtlas got \(names.count) names for \(inputs.count) images")
+            }
+            guard Set(names).count == names.count else {
+                throw HokusaiError.invalidOperation("spriteAtlas names must be unique")
+            }
+            return names
+        }
+
+        let derived = inputs.enumerated().map { index, input -> String in
+            if case .data = input {
+                return "image-\(index)"
+            }
+            return input.displayName
+        }
+        let counts = Dictionary(derived.map { ($0, 1) }, uniquingKeysWith: +)
+        return derived.enumerated().map { index, name in
+            counts[name, default: 0] > 1 ? "\(name)-\(index)" : name
+        }
+    }
+
+    /// PURPOSE: sRGB with alpha, so mixed inputs join without band or colour-space surprises.
+    /// ALGORITHM: `vips_thumbnail` already imports embedded profiles and exports sRGB, so an
+    /// sRGB thumbnail is used as is; only other spaces (grey, 16-bit) are converted.
+    static func rgba(_ image: HokusaiImage) throws -> HokusaiImage {
+        let pointer = try image.getVipsPointer()
+        let srgb: UnsafeMutablePointer<CVips.VipsImage>
+        if swift_vips_image_get_interpretation(pointer) == Int32(VIPS_INTERPRETATION_sRGB.rawValue) {
+            g_object_ref(pointer)
+            srgb = pointer
+        } else {
+            srgb = try ColorManagement.transform(pointer, to: .sRGB, intent: .relative, inputProfile: nil)
+        }
+        guard vips_image_get_bands(srgb) == 3 else {
+            return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: srgb)))
+        }
+
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        let result = swift_vips_addalpha(srgb, &output)
+        g_object_unref(srgb)
+        guard result == 0, let out = output else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
+    }
+}
+
+/// PURPOSE: Skyline bottom-left rectangle packer for a fixed-width bin.
+/// ALGORITHM: The skyline is a left-to-right list of segments; each insert takes the
+/// lowest position (then leftmost) where the rectangle fits, raises the skyline there,
+/// and merges neighbouring segments of equal height.
+struct SkylinePacker {
+    private struct Segment {
+        var x: Int
+        var y: Int
+        var width: Int
+    }
+
+    let width: Int
+    private(set) var height = 0
+    private var skyline: [Segment]
+
+    init(width: Int) {
+        self.width = width
+        self.skyline = [Segment(x: 0, y: 0, width: width)]
+    }
+
+    /// OUTPUT: Top-left corner, or nil when `width` exceeds the bin.
+    mutating func insert(width rectWidth: Int, height rectHeight: Int) -> (x: Int, y: Int)? {
+        var best: (index: Int, y: Int)?
+        for index in skyline.indices {
+            guard let y = fit(at: index, width: rectWidth) else { continue }
+            if best == nil || y < best!.y {
+                best = (index, y)
+            }
+        }
+        guard let best else { return nil }
+
+        let x = skyline[best.index].x
+        skyline.insert(Segment(x: x, y: best.y + rectHeight, width: rectWidth), at: best.index)
+
+        // PURPOSE: Trim the segments now covered by the new one.
+        let end = x + rectWidth
+        let next = best.index + 1
+        while next < skyline.count, skyline[next].x < end {
+            let overlap = end - skyline[next].x
+            if overlap >= skyline[next].width {
+                skyline.remove(at: next)
+            } else {
+                skyline[next].x += overlap
+                skyline[next].width -= overlap
+                break
+            }
+        }
+
+        var index = 0
+        while index + 1 < skyline.count {
+            if skyline[index].y == skyline[index + 1].y {
+                skyline[index].width += skyline[index + 1].width
+                skyline.remove(at: index + 1)
+            } else {
+                index += 1
+            }
+        }
+
+        height = max(height, best.y + rectHeight)
+        return (x, best.y)
+    }
+
+    /// PURPOSE: Lowest y at which a rectangle starting at segment `index` clears the skyline.
+    private func fit(at index: Int, width rectWidth: Int) -> Int? {
+        guard skyline[index].x + rectWidth <= width else { return nil }
+        var remaining = rectWidth
+        var y = 0
+        var cursor = index
+        while remaining > 0 {
+            y = max(y, skyline[cursor].y)
+            remaining -= skyline[cursor].width
+            cursor += 1
+        }
+        return y
+    }
+}
+
+/// PURPOSE: Lock-guarded per-index results filled from concurrent workers.
+private final class ThumbnailSlots: @unchecked Sendable {
+    private let lock = NSLock()
+    private var slots: [Result<HokusaiImage, Error>?]
+
+    init(count: Int) {
+        slots = Array(repeating: nil, count: count)
+    }
+
+    func set(_ index: Int, _ result: Result<HokusaiImage, Error>) {
+        lock.lock()
+        slots[index] = result
+        lock.unlock()
+    }
+
+    var values: [Result<HokusaiImage, Error>] {
+        lock.lock()
+        defer { lock.unlock() }
+        return slots.map { $0 ?? .failure(HokusaiError.invalidOperation("thumbnail not produced")) }
+    }
+}
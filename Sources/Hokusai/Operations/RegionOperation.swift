@@ -0,0 +1,301 @@
+import Foundation
+import CVips
+
+/// PURPOSE: C kernel for a custom operation: fill `pair.out` from `pair.in`, return 0 on success.
+/// CONSTRAINTS: Called concurrently from libvips worker threads; must not retain the pointers.
+public typealias RegionKernel = @convention(c) (UnsafePointer<SwiftVipsRegionPair>?, UnsafeMutableRawPointer?) -> Int32
+
+/// PURPOSE: Sample type of a custom operation's output.
+public enum PixelFormat: String, Codable, Sendable {
+    case uchar
+    case ushort
+    case float
+
+    var vipsFormat: Int32 {
+        switch self {
+        case .uchar: return Int32(VIPS_FORMAT_UCHAR.rawValue)
+        case .ushort: return Int32(VIPS_FORMAT_USHORT.rawValue)
+        case .float: return Int32(VIPS_FORMAT_FLOAT.rawValue)
+        }
+    }
+}
+
+/// PURPOSE: Input and output pixels of one region, lent to a Swift `RegionOperation` body.
+/// CONSTRAINTS: Both buffers are only valid during the call.
+public struct RegionPixels {
+    /// PURPOSE: Input pixels for exactly the output rectangle
+    public let input: TileRegion
+
+    /// PURPOSE: First byte of output pixel (`input.left`, `input.top`)
+    public let output: UnsafeMutableRawPointer
+    public let outputStride: Int
+    public let outputBands: Int
+    public let outputBytesPerPixel: Int
+
+    /// PURPOSE: Writable pixels of output row `y` (0 = the region's top row)
+    public func outputRow(_ y: Int) -> UnsafeMutableRawBufferPointer {
+        precondition(y >= 0 && y < input.height, "row \(y) is outside the region")
+        return UnsafeMutableRawBufferPointer(start: output + y * outputStride, count: input.width * outputBytesPerPixel)
+    }
+}
+
+/// PURPOSE: Custom per-pixel (or per-region) operation that runs inside libvips' thread
+/// pool and composes lazily with native operations.
+/// ALGORITHM:
+/// - The output image has the input's geometry; libvips asks for output regions on
+///   demand, prepares the matching input region, and hands both to the kernel.
+/// - Kernels are either `@convention(c)` functions with a caller-owned context, or
+///   Swift closures (reached through one shared C trampoline).
+/// - Operations registered by name can be used from recipes as `.custom(name)`.
+/// CONSTRAINTS: Kernels run concurrently on arbitrary threads and must be thread-safe.
+///
+/// Example:
+/// ```swift
+/// let invert = RegionOperation(name: "invert") { pixels in
+///     for y in 0..<pixels.input.height {
+///         let source = pixels.input.row(y)
+///         let target = pixels.outputRow(y)
+///         for i in 0..<source.count { target[i] = 255 - source[i] }
+///     }
+/// }
+/// RegionOperation.register(invert)
+/// let negative = try image.apply(invert)   // or ProcessingStep.custom("invert")
+/// ```
+public struct RegionOperation: @unchecked Sendable {
+    enum Kernel {
+        case c(RegionKernel, context: UnsafeMutableRawPointer?)
+        case swift(@Sendable (RegionPixels) throws -> Void)
+    }
+
+    public let name: String
+
+    /// PURPOSE: Output band count; nil keeps the input's
+    public let outputBands: Int?
+
+    /// PURPOSE: Output sample type; nil keeps the input's
+    public let outputFormat: PixelFormat?
+
+    let kernel: Kernel
+
+    /// PURPOSE: Operation backed by a C kernel; `context` is passed through unowned.
+    public init(
+        name: String,
+        outputBands: Int? = nil,
+        outputFormat: PixelFormat? = nil,
+        kernel: RegionKernel,
+        context: UnsafeMutableRawPointer? = nil
+    ) {
+        self.name = name
+        self.outputBands = outputBands
+        self.outputFormat = outputFormat
+        self.kernel = .c(kernel, context: context)
+    }
+
+    /// PURPOSE: Operation backed by a Swift closure; a thrown error fails the pipeline and
+    /// is rethrown by the call that evaluated it (encode, `forEachTile`, materialize).
+    public init(
+        name: String,
+        outputBands: Int? = nil,
+        outputFormat: PixelFormat? = nil,
+        _ body: @escaping @Sendable (RegionPixels) throws -> Void
+    ) {
+        self.name = name
+        self.outputBands = outputBands
+        self.outputFormat = outputFormat
+        self.kernel = .swift(body)
+    }
+
+    // MARK: - Registry
+
+    /// PURPOSE: Make `operation` available by name (replacing any earlier one).
+    public static func register(_ operation: RegionOperation) {
+        RegionOperationRegistry.shared.insert(operation)
+    }
+
+    public static func registered(named name: String) -> RegionOperation? {
+        return RegionOperationRegistry.shared.operation(named: name)
+    }
+}
+
+/// PURPOSE: Process-wide name → operation table.
+/// CONSTRAINTS: Thread-safe.
+private final class RegionOperationRegistry: @unchecked Sendable {
+    static let shared = RegionOperationRegistry()
+
+    private let lock = NSLock()
+    private var operations: [String: RegionOperation] = [:]
+
+    func insert(_ operation: RegionOperation) {
+        lock.lock()
+        defer { lock.unlock() }
+        operations[operation.name] = operation
+    }
+
+    func operation(named name: String) -> RegionOperation? {
+        lock.lock()
+        defer { lock.unlock() }
+        return operations[name]
+    }
+}
+
+extension HokusaiImage {
+    /// PURPOSE: Append a custom region operation to the lazy pipeline.
+    /// OUTPUT: Nothing is computed until the result is encoded, sunk, or materialized;
+    /// kernels then run on libvips' workers, one region at a time.
+    public func apply(_ operation: RegionOperation) throws -> HokusaiImage {
+        if let bands = operation.outputBands, bands <= 0 {
+            throw HokusaiError.invalidOperation("outputBands must be positive")
+        }
+        let pointer = try ensureVipsBackend().getPointer()
+        let bands = Int32(operation.outputBands ?? 0)
+        let format = operation.outputFormat?.vipsFormat ?? -1
+
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        let result: Int32
+        switch operation.kernel {
+        case .c(let kernel, let context):
+            result = swift_vips_region_op(pointer, &output, operation.name, bands, format, kernel, context, nil)
+
+        case .swift(let body):
+            let context = Unmanaged.passRetained(RegionClosure(name: operation.name, body)).toOpaque()
+            result = swift_vips_region_op(pointer, &output, operation.name, bands, format, { pair, context in
+                guard let pair, let context else { return -1 }
+                let closure = Unmanaged<RegionClosure>.fromOpaque(context).takeUnretainedValue()
+                return closure.run(pair.pointee)
+            }, context, { context in
+                guard let context else { return }
+                Unmanaged<RegionClosure>.fromOpaque(context).release()
+            })
+        }
+
+        guard result == 0, let out = output else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
+    }
+
+    /// PURPOSE: Apply an operation previously passed to `RegionOperation.register`.
+    public func apply(operation name: String) throws -> HokusaiImage {
+        guard let operation = RegionOperation.registered(named: name) else {
+            throw HokusaiError.invalidOperation("no region operation registered as \"\(name)\"")
+        }
+        return try apply(operation)
+    }
+}
+
+/// PURPOSE: Owns a Swift kernel for as long as the output image that calls it.
+/// CONSTRAINTS: Only the first error of a failing evaluation is kept; regions failing
+/// after it report the same one.
+private final class RegionClosure: @unchecked Sendable {
+    private let name: String
+    private let body: @Sendable (RegionPixels) throws -> Void
+    private let lock = NSLock()
+    private var pendingFailure: Int?
+
+    init(name: String, _ body: @escaping @Sendable (RegionPixels) throws -> Void) {
+        self.name = name
+        self.body = body
+    }
+
+    deinit {
+        if let pendingFailure {
+            RegionFailures.shared.discard(pendingFailure)
+        }
+    }
+
+    func run(_ pair: SwiftVipsRegionPair) -> Int32 {
+        guard let input = pair.in, let output = pair.out else { return -1 }
+        let pixels = RegionPixels(
+            input: TileRegion(
+                left: Int(pair.left),
+                top: Int(pair.top),
+                width: Int(pair.width),
+                height: Int(pair.height),
+                bands: Int(pair.in_bands),
+                bytesPerPixel: Int(pair.in_sizeof_pel),
+                stride: Int(pair.in_stride),
+                baseAddress: input
+            ),
+            output: output,
+            outputStride: Int(pair.out_stride),
+            outputBands: Int(pair.out_bands),
+            outputBytesPerPixel: Int(pair.out_sizeof_pel)
+        )
+        do {
+            try body(pixels)
+            return 0
+        } catch {
+            fail(error)
+            return -1
+        }
+    }
+
+    /// PURPOSE: Store `error` unless this evaluation already failed, and tag the libvips error with it.
+    private func fail(_ error: Error) {
+        lock.lock()
+        defer { lock.unlock() }
+        let id: Int
+        if let pending = pendingFailure, RegionFailures.shared.isPending(pending) {
+            id = pending
+        } else {
+            id = RegionFailures.shared.store(error)
+            pendingFailure = id
+        }
+        swift_vips_error(name, RegionFailures.shared.tag(id))
+    }
+}
+
+/// PURPOSE: Swift errors thrown by region kernels, held until the evaluating call rethrows them.
+/// ALGORITHM:
+/// - A failing kernel stores its error under a fresh id and writes `tag(id)` into the
+///   libvips error buffer, which libvips hands back to whoever evaluated the image.
+/// - `VipsBackend.evaluationError` finds the tag in that message and takes the error.
+/// CONSTRAINTS: Thread-safe; an error never taken is dropped when its operation closes.
+final class RegionFailures: @unchecked Sendable {
+    static let shared = RegionFailures()
+
+    private let lock = NSLock()
+    private var errors: [Int: Error] = [:]
+    private var nextID = 0
+    private let marker = "hokusai-region-error#"
+
+    func tag(_ id: Int) -> String {
+        return "\(marker)\(id)"
+    }
+
+    func store(_ error: Error) -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        nextID += 1
+        errors[nextID] = error
+        return nextID
+    }
+
+    func isPending(_ id: Int) -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return errors[id] != nil
+    }
+
+    func discard(_ id: Int) {
+        lock.lock()
+        defer { lock.unlock() }
+        errors[id] = nil
+    }
+
+    /// PURPOSE: Remove every error tagged in `message`; returns the earliest one.
+    func take(from message: String) -> Error? {
+        let ids = message.components(separatedBy: marker).dropFirst().compactMap { Int($0.prefix { $0.isNumber }) }
+        guard !ids.isEmpty else { return nil }
+
+        lock.lock()
+        defer { lock.unlock() }
+        var first: Error?
+        for id in ids.sorted() {
+            if let error = errors.removeValue(forKey: id), first == nil {
+                first = error
+            }
+        }
+        return first
+    }
+}
@@ -5,7 +5,7 @@ extension HokusaiImage {
     /// PURPOSE: Resize image using libvips with fit and kernel controls.
     /// INPUT:
     /// - `width`/`height`: optional target bounds.
-    /// - `options`: fit, kernel, and constraint flags.
+    /// - `options`: fit, kernel, constraint flags, and optional post-resize sharpening.
     /// OUTPUT: New resized image instance.
     /// AI HINTS:
     /// - Keep geometry math deterministic.
@@ -26,7 +26,7 @@ extension HokusaiImage {
         }
 
         // PURPOSE: Calculate target dimensions based on fit mode
-        let (finalWidth, finalHeight) = try calculateDimensions(
+        let (finalWidth, finalHeight) = try Self.calculateDimensions(
             currentWidth: currentWidth,
             currentHeight: currentHeight,
             targetWidth: targetWidth,
@@ -48,10 +48,22 @@ extension HokusaiImage {
         // PURPOSE: Perform resize
         let result = swift_vips_resize(pointer, &output, hscale, vscale, vipsKernel)
 
-        guard result == 0, let out = output else {
+        guard result == 0, var out = output else {
             throw HokusaiError.vipsError(VipsBackend.getLastError())
         }
 
+        // PURPOSE: Sharpen before cover/contain so padding edges are not ringed; the
+        // convolution joins the same lazy pipeline and runs per tile with the resize.
+        if let sharpen = options.sharpen?.parameters(reduction: 1 / min(hscale, vscale)) {
+            var sharpened: UnsafeMutablePointer<CVips.VipsImage>?
+            let sharpenResult = swift_vips_sharpen(out, &sharpened, sharpen.sigma, sharpen.m1, sharpen.m2)
+            g_object_unref(out)
+            guard sharpenResult == 0, let sharp = sharpened else {
+                throw HokusaiError.vipsError(VipsBackend.getLastError())
+            }
+            out = sharp
+        }
+
         let resized = HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
 
         // PURPOSE: Handle fit modes that require cropping or embedding
@@ -104,7 +116,8 @@ extension HokusaiImage {
 
     // MARK: - Private Helpers
 
-    private func calculateDimensions(
+    /// PURPOSE: Shared with the cost estimator so planned and executed geometry agree.
+    static func calculateDimensions(
         currentWidth: Int,
         currentHeight: Int,
         targetWidth: Int?,
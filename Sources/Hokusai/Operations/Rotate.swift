@@ -64,6 +64,60 @@ extension HokusaiImage {
         }
     }
 
+    /// PURPOSE: Rotate, optionally cropping to the largest axis-aligned rectangle
+    /// that contains only image pixels (straighten tools).
+    /// ALGORITHM:
+    /// - The inscribed rectangle is solved in closed form from the angle and the
+    ///   source aspect ratio, centred on the rotated image centre.
+    /// - It becomes the `outputArea` of a single affine resample, so the background
+    ///   corners are never interpolated or allocated.
+    /// CONSTRAINTS: Multiples of 90° have no corners and fall back to `rotate(angle:background:)`.
+    ///
+    /// Example:
+    /// ```swift
+    /// let straightened = try photo.rotate(angle: .custom(-2.5), cropToContent: true)
+    /// ```
+    public func rotate(angle: RotationAngle, cropToContent: Bool, background: [Double]? = nil) throws -> HokusaiImage {
+        let degrees = angle.degrees
+        guard cropToContent, degrees.truncatingRemainder(dividingBy: 90) != 0 else {
+            return try rotate(angle: angle, background: background)
+        }
+
+        let width = try self.width
+        let height = try self.height
+        let rotation = AffineTransform.rotation(degrees: degrees)
+        let inscribed = Self.largestInscribedRectangle(width: Double(width), height: Double(height), degrees: degrees)
+        let center = rotation.apply(x: Double(width) / 2, y: Double(height) / 2)
+
+        let area = OutputArea(
+            left: Int((center.x - inscribed.width / 2).rounded(.up)),
+            top: Int((center.y - inscribed.height / 2).rounded(.up)),
+            width: max(1, Int(inscribed.width.rounded(.down))),
+            height: max(1, Int(inscribed.height.rounded(.down)))
+        )
+        return try transform(affine: rotation, outputArea: area, background: background)
+    }
+
+    /// PURPOSE: Largest axis-aligned rectangle inside a `width` x `height` rectangle rotated by `degrees`.
+    /// ALGORITHM: When the short side is small relative to the long side, the rectangle
+    /// touches both long edges (half-constrained); otherwise it touches all four edges.
+    static func largestInscribedRectangle(width: Double, height: Double, degrees: Double) -> (width: Double, height: Double) {
+        guard width > 0, height > 0 else { return (0, 0) }
+        let radians = degrees * .pi / 180
+        let sinA = abs(sin(radians))
+        let cosA = abs(cos(radians))
+        let widthIsLonger = width >= height
+        let long = widthIsLonger ? width : height
+        let short = widthIsLonger ? height : width
+
+        if short <= 2 * sinA * cosA * long || abs(sinA - cosA) < 1e-10 {
+            let half = short / 2
+            return widthIsLonger ? (half / sinA, half / cosA) : (half / cosA, half / sinA)
+        }
+        let cos2A = cosA * cosA - sinA * sinA
+        return ((width * cosA - height * sinA) / cos2A, (height * cosA - width * sinA) / cos2A)
+    }
+
     /// PURPOSE: Rotate image by 90 degrees clockwise
     public func rotate90() throws -> HokusaiImage {
         return try rotate(angle: .degree90)
@@ -0,0 +1,139 @@
+import Foundation
+import CVips
+
+/// PURPOSE: Read-only view of one computed tile, lent to a `forEachTile` callback.
+/// CONSTRAINTS: The pixels belong to libvips and are only valid inside the callback;
+/// copy anything that must outlive it.
+public struct TileRegion {
+    public let left: Int
+    public let top: Int
+    public let width: Int
+    public let height: Int
+    public let bands: Int
+
+    /// PURPOSE: Bytes per pixel across all bands
+    public let bytesPerPixel: Int
+
+    /// PURPOSE: Bytes between the starts of consecutive rows (can exceed `width * bytesPerPixel`)
+    public let stride: Int
+
+    /// PURPOSE: First byte of pixel (`left`, `top`)
+    public let baseAddress: UnsafeRawPointer
+
+    /// PURPOSE: Pixels of row `y` (0 = the tile's top row), without padding
+    public func row(_ y: Int) -> UnsafeRawBufferPointer {
+        precondition(y >= 0 && y < height, "row \(y) is outside the tile")
+        return UnsafeRawBufferPointer(start: baseAddress + y * stride, count: width * bytesPerPixel)
+    }
+}
+
+extension HokusaiImage {
+    /// PURPOSE: Stream the image through `body` tile by tile, in parallel, without materializing it.
+    /// ALGORITHM:
+    /// - `vips_sink_tile` computes tiles on libvips' worker threads and each prepared
+    ///   region is handed to `body` in place (no copy).
+    /// - Images fed by a sequential-access load get full-width strips, so demand on
+    ///   the decoder stays top to bottom.
+    /// - `concurrency` sets the sink's libvips thread count for this call only; nil
+    ///   leaves libvips' default. libvips builds without per-image concurrency fall
+    ///   back to capping simultaneous `body` calls.
+    /// - The first error thrown by `body` stops the sink and is rethrown.
+    /// CONSTRAINTS: `body` runs concurrently and in no guaranteed order; regions are borrowed.
+    ///
+    /// Example:
+    /// ```swift
+    /// let histogram = LockedHistogram()
+    /// try image.forEachTile(size: 256) { tile in
+    ///     for y in 0..<tile.height { histogram.add(tile.row(y)) }
+    /// }
+    /// ```
+    public func forEachTile(
+        size: Int = 128,
+        concurrency: Int? = nil,
+        _ body: @Sendable (TileRegion) throws -> Void
+    ) throws {
+        guard size > 0, concurrency.map({ $0 > 0 }) ?? true else {
+            throw HokusaiError.invalidOperation("tile size and concurrency must be positive")
+        }
+        let limitsThreads = concurrency != nil && swift_vips_has_image_concurrency() != 0
+        let source = try concurrency.map { try limitingConcurrency($0) } ?? self
+        let pointer = try source.ensureVipsBackend().getPointer()
+        let sequential = swift_vips_image_is_sequential(pointer) != 0
+        let tileWidth = sequential ? Int(vips_image_get_width(pointer)) : size
+
+        try withoutActuallyEscaping(body) { body in
+            let sink = TileSink(
+                body: body,
+                bands: Int(vips_image_get_bands(pointer)),
+                bytesPerPixel: Int(swift_vips_image_sizeof_pel(pointer)),
+                callbackLimit: limitsThreads ? nil : concurrency
+            )
+            let context = Unmanaged.passUnretained(sink).toOpaque()
+            let result = withExtendedLifetime((sink, source)) {
+                swift_vips_sink_tile(pointer, Int32(tileWidth), Int32(size), { left, top, width, height, data, stride, context in
+                    guard let data, let context else { return -1 }
+                    let sink = Unmanaged<TileSink>.fromOpaque(context).takeUnretainedValue()
+                    return sink.deliver(TileRegion(
+                        left: Int(left),
+                        top: Int(top),
+                        width: Int(width),
+                        height: Int(height),
+                        bands: sink.bands,
+                        bytesPerPixel: sink.bytesPerPixel,
+                        stride: Int(stride),
+                        baseAddress: data
+                    ))
+                }, context)
+            }
+
+            if let failure = sink.failure {
+                throw failure
+            }
+            guard result == 0 else {
+                throw VipsBackend.evaluationError(HokusaiError.vipsError)
+            }
+        }
+    }
+}
+
+/// PURPOSE: State for one `forEachTile` run, reached from libvips worker threads.
+private final class TileSink: @unchecked Sendable {
+    let body: @Sendable (TileRegion) throws -> Void
+    let bands: Int
+    let bytesPerPixel: Int
+    /// PURPOSE: Caps simultaneous `body` calls when libvips cannot cap its own threads
+    private let gate: DispatchSemaphore?
+    private let lock = NSLock()
+    private var error: Error?
+
+    init(body: @escaping @Sendable (TileRegion) throws -> Void, bands: Int, bytesPerPixel: Int, callbackLimit: Int?) {
+        self.body = body
+        self.bands = bands
+        self.bytesPerPixel = bytesPerPixel
+        self.gate = callbackLimit.map { DispatchSemaphore(value: $0) }
+    }
+
+    var failure: Error? {
+        lock.lock()
+        defer { lock.unlock() }
+        return error
+    }
+
+    /// PURPOSE: Run `body` for one tile; non-zero asks libvips to stop.
+    func deliver(_ region: TileRegion) -> Int32 {
+        gate?.wait()
+        defer { gate?.signal() }
+        guard failure == nil else { return 1 }
+        do {
+            try body(region)
+            return 0
+        } catch {
+            lock.lock()
+            if self.error == nil {
+                self.error = error
+            }
+            lock.unlock()
+            return 1
+        }
+    }
+}
@@ -0,0 +1,173 @@
+import Foundation
+import CVips
+
+extension HokusaiImage {
+    /// PURPOSE: Resample through an arbitrary affine map in one `vips_affine` pass.
+    /// INPUT:
+    /// - `affine`: scale/rotate/shear plus translation (`tx`, `ty`).
+    /// - `outputArea`: region of the transformed plane to render; nil renders the
+    ///   bounding box of the whole transformed image (translation then has no visible effect).
+    /// - `background`: fill for uncovered pixels; nil is black/transparent.
+    /// CONSTRAINTS: Interpolators do not antialias, so reductions beyond 2x should go
+    /// through `resize` (which filters) instead.
+    ///
+    /// Example:
+    /// ```swift
+    /// let t = AffineTransform.rotation(degrees: 7).then(.scale(0.8))
+    /// let straightened = try image.transform(affine: t, interpolator: .lbb)
+    /// ```
+    public func transform(
+        affine: AffineTransform,
+        interpolator: Interpolator = .bicubic,
+        outputArea: OutputArea? = nil,
+        background: [Double]? = nil
+    ) throws -> HokusaiImage {
+        let pointer = try ensureVipsBackend().getPointer()
+        guard affine.a * affine.d - affine.b * affine.c != 0 else {
+            throw HokusaiError.invalidOperation("affine matrix is singular")
+        }
+
+        var backgroundArray: UnsafeMutablePointer<VipsArrayDouble>?
+        if let background {
+            backgroundArray = background.withUnsafeBufferPointer { swift_vips_array_double_new($0.baseAddress, Int32(background.count)) }
+            guard backgroundArray != nil else {
+                throw HokusaiError.vipsError("Failed to create background array")
+            }
+        }
+        defer {
+            if let backgroundArray {
+                vips_area_unref(UnsafeMutablePointer(mutating: UnsafeRawPointer(backgroundArray).assumingMemoryBound(to: VipsArea.self)))
+            }
+        }
+
+        let area = outputArea.map { [Int32($0.left), Int32($0.top), Int32($0.width), Int32($0.height)] } ?? []
+        var output: UnsafeMutablePointer<CVips.VipsImage>?
+        let result = area.withUnsafeBufferPointer { areaBuffer in
+            swift_vips_affine(
+                pointer,
+                &output,
+                affine.a,
+                affine.b,
+                affine.c,
+                affine.d,
+                affine.tx,
+                affine.ty,
+                interpolator.rawValue,
+                area.isEmpty ? nil : areaBuffer.baseAddress,
+                backgroundArray
+            )
+        }
+        guard result == 0, let out = output else {
+            throw HokusaiError.vipsError(VipsBackend.getLastError())
+        }
+        return HokusaiImage(backend: .vips(VipsBackend(takingOwnership: out)))
+    }
+}
+
+/// PURPOSE: Collapse a run of geometric recipe steps into one affine resample.
+/// ALGORITHM:
+/// - Starting at a step, fold `.affine`, arbitrary-angle `.rotate`, and pure-scale
+///   `.resize` steps into one matrix while tracking the output size each would produce.
+/// - The run ends at the first step that crops, embeds, sharpens, picks a non-default
+///   resize kernel, flips, rotates by a multiple of 90° (exact and cheaper on its own),
+///   or would take the fused map below half scale on either axis.
+/// - The output area is the transformed bounding box, sized exactly to the last
+///   resize's target when the run ends in one.
+/// CONSTRAINTS:
+/// - Runs of one step are left to the step's own operation, so single-step recipes
+///   behave exactly as before.
+/// - Fused lanczos3 resizes are resampled with `interpolator` (bicubic by default).
+struct AffineRun {
+    var transform = AffineTransform.identity
+    var interpolator = Interpolator.bicubic
+    var background: [Double]?
+    var count = 0
+    var width: Int
+    var height: Int
+    var exactSize: (width: Int, height: Int)?
+
+    private let sourceWidth: Int
+    private let sourceHeight: Int
+
+    init(width: Int, height: Int) {
+        self.width = width
+        self.height = height
+        self.sourceWidth = width
+        self.sourceHeight = height
+    }
+
+    /// PURPOSE: Longest mergeable run starting at `steps.startIndex`.
+    static func plan(_ steps: ArraySlice<ProcessingStep>, width: Int, height: Int) throws -> AffineRun {
+        var run = AffineRun(width: width, height: height)
+        for step in steps {
+            guard try run.absorb(step) else { break }
+        }
+        return run
+    }
+
+    /// PURPOSE: Output area covering the whole transformed image.
+    var outputArea: OutputArea {
+        let bounds = transform.bounds(width: sourceWidth, height: sourceHeight)
+        return OutputArea(
+            left: Int(bounds.minX.rounded(.down)),
+            top: Int(bounds.minY.rounded(.down)),
+            width: exactSize?.width ?? width,
+            height: exactSize?.height ?? height
+        )
+    }
+
+    private mutating func absorb(_ step: ProcessingStep) throws -> Bool {
+        switch step {
+        case .affine(let affine, let stepInterpolator, let stepBackground):
+            guard append(affine) else { return false }
+            interpolator = stepInterpolator
+            background = stepBackground ?? background
+            exactSize = nil
+
+        case .rotate(.custom(let degrees), let stepBackground) where degrees.truncatingRemainder(dividingBy: 90) != 0:
+            guard append(.rotation(degrees: degrees)) else { return false }
+            background = stepBackground ?? background
+            exactSize = nil
+
+        case .resize(let options):
+            let cropsOrPads = (options.fit == .cover || options.fit == .contain) && options.width != nil && options.height != nil
+            guard !cropsOrPads, options.sharpen == nil, options.kernel == .lanczos3 else { return false }
+            let target = try HokusaiImage.calculateDimensions(
+                currentWidth: width,
+                currentHeight: height,
+                targetWidth: options.width,
+                targetHeight: options.height,
+                fit: options.fit,
+                withoutEnlargement: options.withoutEnlargement,
+                withoutReduction: options.withoutReduction
+            )
+            let sx = Double(target.width) / Double(width)
+            let sy = Double(target.height) / Double(height)
+            guard append(.scale(sx, sy)) else { return false }
+            width = target.width
+            height = target.height
+            exactSize = target
+
+        default:
+            return false
+        }
+
+        count += 1
+        return true
+    }
+
+    /// PURPOSE: Fold `next` in unless the fused map would reduce either source axis by more
+    /// than 2x (interpolators do not antialias); returns whether it was folded.
+    private mutating func append(_ next: AffineTransform) -> Bool {
+        let fused = transform.then(next)
+        let xScale = (fused.a * fused.a + fused.c * fused.c).squareRoot()
+        let yScale = (fused.b * fused.b + fused.d * fused.d).squareRoot()
+        guard xScale >= 0.5, yScale >= 0.5 else { return false }
+
+        transform = fused
+        let bounds = transform.bounds(width: sourceWidth, height: sourceHeight)
+        width = max(1, Int((bounds.maxX - bounds.minX).rounded()))
+        height = max(1, Int((bounds.maxY - bounds.minY).rounded()))
+        return true
+    }
+}
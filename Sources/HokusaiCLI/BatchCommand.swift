@@ -0,0 +1,377 @@
+import Foundation
+import ArgumentParser
+import Hokusai
+import Prompt
+
+struct BatchCommand: AsyncParsableCommand {
+    static let configuration = CommandConfiguration(
+        commandName: "batch",
+        abstract: "Process a directory tree, optionally as one shard of a multi-node job.",
+        subcommands: [BatchRunCommand.self, BatchMergeManifestsCommand.self],
+        defaultSubcommand: BatchRunCommand.self
+    )
+}
+
+struct BatchRunCommand: AsyncParsableCommand {
+    static let configuration = CommandConfiguration(
+        commandName: "run",
+        abstract: "Process this node's share of the input tree."
+    )
+
+    @Option(help: "Input directory tree.")
+    var inputDir: String
+
+    @Option(help: "Output directory (input layout is mirrored).")
+    var outputDir: String
+
+    @Option(help: "Recipe JSON file (see README: Daemon mode).")
+    var recipe: String
+
+    @Option(help: "Shard as i/N (1-based), e.g. 2/8. Default: 1/1.")
+    var shard: String = "1/1"
+
+    @Option(help: "Images processed in parallel (default: derived from cores).")
+    var jobs: Int?
+
+    @Option(help: "Shard manifest path (default: <output-dir>/.hokusai-shard-i-of-N.json).")
+    var manifest: String?
+
+    @Option(help: "Files read ahead of the decoders (0 disables prefetch).")
+    var prefetch: Int = 16
+
+    @Option(help: "I/O backend for prefetch and output writes: automatic, io-uring, threads.")
+    var ioBackend: String = "automatic"
+
+    @Flag(help: "Only print the shard plan; do not process.")
+    var dryRun: Bool = false
+
+    mutating func run() async throws {
+        let prompt = PromptService()
+        let (index, count) = try ShardPlanner.parse(shard)
+        let recipe = try JobFiles.loadRecipe(self.recipe)
+        guard let format = recipe.output.format else {
+            throw ValidationError("Recipe must set output.format")
+        }
+        guard let backend = IOBackend(rawValue: ioBackend) else {
+            throw ValidationError("--io-backend must be one of: \(IOBackend.allCases.map(\.rawValue).joined(separator: ", "))")
+        }
+
+        let files = JobFiles.imageFiles(under: inputDir, excluding: outputDir)
+        let plan = ShardPlanner.plan(files, shardCount: count)
+        let assigned = plan.files(for: index)
+
+        prompt.header("Hokusai Batch")
+        prompt.panel("Shard \(index)/\(count)", items: [
+            ("Input", prompt.path(inputDir)),
+            ("Files (all shards)", "\(files.count)"),
+            ("Files (this shard)", "\(assigned.count)"),
+            ("Bytes (this shard)", "\(plan.bytes(for: index))"),
+            ("Largest/smallest shard", String(format: "%.3f", plan.imbalance)),
+        ])
+        if dryRun { return }
+
+        try Hokusai.initialize()
+        defer { Hokusai.shutdown() }
+
+        var entries: [ShardManifest.Entry] = []
+        let start = DispatchTime.now().uptimeNanoseconds
+        let writer = BatchWriter(backend: backend)
+        let stream = Hokusai.process(
+            assigned.map { ImageInput.file($0.path) },
+            recipe: recipe,
+            maxConcurrency: jobs,
+            prefetch: prefetch > 0 ? PrefetchOptions(depth: prefetch, backend: backend) : nil
+        )
+        for try await output in stream {
+            let file = assigned[output.index]
+            let outputPath = JobFiles.outputPath(for: file.relativePath, outputDir: outputDir, format: format)
+
+            var entry = ShardManifest.Entry(path: file.relativePath, size: file.size, status: .ok)
+            do {
+                let data = try output.result.get()
+                writer.write(data, to: outputPath)
+                entry.outputBytes = data.count
+            } catch {
+                entry.status = .failed
+                entry.error = String(describing: error)
+                prompt.info("Failed \(file.relativePath): \(error)")
+            }
+            entries.append(entry)
+        }
+        do {
+            try await writer.finish()
+        } catch {
+            // PURPOSE: Record write failures per file so merge-manifests reports them.
+            let failedWrites = Dictionary(writer.failedWrites.map { ($0.path, String(describing: $0.error)) }) { first, _ in first }
+            for position in entries.indices {
+                let relativePath = entries[position].path
+                let outputPath = JobFiles.outputPath(for: relativePath, outputDir: outputDir, format: format)
+                if let message = failedWrites[outputPath] {
+                    entries[position].status = .failed
+                    entries[position].error = message
+                    prompt.info("Failed \(relativePath): \(message)")
+                }
+            }
+        }
+        let elapsed = Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000_000.0
+
+        let shardManifest = ShardManifest(
+            shard: index,
+            shardCount: count,
+            recipe: try JobFiles.fingerprint(recipe),
+            fileSetHash: plan.fileSetHash,
+            totalFiles: files.count,
+            entries: entries.sorted { $0.path < $1.path }
+        )
+        let manifestPath = manifest
+            ?? (outputDir as NSString).appendingPathComponent(".hokusai-shard-\(index)-of-\(count).json")
+        try shardManifest.write(to: manifestPath)
+
+        let failed = entries.filter { $0.status == .failed }.count
+        prompt.success("Shard \(index)/\(count) done")
+        prompt.panel("Result", items: [
+            ("Processed", "\(entries.count - failed)"),
+            ("Failed", "\(failed)"),
+            ("Elapsed", String(format: "%.1f s", elapsed)),
+            ("I/O backend", writer.backend.rawValue),
+            ("Manifest", prompt.path(manifestPath)),
+        ])
+    }
+}
+
+struct BatchMergeManifestsCommand: AsyncParsableCommand {
+    static let configuration = CommandConfiguration(
+        commandName: "merge-manifests",
+        abstract: "Verify that shard manifests cover the whole input exactly once."
+    )
+
+    @Argument(help: "Shard manifest files written by `hokusai batch`.")
+    var manifests: [String]
+
+    @Option(help: "Re-list this input tree and check coverage against it.")
+    var inputDir: String?
+
+    @Option(help: "Batch output directory to leave out of the --input-dir listing (default: the manifests' directories).")
+    var outputDir: String?
+
+    @Option(help: "Write the merged manifest to this path.")
+    var output: String?
+
+    mutating func run() async throws {
+        let prompt = PromptService()
+        let loaded = try manifests.map(ShardManifest.read(from:))
+        let report = try ShardManifest.merge(loaded, currentFiles: inputDir.map {
+            JobFiles.imageFiles(under: $0, excludingAll: excludedDirectories(inputDir: $0))
+        })
+
+        if let output {
+            try report.merged.write(to: output)
+        }
+
+        prompt.header("Shard Coverage")
+        prompt.panel("Summary", items: [
+            ("Shards", "\(loaded.count)/\(report.merged.shardCount)"),
+            ("Files covered", "\(report.merged.entries.count)/\(report.merged.totalFiles)"),
+            ("Failed", "\(report.failed.count)"),
+            ("Missing", "\(report.missing.count)"),
+            ("Duplicated", "\(report.duplicated.count)"),
+        ])
+        for path in report.missing.prefix(20) { prompt.item("missing: \(path)") }
+        for path in report.duplicated.prefix(20) { prompt.item("duplicated: \(path)") }
+        for path in report.failed.prefix(20) { prompt.item("failed: \(path)") }
+
+        guard report.isComplete else {
+            throw ValidationError("Shard manifests do not cover the input cleanly")
+        }
+        prompt.success("All files covered exactly once")
+    }
+
+    /// PURPOSE: Output locations nested in the input tree must not count as inputs.
+    /// Shard manifests default to the batch output dir, so their directories (and the
+    /// merged manifest's) are skipped unless they are the input root itself.
+    private func excludedDirectories(inputDir: String) -> [String] {
+        let root = URL(fileURLWithPath: inputDir).standardizedFileURL.path
+        let directories = (manifests + [output].compactMap { $0 })
+            .map { URL(fileURLWithPath: $0).standardizedFileURL.deletingLastPathComponent().path }
+        return ([outputDir].compactMap { $0 } + directories).filter {
+            URL(fileURLWithPath: $0).standardizedFileURL.path != root
+        }
+    }
+}
+
+/// PURPOSE: Deterministic, coordinator-free split of a file set across N nodes.
+/// ALGORITHM:
+/// - Hash each relative path (FNV-1a 64) into one of `N * bucketsPerShard` virtual buckets.
+/// - Sum bytes per bucket; assign buckets largest-first to the lightest shard (LPT),
+///   breaking ties by index so every node computes the same plan.
+/// CONSTRAINTS:
+/// - Nodes must list the same tree; `fileSetHash` lets `merge-manifests` detect drift.
+/// - The plan is only stable for an unchanged file set: when bucket sizes change, LPT
+///   can move whole buckets between shards, so re-runs rely on manifests, not placement.
+struct ShardPlanner {
+    static let bucketsPerShard = 64
+
+    let shardCount: Int
+    let fileSetHash: String
+    private let assignments: [[JobFile]]
+
+    static func parse(_ value: String) throws -> (index: Int, count: Int) {
+        let parts = value.split(separator: "/").compactMap { Int($0) }
+        guard parts.count == 2, parts[1] >= 1, (1...parts[1]).contains(parts[0]) else {
+            throw ValidationError("Shard must be i/N with 1 <= i <= N, got \(value)")
+        }
+        return (parts[0], parts[1])
+    }
+
+    static func plan(_ files: [JobFile], shardCount: Int) -> ShardPlanner {
+        let bucketCount = shardCount * bucketsPerShard
+        var buckets = Array(repeating: [JobFile](), count: bucketCount)
+        var bucketBytes = Array(repeating: 0, count: bucketCount)
+        for file in files {
+            let bucket = Int(ContentHash.fnv1a64(file.relativePath) % UInt64(bucketCount))
+            buckets[bucket].append(file)
+            // PURPOSE: Count per-file overhead so shards of tiny files still balance by count.
+            bucketBytes[bucket] += file.size + 4096
+        }
+
+        let order = (0..<bucketCount).sorted {
+            bucketBytes[$0] != bucketBytes[$1] ? bucketBytes[$0] > bucketBytes[$1] : $0 < $1
+        }
+        var loads = Array(repeating: 0, count: shardCount)
+        var assignments = Array(repeating: [JobFile](), count: shardCount)
+        for bucket in order where !buckets[bucket].isEmpty {
+            let target = loads.indices.min { loads[$0] != loads[$1] ? loads[$0] < loads[$1] : $0 < $1 } ?? 0
+            loads[target] += bucketBytes[bucket]
+            assignments[target].append(contentsOf: buckets[bucket])
+        }
+
+        let listing = files
+            .map { "\($0.relativePath)\t\($0.size)" }
+            .sorted()
+            .joined(separator: "\n")
+        return ShardPlanner(
+            shardCount: shardCount,
+            fileSetHash: ContentHash.hex(ContentHash.fnv1a64(listing)),
+            assignments: assignments.map { $0.sorted { $0.relativePath < $1.relativePath } }
+        )
+    }
+
+    /// PURPOSE: Files for a 1-based shard index.
+    func files(for shard: Int) -> [JobFile] {
+        return assignments[shard - 1]
+    }
+
+    func bytes(for shard: Int) -> Int {
+        return files(for: shard).reduce(0) { $0 + $1.size }
+    }
+
+    /// PURPOSE: Largest shard bytes divided by smallest (1.0 = perfectly balanced).
+    var imbalance: Double {
+        let totals = (1...shardCount).map(bytes(for:))
+        guard let largest = totals.max(), let smallest = totals.min(), smallest > 0 else {
+            return totals.contains { $0 > 0 } ? .infinity : 1
+        }
+        return Double(largest) / Double(smallest)
+    }
+}
+
+/// PURPOSE: Per-shard record of what a node processed, merged later to verify coverage.
+struct ShardManifest: Codable {
+    enum Status: String, Codable {
+        case ok
+        case failed
+    }
+
+    struct Entry: Codable {
+        var path: String
+        var size: Int
+        var status: Status
+        var outputBytes: Int?
+        var error: String?
+    }
+
+    struct MergeReport {
+        let merged: ShardManifest
+        let missing: [String]
+        let duplicated: [String]
+        let failed: [String]
+
+        var isComplete: Bool {
+            return missing.isEmpty && duplicated.isEmpty && failed.isEmpty
+        }
+    }
+
+    /// PURPOSE: 1-based shard index; 0 for a merged manifest
+    var shard: Int
+    var shardCount: Int
+    var recipe: String
+    var fileSetHash: String
+    var totalFiles: Int
+    var entries: [Entry]
+
+    static func read(from path: String) throws -> ShardManifest {
+        return try JSONDecoder().decode(ShardManifest.self, from: Data(contentsOf: URL(fileURLWithPath: path)))
+    }
+
+    func write(to path: String) throws {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+        try JobFiles.writeOutput(encoder.encode(self), to: path)
+    }
+
+    /// PURPOSE: Combine shard manifests and report gaps, overlaps, and failures.
+    /// CONSTRAINTS: Throws when manifests come from different jobs (shard count, recipe, or file set).
+    static func merge(_ manifests: [ShardManifest], currentFiles: [JobFile]?) throws -> MergeReport {
+        guard let first = manifests.first else {
+            throw ValidationError("No manifests given")
+        }
+        for manifest in manifests {
+            guard manifest.shardCount == first.shardCount, manifest.recipe == first.recipe else {
+                throw ValidationError("Manifests come from different jobs (shard count or recipe differ)")
+            }
+            guard manifest.fileSetHash == first.fileSetHash else {
+                throw ValidationError("Shard \(manifest.shard) listed a different input tree; re-run it")
+            }
+        }
+
+        let shards = manifests.map(\.shard)
+        let missingShards = Set(1...first.shardCount).subtracting(shards)
+        guard missingShards.isEmpty else {
+            throw ValidationError("Missing shard manifests: \(missingShards.sorted().map(String.init).joined(separator: ", "))")
+        }
+
+        var seen: [String: Entry] = [:]
+        var duplicated: [String] = []
+        for entry in manifests.flatMap(\.entries) {
+            if seen[entry.path] != nil {
+                duplicated.append(entry.path)
+            }
+            seen[entry.path] = entry
+        }
+
+        var missing: [String] = []
+        var totalFiles = first.totalFiles
+        if let currentFiles {
+            totalFiles = currentFiles.count
+            missing = currentFiles.map(\.relativePath).filter { seen[$0] == nil }
+        } else if seen.count < first.totalFiles {
+            missing = ["<\(first.totalFiles - seen.count) files unaccounted for>"]
+        }
+
+        let entries = seen.values.sorted { $0.path < $1.path }
+        let merged = ShardManifest(
+            shard: 0,
+            shardCount: first.shardCount,
+            recipe: first.recipe,
+            fileSetHash: first.fileSetHash,
+            totalFiles: totalFiles,
+            entries: entries
+        )
+        return MergeReport(
+            merged: merged,
+            missing: missing.sorted(),
+            duplicated: Array(Set(duplicated)).sorted(),
+            failed: entries.filter { $0.status == .failed }.map(\.path)
+        )
+    }
+}
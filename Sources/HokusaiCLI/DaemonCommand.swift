@@ -0,0 +1,351 @@
+import Foundation
+import ArgumentParser
+import Hokusai
+import Prompt
+#if canImport(Glibc)
+import Glibc
+#elseif canImport(Darwin)
+import Darwin
+#endif
+
+struct DaemonCommand: AsyncParsableCommand {
+    static let configuration = CommandConfiguration(
+        commandName: "daemon",
+        abstract: "Serve recipes over a Unix domain socket with warm workers."
+    )
+
+    @Option(help: "Unix domain socket path to listen on.")
+    var socket: String
+
+    @Option(help: "Number of worker threads (default: half the active cores).")
+    var workers: Int?
+
+    @Option(help: "Comma-separated fonts to warm up at start.")
+    var warmFonts: String = "sans"
+
+    @Option(help: "Maximum payload size in megabytes.")
+    var maxPayloadMb: Int = 256
+
+    @Option(help: "Seconds an idle connection may hold a worker.")
+    var idleTimeout: Int = 30
+
+    /// PURPOSE: Initialize once, warm caches, then serve until SIGINT/SIGTERM.
+    /// CONSTRAINTS: `server.stop()` drains in-flight requests before the deferred shutdown.
+    mutating func run() async throws {
+        let prompt = PromptService()
+        try Hokusai.initialize()
+        defer { Hokusai.shutdown() }
+
+        let fonts = warmFonts.split(separator: ",").map { $0.trimmingCharacters(in: .whitespaces) }
+        try Hokusai.warmUp(fonts: fonts.filter { !$0.isEmpty })
+
+        let workerCount = Hokusai.workerCount(requested: workers)
+        let server = try DaemonServer(
+            path: socket,
+            workers: workerCount,
+            maxPayloadBytes: maxPayloadMb * 1024 * 1024,
+            idleTimeout: idleTimeout
+        )
+
+        prompt.header("Hokusai Daemon")
+        prompt.panel("Listening", items: [
+            ("Socket", prompt.path(socket)),
+            ("Workers", "\(workerCount)"),
+            ("libvips", Hokusai.vipsVersion),
+        ])
+
+        server.start()
+        await server.waitForTermination()
+        server.stop()
+
+        prompt.summary("Served \(server.servedCount) requests")
+    }
+}
+
+struct ClientCommand: AsyncParsableCommand {
+    static let configuration = CommandConfiguration(
+        commandName: "client",
+        abstract: "Send one image and recipe to a running daemon."
+    )
+
+    @Option(help: "Daemon socket path.")
+    var socket: String
+
+    @Option(help: "Recipe JSON file (see README: Daemon mode).")
+    var recipe: String
+
+    @Option(name: .shortAndLong, help: "Input image path.")
+    var input: String
+
+    @Option(name: .shortAndLong, help: "Output image path.")
+    var output: String
+
+    mutating func run() async throws {
+        let prompt = PromptService()
+        let recipeData = try Data(contentsOf: URL(fileURLWithPath: recipe))
+        let payload = try Data(contentsOf: URL(fileURLWithPath: input))
+
+        let start = DispatchTime.now().uptimeNanoseconds
+        let connection = try UnixSocket.makeConnection(path: socket)
+        try connection.writeAll(DaemonProtocol.encodeRequest(recipe: recipeData, payload: payload))
+
+        guard let header = try connection.readExactly(DaemonProtocol.responseHeaderSize) else {
+            throw DaemonError("Daemon closed the connection without a response")
+        }
+        let (status, length) = try DaemonProtocol.decodeResponseHeader(header)
+        let body = try connection.readExactly(length) ?? Data()
+        let elapsedMs = Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000.0
+
+        guard status == .ok else {
+            throw DaemonError("Daemon error: \(String(decoding: body, as: UTF8.self))")
+        }
+        try body.write(to: URL(fileURLWithPath: output))
+
+        prompt.success("Saved daemon output")
+        prompt.panel("Result", items: [
+            ("Input", prompt.path(input)),
+            ("Output", prompt.path(output)),
+            ("Bytes", "\(body.count)"),
+            ("Round trip", String(format: "%.2f ms", elapsedMs)),
+        ])
+    }
+}
+
+/// PURPOSE: Accept loop and warm worker threads behind `hokusai daemon`.
+/// ALGORITHM:
+/// - N threads block in `accept()` on one listening socket; the kernel hands each
+///   connection to exactly one idle worker.
+/// - A worker serves its connection's frames sequentially, then returns to `accept()`.
+/// - Decoded recipes are cached per worker, keyed by their JSON bytes.
+/// - `stop()` refuses new connections and frames, lets requests already read finish
+///   and reply, and returns only once none are in flight.
+/// CONSTRAINTS: Per-connection failures are answered with an error frame or a close;
+/// they never stop the daemon.
+final class DaemonServer: @unchecked Sendable {
+    private let path: String
+    private let listener: Int32
+    private let workers: Int
+    private let maxPayloadBytes: Int
+    private let idleTimeout: Int
+    private let lock = NSCondition()
+    private var served = 0
+    private var signalSources: [DispatchSourceSignal] = []
+    private var terminated = false
+    private var stopping = false
+    private var inFlight = 0
+    private var awaitingFrame: Set<Int32> = []
+
+    private static let maxRecipeBytes = 1024 * 1024
+    private static let recipeCacheLimit = 64
+
+    /// PURPOSE: Wait after a failed accept, doubled per consecutive failure
+    private static let minAcceptBackoff = 0.01
+    private static let maxAcceptBackoff = 1.0
+
+    init(path: String, workers: Int, maxPayloadBytes: Int, idleTimeout: Int) throws {
+        self.path = path
+        self.workers = workers
+        self.maxPayloadBytes = maxPayloadBytes
+        self.idleTimeout = idleTimeout
+        self.listener = try UnixSocket.makeListener(path: path, backlog: 128)
+    }
+
+    var servedCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return served
+    }
+
+    func start() {
+        // PURPOSE: A client hanging up mid-response must not kill the process.
+        signal(SIGPIPE, SIG_IGN)
+
+        for index in 0..<workers {
+            let thread = Thread { [self] in
+                workerLoop()
+            }
+            thread.name = "hokusai-daemon-\(index)"
+            thread.start()
+        }
+    }
+
+    func waitForTermination() async {
+        await withCheckedContinuation { (continuation: CheckedContinuation<Void, Never>) in
+            lock.lock()
+            defer { lock.unlock() }
+
+            for signalNumber in [SIGINT, SIGTERM] {
+                signal(signalNumber, SIG_IGN)
+                let source = DispatchSource.makeSignalSource(signal: signalNumber, queue: .global())
+                source.setEventHandler { [self] in
+                    if markTerminated() {
+                        continuation.resume()
+                    }
+                }
+                source.resume()
+                signalSources.append(source)
+            }
+        }
+    }
+
+    /// PURPOSE: Stop serving and wait for in-flight requests, so libvips can shut down safely.
+    func stop() {
+        lock.lock()
+        stopping = true
+        signalSources.forEach { $0.cancel() }
+        signalSources.removeAll()
+        // PURPOSE: Idle keep-alive connections see EOF instead of holding a worker until the timeout.
+        for descriptor in awaitingFrame {
+            shutdown(descriptor, Int32(SHUT_RD))
+        }
+        lock.unlock()
+
+        // PURPOSE: Wakes workers blocked in accept() on Linux; Darwin exits with the process.
+        shutdown(listener, Int32(SHUT_RDWR))
+
+        lock.lock()
+        while inFlight > 0 {
+            lock.wait()
+        }
+        lock.unlock()
+
+        close(listener)
+        unlink(path)
+    }
+
+    // MARK: - Private Helpers
+
+    /// PURPOSE: First signal wins; later ones are ignored.
+    private func markTerminated() -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        guard !terminated else { return false }
+        terminated = true
+        return true
+    }
+
+    private var isStopping: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return stopping
+    }
+
+    private func workerLoop() {
+        var recipes: [Data: ProcessingRecipe] = [:]
+        var backoff = Self.minAcceptBackoff
+
+        while !isStopping {
+            let descriptor = accept(listener, nil, nil)
+            if descriptor < 0 {
+                let error = errno
+                if error == EINTR || error == ECONNABORTED { continue }
+                // PURPOSE: `stop` wakes accept with an error; anything else (EMFILE, ENFILE,
+                // ENOBUFS) is usually transient, so the worker waits and tries again.
+                guard !isStopping else { return }
+                FileHandle.standardError.write(Data(
+                    "hokusai daemon: accept failed: \(String(cString: strerror(error))); retrying in \(Int(backoff * 1000)) ms\n".utf8
+                ))
+                Thread.sleep(forTimeInterval: backoff)
+                backoff = min(backoff * 2, Self.maxAcceptBackoff)
+                continue
+            }
+            backoff = Self.minAcceptBackoff
+            if isStopping {
+                close(descriptor)
+                return
+            }
+
+            let connection = SocketConnection(descriptor: descriptor)
+            connection.setReceiveTimeout(seconds: idleTimeout)
+            serve(connection, recipes: &recipes)
+        }
+    }
+
+    private func serve(_ connection: SocketConnection, recipes: inout [Data: ProcessingRecipe]) {
+        do {
+            while let header = try nextFrameHeader(connection) {
+                defer { finishRequest() }
+                let request = try DaemonProtocol.decodeRequestHeader(header)
+                guard request.recipeLength <= Self.maxRecipeBytes,
+                      request.payloadLength <= maxPayloadBytes else {
+                    try reply(connection, .failed, message: "Frame exceeds daemon size limits")
+                    return
+                }
+
+                let recipeData = try connection.readExactly(request.recipeLength) ?? Data()
+                let payload = try connection.readExactly(request.payloadLength) ?? Data()
+
+                do {
+                    let recipe = try cachedRecipe(recipeData, in: &recipes)
+                    let encoded = try recipe.run(.data(payload), concurrentRuns: workers)
+                    try connection.writeAll(DaemonProtocol.encodeResponse(status: .ok, body: encoded))
+                } catch let error as DaemonError {
+                    throw error
+                } catch {
+                    try reply(connection, .failed, message: String(describing: error))
+                }
+
+                lock.lock()
+                served += 1
+                lock.unlock()
+            }
+        } catch {
+            // PURPOSE: Broken or malformed connections are dropped; the worker moves on.
+            return
+        }
+    }
+
+    /// PURPOSE: Wait for the next request on `connection`, counting it as in flight once read.
+    /// OUTPUT: nil on EOF or once the daemon is stopping.
+    private func nextFrameHeader(_ connection: SocketConnection) throws -> Data? {
+        lock.lock()
+        guard !stopping else {
+            lock.unlock()
+            return nil
+        }
+        awaitingFrame.insert(connection.descriptor)
+        lock.unlock()
+
+        let header: Data?
+        do {
+            header = try connection.readExactly(DaemonProtocol.requestHeaderSize)
+        } catch {
+            lock.lock()
+            awaitingFrame.remove(connection.descriptor)
+            lock.unlock()
+            throw error
+        }
+
+        lock.lock()
+        defer { lock.unlock() }
+        awaitingFrame.remove(connection.descriptor)
+        if header != nil {
+            inFlight += 1
+        }
+        return header
+    }
+
+    private func finishRequest() {
+        lock.lock()
+        inFlight -= 1
+        lock.broadcast()
+        lock.unlock()
+    }
+
+    private func cachedRecipe(_ data: Data, in cache: inout [Data: ProcessingRecipe]) throws -> ProcessingRecipe {
+        if let recipe = cache[data] {
+            return recipe
+        }
+
+        let recipe = try JSONDecoder().decode(ProcessingRecipe.self, from: data)
+        if cache.count >= Self.recipeCacheLimit {
+            cache.removeAll(keepingCapacity: true)
+        }
+        cache[data] = recipe
+        return recipe
+    }
+
+    private func reply(_ connection: SocketConnection, _ status: DaemonProtocol.Status, message: String) throws {
+        try connection.writeAll(DaemonProtocol.encodeResponse(status: status, body: Data(message.utf8)))
+    }
+}
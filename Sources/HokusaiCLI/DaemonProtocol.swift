@@ -0,0 +1,225 @@
+import Foundation
+#if canImport(Glibc)
+import Glibc
+#elseif canImport(Darwin)
+import Darwin
+#endif
+
+/// PURPOSE: Binary framing shared by `hokusai daemon` and `hokusai client`.
+/// ALGORITHM (all integers big-endian):
+/// - Request:  "HKS1" | recipe length u32 | payload length u32 | recipe JSON | image bytes
+/// - Response: "HKS1" | status u8 (0 ok, 1 error) | body length u32 | body
+/// CONSTRAINTS:
+/// - A connection may carry any number of request/response pairs in sequence.
+/// - Error bodies are UTF-8 messages; success bodies are encoded images.
+/// AI HINTS:
+/// - This is a public wire contract for non-Swift sidecars; only additive changes
+///   behind a new magic value.
+enum DaemonProtocol {
+    static let magic: [UInt8] = Array("HKS1".utf8)
+    static let requestHeaderSize = 12
+    static let responseHeaderSize = 9
+
+    enum Status: UInt8 {
+        case ok = 0
+        case failed = 1
+    }
+
+    struct RequestHeader {
+        let recipeLength: Int
+        let payloadLength: Int
+    }
+
+    static func encodeRequest(recipe: Data, payload: Data) -> Data {
+        var frame = Data(magic)
+        appendUInt32(recipe.count, to: &frame)
+        appendUInt32(payload.count, to: &frame)
+        frame.append(recipe)
+        frame.append(payload)
+        return frame
+    }
+
+    static func decodeRequestHeader(_ header: Data) throws -> RequestHeader {
+        let bytes = [UInt8](header)
+        guard bytes.count == requestHeaderSize, Array(bytes[0..<4]) == magic else {
+            throw DaemonError("Bad request frame (expected HKS1 magic)")
+        }
+        return RequestHeader(
+            recipeLength: readUInt32(bytes, at: 4),
+            payloadLength: readUInt32(bytes, at: 8)
+        )
+    }
+
+    static func encodeResponse(status: Status, body: Data) -> Data {
+        var frame = Data(magic)
+        frame.append(status.rawValue)
+        appendUInt32(body.count, to: &frame)
+        frame.append(body)
+        return frame
+    }
+
+    static func decodeResponseHeader(_ header: Data) throws -> (status: Status, length: Int) {
+        let bytes = [UInt8](header)
+        guard bytes.count == responseHeaderSize,
+              Array(bytes[0..<4]) == magic,
+              let status = Status(rawValue: bytes[4]) else {
+            throw DaemonError("Bad response frame from daemon")
+        }
+        return (status, readUInt32(bytes, at: 5))
+    }
+
+    // MARK: - Private Helpers
+
+    private static func appendUInt32(_ value: Int, to data: inout Data) {
+        let big = UInt32(value).bigEndian
+        withUnsafeBytes(of: big) { data.append(contentsOf: $0) }
+    }
+
+    private static func readUInt32(_ bytes: [UInt8], at offset: Int) -> Int {
+        return Int(bytes[offset]) << 24
+            | Int(bytes[offset + 1]) << 16
+            | Int(bytes[offset + 2]) << 8
+            | Int(bytes[offset + 3])
+    }
+}
+
+/// PURPOSE: CLI-level failure for socket and protocol problems.
+struct DaemonError: Error, CustomStringConvertible {
+    let description: String
+
+    init(_ description: String) {
+        self.description = description
+    }
+}
+
+/// PURPOSE: Blocking stream socket with exact-length reads and full writes.
+/// CONSTRAINTS: Owned by a single thread; closes its descriptor on deinit.
+final class SocketConnection {
+    let descriptor: Int32
+
+    init(descriptor: Int32) {
+        self.descriptor = descriptor
+    }
+
+    deinit {
+        close(descriptor)
+    }
+
+    /// PURPOSE: Read exactly `count` bytes.
+    /// OUTPUT: nil on clean EOF before the first byte; throws on a truncated read.
+    func readExactly(_ count: Int) throws -> Data? {
+        guard count > 0 else { return Data() }
+
+        var data = Data(count: count)
+        var offset = 0
+        try data.withUnsafeMutableBytes { raw in
+            guard let base = raw.baseAddress else { return }
+            while offset < count {
+                let received = read(descriptor, base + offset, count - offset)
+                if received == 0 { return }
+                if received < 0 {
+                    if errno == EINTR { continue }
+                    throw DaemonError("read failed: \(String(cString: strerror(errno)))")
+                }
+                offset += received
+            }
+        }
+
+        if offset == 0 { return nil }
+        guard offset == count else {
+            throw DaemonError("Connection closed mid-frame (\(offset)/\(count) bytes)")
+        }
+        return data
+    }
+
+    func writeAll(_ data: Data) throws {
+        try data.withUnsafeBytes { raw in
+            guard let base = raw.baseAddress else { return }
+            var offset = 0
+            while offset < raw.count {
+                let sent = write(descriptor, base + offset, raw.count - offset)
+                if sent < 0 {
+                    if errno == EINTR { continue }
+                    throw DaemonError("write failed: \(String(cString: strerror(errno)))")
+                }
+                offset += sent
+            }
+        }
+    }
+
+    /// PURPOSE: Drop idle keep-alive clients so they cannot pin a worker forever.
+    func setReceiveTimeout(seconds: Int) {
+        var timeout = timeval(tv_sec: seconds, tv_usec: 0)
+        _ = setsockopt(descriptor, SOL_SOCKET, SO_RCVTIMEO, &timeout, socklen_t(MemoryLayout<timeval>.size))
+    }
+}
+
+/// PURPOSE: Unix domain socket setup for daemon and client.
+enum UnixSocket {
+    static func makeListener(path: String, backlog: Int32) throws -> Int32 {
+        let descriptor = try makeSocket()
+        // PURPOSE: A stale socket file from a crashed daemon would make bind fail.
+        unlink(path)
+
+        let bound = try withAddress(path) { address, length in
+            bind(descriptor, address, length)
+        }
+        guard bound == 0, listen(descriptor, backlog) == 0 else {
+            let message = String(cString: strerror(errno))
+            close(descriptor)
+            throw DaemonError("Cannot listen on \(path): \(message)")
+        }
+        return descriptor
+    }
+
+    static func makeConnection(path: String) throws -> SocketConnection {
+        let descriptor = try makeSocket()
+        let connected = try withAddress(path) { address, length in
+            connect(descriptor, address, length)
+        }
+        guard connected == 0 else {
+            let message = String(cString: strerror(errno))
+            close(descriptor)
+            throw DaemonError("Cannot connect to \(path): \(message)")
+        }
+        return SocketConnection(descriptor: descriptor)
+    }
+
+    // MARK: - Private Helpers
+
+    private static func makeSocket() throws -> Int32 {
+        #if os(Linux)
+        let streamType = Int32(SOCK_STREAM.rawValue)
+        #else
+        let streamType = SOCK_STREAM
+        #endif
+
+        let descriptor = socket(AF_UNIX, streamType, 0)
+        guard descriptor >= 0 else {
+            throw DaemonError("socket() failed: \(String(cString: strerror(errno)))")
+        }
+        return descriptor
+    }
+
+    private static func withAddress(
+        _ path: String,
+        _ body: (UnsafePointer<sockaddr>, socklen_t) -> Int32
+    ) throws -> Int32 {
+        var address = sockaddr_un()
+        address.sun_family = sa_family_t(AF_UNIX)
+
+        let pathBytes = Array(path.utf8)
+        let capacity = MemoryLayout.size(ofValue: address.sun_path)
+        guard pathBytes.count < capacity else {
+            throw DaemonError("Socket path too long (max \(capacity - 1) bytes): \(path)")
+        }
+        withUnsafeMutableBytes(of: &address.sun_path) { raw in
+            raw.copyBytes(from: pathBytes)
+            raw[pathBytes.count] = 0
+        }
+
+        return withUnsafePointer(to: &address) { pointer in
+            pointer.withMemoryRebound(to: sockaddr.self, capacity: 1) { body($0, socklen_t(MemoryLayout<sockaddr_un>.size)) }
+        }
+    }
+}
@@ -0,0 +1,228 @@
+import Foundation
+#if canImport(Glibc)
+import Glibc
+#elseif canImport(Darwin)
+import Darwin
+#endif
+
+/// PURPOSE: Report paths under a directory tree that may have been written or replaced.
+/// ALGORITHM:
+/// - Linux: one inotify watch per directory; `IN_CLOSE_WRITE`/`IN_MOVED_TO` mark finished
+///   writes, `IN_MODIFY` keeps the debounce timer alive, new directories are watched and
+///   scanned on creation, and queue overflow triggers a full rescan.
+/// - Elsewhere (or with `forcePolling`): periodic size/mtime snapshot diff.
+/// CONSTRAINTS:
+/// - `start` returns once the initial watches (or poll snapshot) are in place, so a
+///   scan after it cannot miss a file written in between.
+/// - Callbacks arrive on a dedicated background thread.
+/// - Notifications are hints; consumers still debounce and compare manifests.
+final class DirectoryWatcher: @unchecked Sendable {
+    private let root: String
+    private let excluding: String?
+    private let forcePolling: Bool
+    private let pollInterval: TimeInterval
+
+    init(root: String, excluding: String?, forcePolling: Bool, pollInterval: TimeInterval) {
+        self.root = URL(fileURLWithPath: root).standardizedFileURL.path
+        self.excluding = excluding.map { URL(fileURLWithPath: $0).standardizedFileURL.path }
+        self.forcePolling = forcePolling
+        self.pollInterval = pollInterval
+    }
+
+    /// PURPOSE: Human-readable backend name for CLI output.
+    var backendName: String {
+        #if os(Linux)
+        return forcePolling ? "polling" : "inotify"
+        #else
+        return "polling"
+        #endif
+    }
+
+    func start(onChange: @escaping @Sendable (String) -> Void) throws {
+        let ready = DispatchSemaphore(value: 0)
+        #if os(Linux)
+        if !forcePolling {
+            let descriptor = inotify_init1(Int32(IN_CLOEXEC))
+            guard descriptor >= 0 else {
+                throw JobError("inotify_init1 failed: \(String(cString: strerror(errno)))")
+            }
+            let thread = Thread { [self] in
+                inotifyLoop(descriptor: descriptor, ready: ready, onChange: onChange)
+            }
+            thread.name = "hokusai-watch"
+            thread.start()
+            ready.wait()
+            return
+        }
+        #endif
+
+        let thread = Thread { [self] in
+            pollLoop(ready: ready, onChange: onChange)
+        }
+        thread.name = "hokusai-watch"
+        thread.start()
+        ready.wait()
+    }
+
+    // MARK: - Private Helpers
+
+    private func pollLoop(ready: DispatchSemaphore, onChange: @Sendable (String) -> Void) {
+        var snapshot: [String: (Int, TimeInterval)] = [:]
+        for file in JobFiles.imageFiles(under: root, excluding: excluding) {
+            snapshot[file.path] = (file.size, file.modified)
+        }
+        ready.signal()
+
+        while true {
+            Thread.sleep(forTimeInterval: pollInterval)
+            var next: [String: (Int, TimeInterval)] = [:]
+            for file in JobFiles.imageFiles(under: root, excluding: excluding) {
+                next[file.path] = (file.size, file.modified)
+                if let previous = snapshot[file.path], previous == (file.size, file.modified) {
+                    continue
+                }
+                onChange(file.path)
+            }
+            snapshot = next
+        }
+    }
+
+    #if os(Linux)
+    private func inotifyLoop(descriptor: Int32, ready: DispatchSemaphore, onChange: @Sendable (String) -> Void) {
+        let fileMask = UInt32(IN_CLOSE_WRITE) | UInt32(IN_MOVED_TO) | UInt32(IN_MODIFY)
+        let watchMask = fileMask | UInt32(IN_CREATE) | UInt32(IN_DELETE_SELF) | UInt32(IN_ONLYDIR)
+        var directories: [Int32: String] = [:]
+
+        func watchTree(_ directory: String, reportFiles: Bool) {
+            guard directory != excluding else { return }
+            let wd = inotify_add_watch(descriptor, directory, watchMask)
+            if wd >= 0 {
+                directories[wd] = directory
+            } else if errno == ENOSPC {
+                FileHandle.standardError.write(Data(
+                    "hokusai watch: inotify watch limit reached at \(directory); raise fs.inotify.max_user_watches or use --poll\n".utf8
+                ))
+            }
+
+            guard let entries = try? FileManager.default.contentsOfDirectory(atPath: directory) else { return }
+            for entry in entries where !entry.hasPrefix(".") {
+                let path = (directory as NSString).appendingPathComponent(entry)
+                var isDirectory: ObjCBool = false
+                guard FileManager.default.fileExists(atPath: path, isDirectory: &isDirectory) else { continue }
+                if isDirectory.boolValue {
+                    watchTree(path, reportFiles: reportFiles)
+                } else if reportFiles, JobFiles.isCandidate(path) {
+                    // PURPOSE: Files copied in before the watch was attached would otherwise be missed.
+                    onChange(path)
+                }
+            }
+        }
+
+        watchTree(root, reportFiles: false)
+        ready.signal()
+
+        let bufferSize = 64 * 1024
+        let buffer = UnsafeMutableRawPointer.allocate(byteCount: bufferSize, alignment: 8)
+        defer {
+            buffer.deallocate()
+            close(descriptor)
+        }
+
+        while true {
+            let length = read(descriptor, buffer, bufferSize)
+            if length < 0 {
+                if errno == EINTR { continue }
+                return
+            }
+
+            var offset = 0
+            while offset + 16 <= length {
+                let wd = buffer.load(fromByteOffset: offset, as: Int32.self)
+                let mask = buffer.load(fromByteOffset: offset + 4, as: UInt32.self)
+                let nameLength = Int(buffer.load(fromByteOffset: offset + 12, as: UInt32.self))
+                let namePointer = (buffer + offset + 16).assumingMemoryBound(to: CChar.self)
+                let name = nameLength > 0 ? String(cString: namePointer) : ""
+                offset += 16 + nameLength
+
+                if mask & UInt32(IN_Q_OVERFLOW) != 0 {
+                    // PURPOSE: Events were dropped; rediscover everything and let the manifest filter.
+                    for file in JobFiles.imageFiles(under: root, excluding: excluding) {
+                        onChange(file.path)
+                    }
+                    continue
+                }
+                if mask & UInt32(IN_IGNORED) != 0 {
+                    directories[wd] = nil
+                    continue
+                }
+                guard let directory = directories[wd], !name.isEmpty else { continue }
+
+                let path = (directory as NSString).appendingPathComponent(name)
+                if mask & UInt32(IN_ISDIR) != 0 {
+                    if mask & (UInt32(IN_CREATE) | UInt32(IN_MOVED_TO)) != 0 {
+                        watchTree(path, reportFiles: true)
+                    }
+                } else if mask & fileMask != 0, JobFiles.isCandidate(path) {
+                    onChange(path)
+                }
+            }
+        }
+    }
+    #endif
+}
+
+/// PURPOSE: Hold change notifications until a file has been quiet and size-stable.
+/// CONSTRAINTS: Thread-safe; `note` is called from the watcher thread, `takeSettled` from the scheduler.
+final class ChangeDebouncer: @unchecked Sendable {
+    private struct Pending {
+        var lastEvent: TimeInterval
+        var size: Int
+    }
+
+    private let quietPeriod: TimeInterval
+    private let lock = NSLock()
+    private var pending: [String: Pending] = [:]
+
+    init(quietPeriod: TimeInterval) {
+        self.quietPeriod = quietPeriod
+    }
+
+    func note(_ path: String) {
+        let size = Self.fileSize(path) ?? -1
+        lock.lock()
+        pending[path] = Pending(lastEvent: Date().timeIntervalSince1970, size: size)
+        lock.unlock()
+    }
+
+    /// PURPOSE: Remove and return paths quiet for `quietPeriod` whose size did not change since.
+    func takeSettled() -> [String] {
+        let now = Date().timeIntervalSince1970
+        lock.lock()
+        let due = pending.filter { now - $0.value.lastEvent >= quietPeriod }
+        lock.unlock()
+
+        var settled: [String] = []
+        for (path, entry) in due {
+            let size = Self.fileSize(path)
+            lock.lock()
+            defer { lock.unlock() }
+            // PURPOSE: A newer event arrived while we were stat-ing; keep waiting.
+            guard let current = pending[path], current.lastEvent == entry.lastEvent else { continue }
+
+            if size == nil {
+                pending[path] = nil
+            } else if size == entry.size {
+                pending[path] = nil
+                settled.append(path)
+            } else {
+                pending[path] = Pending(lastEvent: now, size: size ?? -1)
+            }
+        }
+        return settled
+    }
+
+    private static func fileSize(_ path: String) -> Int? {
+        let attributes = try? FileManager.default.attributesOfItem(atPath: path)
+        return (attributes?[.size] as? NSNumber)?.intValue
+    }
+}
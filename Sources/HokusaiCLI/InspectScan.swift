@@ -0,0 +1,175 @@
+import Foundation
+import Hokusai
+
+/// PURPOSE: One line of `hokusai inspect --recursive --jsonl` output.
+struct InspectRecord: Codable, Sendable {
+    let path: String
+    let size: Int
+    var format: String?
+    var width: Int?
+    var height: Int?
+    var channels: Int?
+    var space: String?
+    var hasAlpha: Bool?
+    var orientation: Int?
+    var pages: Int?
+    var density: Double?
+    var error: String?
+}
+
+/// PURPOSE: Aggregate view of a recursive inspect run.
+struct InspectSummary: Codable, Sendable {
+    struct Percentiles: Codable, Sendable {
+        let p50: Double
+        let p90: Double
+        let p99: Double
+        let max: Double
+    }
+
+    let files: Int
+    let bytes: Int
+    let elapsedSeconds: Double
+    let formats: [String: Int]
+    let width: Percentiles?
+    let height: Percentiles?
+    let megapixels: Percentiles?
+    let corrupt: [String]
+
+    init(records: [InspectRecord], elapsedSeconds: Double) {
+        let probed = records.filter { $0.error == nil }
+        self.files = records.count
+        self.bytes = records.reduce(0) { $0 + $1.size }
+        self.elapsedSeconds = elapsedSeconds
+        self.formats = Dictionary(probed.map { ($0.format ?? "unknown", 1) }, uniquingKeysWith: +)
+        self.width = Self.percentiles(probed.compactMap { $0.width.map(Double.init) })
+        self.height = Self.percentiles(probed.compactMap { $0.height.map(Double.init) })
+        self.megapixels = Self.percentiles(probed.compactMap { record in
+            guard let width = record.width, let height = record.height else { return nil }
+            return Double(width * height) / 1_000_000
+        })
+        self.corrupt = records.filter { $0.error != nil }.map(\.path).sorted()
+    }
+
+    /// PURPOSE: Nearest-rank percentiles; nil for an empty sample.
+    static func percentiles(_ values: [Double]) -> Percentiles? {
+        guard !values.isEmpty else { return nil }
+        let sorted = values.sorted()
+        func rank(_ fraction: Double) -> Double {
+            let index = Int((fraction * Double(sorted.count)).rounded(.up)) - 1
+            return sorted[min(max(index, 0), sorted.count - 1)]
+        }
+        return Percentiles(p50: rank(0.5), p90: rank(0.9), p99: rank(0.99), max: sorted[sorted.count - 1])
+    }
+}
+
+/// PURPOSE: Header-only probe of a directory tree on a fixed pool of threads.
+/// ALGORITHM:
+/// - `jobs` dedicated threads (not GCD, whose `concurrentPerform` caps width at the
+///   core count) each claim the next file index under a lock, open the header (libvips defers
+///   pixel decoding), and read metadata only.
+/// - Each finished record is handed to `emit` immediately (serialized), so JSONL
+///   streams while the scan runs.
+/// CONSTRAINTS: `emit` runs on worker threads, one call at a time.
+enum InspectScan {
+    static func run(
+        _ files: [JobFile],
+        jobs: Int,
+        emit: @escaping @Sendable (InspectRecord) -> Void
+    ) async -> [InspectRecord] {
+        let state = ScanState(count: files.count)
+        let workers = max(1, min(jobs, files.count))
+
+        guard !files.isEmpty else { return [] }
+
+        await withCheckedContinuation { (continuation: CheckedContinuation<Void, Never>) in
+            state.startWorkers(workers)
+            for worker in 0..<workers {
+                let thread = Thread {
+                    while let index = state.claim() {
+                        let record = probe(files[index])
+                        state.store(record, at: index, emit: emit)
+                    }
+                    if state.workerFinished() {
+                        continuation.resume()
+                    }
+                }
+                thread.name = "hokusai-inspect-\(worker)"
+                thread.start()
+            }
+        }
+        return state.records
+    }
+
+    static func probe(_ file: JobFile) -> InspectRecord {
+        var record = InspectRecord(path: file.relativePath, size: file.size)
+        do {
+            let image = try Hokusai.loadFromFile(file.path)
+            let metadata = try image.metadata()
+            record.format = metadata.format?.rawValue
+            record.width = metadata.width
+            record.height = metadata.height
+            record.channels = metadata.channels
+            record.space = metadata.space
+            record.hasAlpha = metadata.hasAlpha
+            record.orientation = metadata.orientation
+            record.pages = metadata.pages
+            record.density = metadata.density
+        } catch {
+            record.error = String(describing: error)
+        }
+        return record
+    }
+}
+
+/// PURPOSE: Work index and result slots shared by scan workers.
+private final class ScanState: @unchecked Sendable {
+    private let lock = NSLock()
+    private let emitLock = NSLock()
+    private let count: Int
+    private var next = 0
+    private var runningWorkers = 0
+    private var slots: [InspectRecord?]
+
+    init(count: Int) {
+        self.count = count
+        self.slots = Array(repeating: nil, count: count)
+    }
+
+    func startWorkers(_ count: Int) {
+        lock.lock()
+        runningWorkers = count
+        lock.unlock()
+    }
+
+    /// OUTPUT: true for the last worker to finish.
+    func workerFinished() -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        runningWorkers -= 1
+        return runningWorkers == 0
+    }
+
+    func claim() -> Int? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard next < count else { return nil }
+        defer { next += 1 }
+        return next
+    }
+
+    func store(_ record: InspectRecord, at index: Int, emit: (InspectRecord) -> Void) {
+        lock.lock()
+        slots[index] = record
+        lock.unlock()
+
+        emitLock.lock()
+        emit(record)
+        emitLock.unlock()
+    }
+
+    var records: [InspectRecord] {
+        lock.lock()
+        defer { lock.unlock() }
+        return slots.compactMap { $0 }
+    }
+}
@@ -0,0 +1,158 @@
+import Foundation
+import ArgumentParser
+import Hokusai
+
+/// PURPOSE: Image file discovered under a job's input root.
+struct JobFile: Sendable {
+    /// PURPOSE: Absolute (or root-joined) path used for I/O
+    let path: String
+
+    /// PURPOSE: Path relative to the input root; stable identity across machines
+    let relativePath: String
+
+    let size: Int
+    let modified: TimeInterval
+}
+
+/// PURPOSE: Runtime failure in a directory job (watcher setup, manifest I/O).
+struct JobError: Error, CustomStringConvertible {
+    let description: String
+
+    init(_ description: String) {
+        self.description = description
+    }
+}
+
+/// PURPOSE: File discovery, recipe loading, and output naming shared by directory jobs
+/// (`watch`, `batch`).
+/// CONSTRAINTS:
+/// - Only files with a known image extension are considered.
+/// - Hidden files and in-progress downloads (`.part`, `.tmp`, `.crdownload`) are skipped.
+enum JobFiles {
+    private static let partialSuffixes = [".part", ".tmp", ".crdownload", ".partial"]
+
+    static func loadRecipe(_ path: String) throws -> ProcessingRecipe {
+        let data = try Data(contentsOf: URL(fileURLWithPath: path))
+        let recipe = try JSONDecoder().decode(ProcessingRecipe.self, from: data)
+        guard recipe.output.format != nil else {
+            throw ValidationError("Recipe \(path) must set output.format")
+        }
+        return recipe
+    }
+
+    /// PURPOSE: Stable fingerprint of a recipe so manifests notice recipe changes.
+    static func fingerprint(_ recipe: ProcessingRecipe) throws -> String {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.sortedKeys]
+        return ContentHash.hex(ContentHash.fnv1a64(try encoder.encode(recipe)))
+    }
+
+    static func isCandidate(_ path: String) -> Bool {
+        let name = (path as NSString).lastPathComponent
+        guard !name.hasPrefix("."), !partialSuffixes.contains(where: name.hasSuffix) else {
+            return false
+        }
+        return ImageFormat.from(fileExtension: (name as NSString).pathExtension) != nil
+    }
+
+    /// PURPOSE: Recursively list candidate images, skipping `excluding` (e.g. an output dir nested in the input).
+    static func imageFiles(under root: String, excluding: String? = nil) -> [JobFile] {
+        return imageFiles(under: root, excludingAll: excluding.map { [$0] } ?? [])
+    }
+
+    /// PURPOSE: Recursively list candidate images, skipping every directory in `excludingAll`.
+    static func imageFiles(under root: String, excludingAll excluded: [String]) -> [JobFile] {
+        let rootURL = URL(fileURLWithPath: root).standardizedFileURL
+        let excludedPaths = Set(excluded.map { URL(fileURLWithPath: $0).standardizedFileURL.path })
+        let keys: [URLResourceKey] = [.isRegularFileKey, .isDirectoryKey, .fileSizeKey, .contentModificationDateKey]
+
+        guard let enumerator = FileManager.default.enumerator(
+            at: rootURL,
+            includingPropertiesForKeys: keys,
+            options: [.skipsHiddenFiles]
+        ) else {
+            return []
+        }
+
+        var files: [JobFile] = []
+        for case let url as URL in enumerator {
+            let path = url.standardizedFileURL.path
+            guard let values = try? url.resourceValues(forKeys: Set(keys)) else { continue }
+
+            if values.isDirectory == true {
+                if excludedPaths.contains(path) {
+                    enumerator.skipDescendants()
+                }
+                continue
+            }
+
+            guard values.isRegularFile == true, isCandidate(path) else { continue }
+            files.append(JobFile(
+                path: path,
+                relativePath: relativePath(of: path, under: rootURL.path),
+                size: values.fileSize ?? 0,
+                modified: values.contentModificationDate?.timeIntervalSince1970 ?? 0
+            ))
+        }
+        return files
+    }
+
+    /// PURPOSE: Stat a single file; nil when it vanished or is not a regular file.
+    static func jobFile(at path: String, root: String) -> JobFile? {
+        guard let attributes = try? FileManager.default.attributesOfItem(atPath: path),
+              attributes[.type] as? FileAttributeType == .typeRegular else {
+            return nil
+        }
+        let rootPath = URL(fileURLWithPath: root).standardizedFileURL.path
+        return JobFile(
+            path: path,
+            relativePath: relativePath(of: path, under: rootPath),
+            size: (attributes[.size] as? NSNumber)?.intValue ?? 0,
+            modified: (attributes[.modificationDate] as? Date)?.timeIntervalSince1970 ?? 0
+        )
+    }
+
+    /// PURPOSE: Mirror the input layout under `outputDir`, swapping the extension for the recipe format.
+    static func outputPath(for relativePath: String, outputDir: String, format: ImageFormat) -> String {
+        let stem = (relativePath as NSString).deletingPathExtension
+        return (outputDir as NSString).appendingPathComponent("\(stem).\(format.fileExtension)")
+    }
+
+    /// PURPOSE: Write via temp file + rename so readers never observe partial outputs.
+    static func writeOutput(_ data: Data, to path: String) throws {
+        let directory = (path as NSString).deletingLastPathComponent
+        try FileManager.default.createDirectory(atPath: directory, withIntermediateDirectories: true)
+        try data.write(to: URL(fileURLWithPath: path), options: .atomic)
+    }
+
+    // MARK: - Private Helpers
+
+    private static func relativePath(of path: String, under root: String) -> String {
+        let prefix = root.hasSuffix("/") ? root : root + "/"
+        return path.hasPrefix(prefix) ? String(path.dropFirst(prefix.count)) : path
+    }
+}
+
+/// PURPOSE: Fast non-cryptographic content fingerprint for manifests.
+enum ContentHash {
+    /// PURPOSE: FNV-1a 64-bit over the full byte sequence.
+    static func fnv1a64(_ data: Data) -> UInt64 {
+        var hash: UInt64 = 0xcbf2_9ce4_8422_2325
+        data.withUnsafeBytes { raw in
+            for byte in raw {
+                hash ^= UInt64(byte)
+                hash &*= 0x0000_0100_0000_01b3
+            }
+        }
+        return hash
+    }
+
+    static func fnv1a64(_ string: String) -> UInt64 {
+        return fnv1a64(Data(string.utf8))
+    }
+
+    static func hex(_ value: UInt64) -> String {
+        let digits = String(value, radix: 16)
+        return String(repeating: "0", count: max(0, 16 - digits.count)) + digits
+    }
+}
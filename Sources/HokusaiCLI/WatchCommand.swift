@@ -0,0 +1,382 @@
+import Foundation
+import ArgumentParser
+import Hokusai
+import Prompt
+#if canImport(Glibc)
+import Glibc
+#elseif canImport(Darwin)
+import Darwin
+#endif
+
+struct WatchCommand: AsyncParsableCommand {
+    static let configuration = CommandConfiguration(
+        commandName: "watch",
+        abstract: "Process new or modified images in a directory tree as they land."
+    )
+
+    @Option(help: "Directory tree to watch.")
+    var inputDir: String
+
+    @Option(help: "Directory for processed outputs (input layout is mirrored).")
+    var outputDir: String
+
+    @Option(help: "Recipe JSON file (see README: Daemon mode).")
+    var recipe: String
+
+    @Option(help: "Images processed in parallel (default: half the active cores).")
+    var jobs: Int?
+
+    @Option(help: "Milliseconds a file must stay quiet before it is processed.")
+    var debounceMs: Int = 500
+
+    @Flag(help: "Use periodic rescans instead of inotify.")
+    var poll: Bool = false
+
+    @Option(help: "Rescan interval in seconds when polling.")
+    var pollInterval: Double = 2
+
+    @Flag(help: "Process pending files, then exit instead of watching.")
+    var once: Bool = false
+
+    /// PURPOSE: Catch up on files changed since the last run, then follow live changes.
+    mutating func run() async throws {
+        let prompt = PromptService()
+        try Hokusai.initialize()
+        defer { Hokusai.shutdown() }
+
+        let session = try WatchSession(
+            inputDir: inputDir,
+            outputDir: outputDir,
+            recipe: try JobFiles.loadRecipe(self.recipe),
+            workers: Hokusai.workerCount(requested: jobs),
+            debounce: Double(debounceMs) / 1000.0,
+            poll: poll,
+            pollInterval: pollInterval
+        )
+        let knownFiles = await session.manifest.count
+
+        prompt.header("Hokusai Watch")
+        prompt.panel("Watching", items: [
+            ("Input", prompt.path(inputDir)),
+            ("Output", prompt.path(outputDir)),
+            ("Backend", once ? "none (--once)" : session.watcher.backendName),
+            ("Workers", "\(session.workers)"),
+            ("Known files", "\(knownFiles)"),
+        ])
+
+        let trackedFiles = try await session.run(once: once) { outcome in
+            switch outcome {
+            case .processed(let path, let ms):
+                prompt.success("\(path) (\(String(format: "%.1f", ms)) ms)")
+            case .failed(let path, let message):
+                prompt.info("Failed \(path): \(message)")
+            case .unchanged:
+                break
+            }
+        }
+        prompt.summary("Manifest holds \(trackedFiles) files")
+    }
+}
+
+/// PURPOSE: Catch-up scan plus live change loop behind `hokusai watch`, without the
+/// command's libvips lifecycle or terminal output.
+/// ALGORITHM:
+/// - The watcher is attached before the catch-up scan, so files landing during the
+///   scan are reported; `InFlightPaths` folds the resulting duplicates.
+/// - Up to `workers` paths are processed at once, never the same path twice at once.
+/// - Live mode ends on SIGINT/SIGTERM: the change stream finishes, running files
+///   complete, and the manifest is flushed and closed.
+struct WatchSession {
+    let inputDir: String
+    let outputDir: String
+    let workers: Int
+    let debounce: TimeInterval
+    let manifest: WatchManifest
+    let watcher: DirectoryWatcher
+    private let processor: WatchProcessor
+
+    init(
+        inputDir: String,
+        outputDir: String,
+        recipe: ProcessingRecipe,
+        workers: Int,
+        debounce: TimeInterval,
+        poll: Bool = false,
+        pollInterval: TimeInterval = 2
+    ) throws {
+        self.inputDir = inputDir
+        self.outputDir = outputDir
+        self.workers = max(1, workers)
+        self.debounce = debounce
+        self.manifest = try WatchManifest(
+            path: (outputDir as NSString).appendingPathComponent(".hokusai-manifest.jsonl"),
+            recipeFingerprint: try JobFiles.fingerprint(recipe)
+        )
+        self.watcher = DirectoryWatcher(
+            root: inputDir,
+            excluding: outputDir,
+            forcePolling: poll,
+            pollInterval: pollInterval
+        )
+        self.processor = WatchProcessor(
+            inputDir: inputDir,
+            outputDir: outputDir,
+            recipe: recipe,
+            manifest: manifest,
+            concurrentRuns: self.workers
+        )
+    }
+
+    /// PURPOSE: Process pending files, then (unless `once`) follow changes until SIGINT/SIGTERM.
+    /// OUTPUT: Files tracked by the manifest after it is closed.
+    func run(once: Bool, report: (WatchOutcome) -> Void) async throws -> Int {
+        let (changes, continuation) = AsyncStream<String>.makeStream()
+        let paths = InFlightPaths()
+        let enqueue: @Sendable (String) -> Void = { path in
+            if paths.offer(path) {
+                continuation.yield(path)
+            }
+        }
+
+        var ticker: Task<Void, Never>?
+        var signalSources: [DispatchSourceSignal] = []
+        defer {
+            ticker?.cancel()
+            signalSources.forEach { $0.cancel() }
+        }
+
+        if !once {
+            let debouncer = ChangeDebouncer(quietPeriod: debounce)
+            try watcher.start { path in debouncer.note(path) }
+            let tick = max(0.05, debounce / 4)
+            ticker = Task {
+                while !Task.isCancelled {
+                    try? await Task.sleep(nanoseconds: UInt64(tick * 1_000_000_000))
+                    for path in debouncer.takeSettled() {
+                        enqueue(path)
+                    }
+                }
+            }
+
+            for signalNumber in [SIGINT, SIGTERM] {
+                signal(signalNumber, SIG_IGN)
+                let source = DispatchSource.makeSignalSource(signal: signalNumber, queue: .global())
+                source.setEventHandler {
+                    continuation.finish()
+                }
+                source.resume()
+                signalSources.append(source)
+            }
+        }
+
+        // PURPOSE: Catch-up pass; size/mtime matches skip files without reading them.
+        for file in JobFiles.imageFiles(under: inputDir, excluding: outputDir) {
+            enqueue(file.path)
+        }
+        if once {
+            continuation.finish()
+        }
+
+        let processor = self.processor
+        await withTaskGroup(of: WatchOutcome.self) { group in
+            var running = 0
+            for await path in changes {
+                if running >= workers, let outcome = await group.next() {
+                    running -= 1
+                    report(outcome)
+                }
+                paths.begin(path)
+                group.addTask {
+                    let outcome = await processor.handle(path)
+                    // PURPOSE: A change noted mid-run is processed again with the new bytes.
+                    if paths.finish(path) {
+                        enqueue(path)
+                    }
+                    return outcome
+                }
+                running += 1
+            }
+
+            for await outcome in group {
+                report(outcome)
+            }
+        }
+
+        try await manifest.close()
+        return await manifest.count
+    }
+}
+
+/// PURPOSE: Queued and running paths of a watch session.
+/// ALGORITHM:
+/// - A path already queued is not queued again.
+/// - A path offered while running is remembered and handed back by `finish`.
+/// CONSTRAINTS: Thread-safe; offered from the watcher ticker and worker tasks.
+final class InFlightPaths: @unchecked Sendable {
+    private let lock = NSLock()
+    private var queued: Set<String> = []
+    private var running: Set<String> = []
+    private var changedWhileRunning: Set<String> = []
+
+    /// OUTPUT: true if the caller should queue `path`.
+    func offer(_ path: String) -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        if running.contains(path) {
+            changedWhileRunning.insert(path)
+            return false
+        }
+        return queued.insert(path).inserted
+    }
+
+    func begin(_ path: String) {
+        lock.lock()
+        defer { lock.unlock() }
+        queued.remove(path)
+        running.insert(path)
+    }
+
+    /// OUTPUT: true if `path` was offered again while it ran.
+    func finish(_ path: String) -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        running.remove(path)
+        return changedWhileRunning.remove(path) != nil
+    }
+}
+
+/// PURPOSE: Per-file result reported by the watch loop.
+enum WatchOutcome: Sendable {
+    case processed(String, ms: Double)
+    case unchanged
+    case failed(String, String)
+}
+
+/// PURPOSE: Process one changed path if its contents or the recipe differ from the manifest.
+/// ALGORITHM:
+/// - size + mtime match the manifest: skip without reading.
+/// - Otherwise hash the bytes (FNV-1a 64); an identical hash only refreshes size/mtime.
+/// - Else run the recipe, write the output atomically, and append a manifest entry.
+struct WatchProcessor: Sendable {
+    let inputDir: String
+    let outputDir: String
+    let recipe: ProcessingRecipe
+    let manifest: WatchManifest
+
+    /// PURPOSE: Files the session processes at once; splits libvips threads between them
+    let concurrentRuns: Int
+
+    func handle(_ path: String) async -> WatchOutcome {
+        guard let file = JobFiles.jobFile(at: path, root: inputDir), let format = recipe.output.format else {
+            return .unchanged
+        }
+
+        let outputPath = JobFiles.outputPath(for: file.relativePath, outputDir: outputDir, format: format)
+        let known = await manifest.entry(for: file.relativePath)
+        let outputExists = FileManager.default.fileExists(atPath: outputPath)
+        if let known, outputExists, known.size == file.size, known.modified == file.modified {
+            return .unchanged
+        }
+
+        do {
+            let start = DispatchTime.now().uptimeNanoseconds
+            let data = try Data(contentsOf: URL(fileURLWithPath: file.path))
+            let hash = ContentHash.hex(ContentHash.fnv1a64(data))
+
+            if let known, outputExists, known.hash == hash {
+                try await manifest.record(file, hash: hash)
+                return .unchanged
+            }
+
+            let encoded = try recipe.run(.data(data), concurrentRuns: concurrentRuns)
+            try JobFiles.writeOutput(encoded, to: outputPath)
+            try await manifest.record(file, hash: hash)
+
+            let elapsedMs = Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000.0
+            return .processed(file.relativePath, ms: elapsedMs)
+        } catch {
+            return .failed(file.relativePath, String(describing: error))
+        }
+    }
+}
+
+/// PURPOSE: Append-only content-hash manifest that lets restarts skip unchanged files.
+/// CONSTRAINTS:
+/// - JSON Lines; the last entry for a path wins. Compacted on open.
+/// - Entries written under a different recipe fingerprint are discarded on open.
+actor WatchManifest {
+    struct Entry: Codable, Sendable {
+        let path: String
+        let size: Int
+        let modified: TimeInterval
+        let hash: String
+        let recipe: String
+    }
+
+    private let recipeFingerprint: String
+    private var entries: [String: Entry] = [:]
+    private let handle: FileHandle
+
+    init(path: String, recipeFingerprint: String) throws {
+        self.recipeFingerprint = recipeFingerprint
+
+        let url = URL(fileURLWithPath: path)
+        try FileManager.default.createDirectory(
+            at: url.deletingLastPathComponent(),
+            withIntermediateDirectories: true
+        )
+
+        var loaded: [String: Entry] = [:]
+        if let existing = try? String(contentsOf: url, encoding: .utf8) {
+            let decoder = JSONDecoder()
+            for line in existing.split(separator: "\n") {
+                guard let entry = try? decoder.decode(Entry.self, from: Data(line.utf8)),
+                      entry.recipe == recipeFingerprint else { continue }
+                loaded[entry.path] = entry
+            }
+        }
+        self.entries = loaded
+
+        let encoder = JSONEncoder()
+        var compacted = Data()
+        for entry in loaded.values.sorted(by: { $0.path < $1.path }) {
+            compacted.append(try encoder.encode(entry))
+            compacted.append(0x0A)
+        }
+        try compacted.write(to: url, options: .atomic)
+
+        guard let handle = FileHandle(forWritingAtPath: path) else {
+            throw JobError("Cannot open manifest for writing: \(path)")
+        }
+        handle.seekToEndOfFile()
+        self.handle = handle
+    }
+
+    var count: Int {
+        return entries.count
+    }
+
+    func entry(for relativePath: String) -> Entry? {
+        return entries[relativePath]
+    }
+
+    func record(_ file: JobFile, hash: String) throws {
+        let entry = Entry(
+            path: file.relativePath,
+            size: file.size,
+            modified: file.modified,
+            hash: hash,
+            recipe: recipeFingerprint
+        )
+        entries[entry.path] = entry
+
+        var line = try JSONEncoder().encode(entry)
+        line.append(0x0A)
+        handle.write(line)
+    }
+
+    func close() throws {
+        try handle.synchronize()
+        try handle.close()
+    }
+}
@@ -23,6 +23,10 @@ struct HokusaiCLI: AsyncParsableCommand {
             CropCommand.self,
             TextCommand.self,
             BenchmarkCommand.self,
+            DaemonCommand.self,
+            ClientCommand.self,
+            WatchCommand.self,
+            BatchCommand.self,
         ]
     )
 }
@@ -55,25 +59,107 @@ struct InspectCommand: AsyncParsableCommand {
     )
 
     @Option(name: .shortAndLong, help: "Input image path.")
-    var input: String
+    var input: String?
+
+    @Option(help: "Also list header fields matching this glob, e.g. 'exif-*'.")
+    var fields: String?
+
+    @Option(help: "Probe every image under this directory instead of a single file.")
+    var recursive: String?
+
+    @Flag(help: "With --recursive: print one JSON object per file, then a {\"summary\": ...} line.")
+    var jsonl = false
+
+    @Option(help: "With --recursive: files probed in parallel (default: 2x cores).")
+    var jobs: Int?
 
-    /// PURPOSE: Show decoded metadata for a local image file.
+    mutating func validate() throws {
+        guard (input == nil) != (recursive == nil) else {
+            throw ValidationError("Pass exactly one of --input or --recursive")
+        }
+    }
+
+    /// PURPOSE: Show header metadata for a local image file (pixels are never decoded).
     mutating func run() async throws {
         let prompt = PromptService()
         try Hokusai.initialize()
         defer { Hokusai.shutdown() }
 
+        if let recursive {
+            try await inspectTree(recursive, prompt: prompt)
+            return
+        }
+        guard let input else { return }
+
         let image = try Hokusai.loadFromFile(input)
         let metadata = try image.metadata()
 
-        prompt.header("Image Metadata")
-        prompt.panel(prompt.path(input), items: [
+        var items: [(String, String)] = [
             ("Width", "\(metadata.width) px"),
             ("Height", "\(metadata.height) px"),
             ("Channels", "\(metadata.channels)"),
             ("Has Alpha", metadata.hasAlpha ? "yes" : "no"),
             ("Format", metadata.format?.rawValue ?? "unknown"),
+            ("Orientation", "\(try image.orientation)"),
+        ]
+        if let profile = try image.iccProfile() {
+            items.append(("ICC Profile", "\(profile.count) bytes"))
+        }
+        for tag in ["Make", "Model", "DateTimeOriginal"] {
+            if let value = try image.exif(tag: tag) {
+                items.append((tag, value))
+            }
+        }
+
+        prompt.header("Image Metadata")
+        prompt.panel(prompt.path(input), items: items)
+
+        if let fields {
+            let matched = try image.fields(matching: fields)
+            prompt.panel("Fields matching \(fields)", items: matched.keys.sorted().map { ($0, matched[$0] ?? "") })
+        }
+    }
+
+    /// PURPOSE: Header-only audit of a directory tree with optional JSONL streaming.
+    private func inspectTree(_ root: String, prompt: PromptService) async throws {
+        let files = JobFiles.imageFiles(under: root)
+        // PURPOSE: Header probes are I/O-bound; oversubscribe cores to keep the disk queue full.
+        let workers = jobs ?? ProcessInfo.processInfo.activeProcessorCount * 2
+        let streamJSON = jsonl
+
+        let start = DispatchTime.now().uptimeNanoseconds
+        let records = await InspectScan.run(files, jobs: workers) { record in
+            guard streamJSON, let line = try? JSONEncoder().encode(record) else { return }
+            FileHandle.standardOutput.write(line + Data("\n".utf8))
+        }
+        let elapsed = Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000_000.0
+        let summary = InspectSummary(records: records, elapsedSeconds: elapsed)
+
+        if streamJSON {
+            let encoder = JSONEncoder()
+            encoder.outputFormatting = [.sortedKeys]
+            FileHandle.standardOutput.write(try encoder.encode(["summary": summary]) + Data("\n".utf8))
+            return
+        }
+
+        func describe(_ values: InspectSummary.Percentiles?) -> String {
+            guard let values else { return "-" }
+            return String(format: "p50 %.0f / p90 %.0f / p99 %.0f / max %.0f", values.p50, values.p90, values.p99, values.max)
+        }
+
+        prompt.header("Image Audit")
+        prompt.panel(prompt.path(root), items: [
+            ("Files", "\(summary.files)"),
+            ("Rate", String(format: "%.0f files/s", Double(summary.files) / max(elapsed, 0.001))),
+            ("Width", describe(summary.width)),
+            ("Height", describe(summary.height)),
+            ("Megapixels", summary.megapixels.map {
+                String(format: "p50 %.2f / p90 %.2f / p99 %.2f / max %.2f", $0.p50, $0.p90, $0.p99, $0.max)
+            } ?? "-"),
+            ("Corrupt", "\(summary.corrupt.count)"),
         ])
+        prompt.panel("Formats", items: summary.formats.sorted { $0.value > $1.value }.map { ($0.key, "\($0.value)") })
+        for path in summary.corrupt.prefix(20) { prompt.item("corrupt: \(path)") }
     }
 }
 
@@ -107,6 +193,9 @@ struct ResizeCommand: AsyncParsableCommand {
     @Flag(help: "Prevent downscaling.")
     var withoutReduction = false
 
+    @Option(help: "Sharpen after resizing: auto or sigma,m1,m2.")
+    var sharpen: String?
+
     /// PURPOSE: Resize an input image and save to destination path.
     mutating func run() async throws {
         let prompt = PromptService()
@@ -120,6 +209,7 @@ struct ResizeCommand: AsyncParsableCommand {
         options.kernel = CLIParser.parseKernel(kernel)
         options.withoutEnlargement = withoutEnlargement
         options.withoutReduction = withoutReduction
+        options.sharpen = try sharpen.map(CLIParser.parseSharpen)
 
         let resized = try image.resize(width: width, height: height, options: options)
         try resized.toFile(output)
@@ -157,9 +247,12 @@ struct ConvertCommand: AsyncParsableCommand {
     @Flag(help: "Use progressive/interlaced output when supported.")
     var progressive = false
 
-    @Flag(help: "Strip metadata where supported.")
+    @Flag(help: "Strip all metadata.")
     var stripMetadata = false
 
+    @Option(help: "Keep only these metadata kinds (comma-separated): exif,xmp,iptc,icc,other,copyright,orientation")
+    var keepMetadata: String?
+
     @Flag(help: "Use lossless mode where supported.")
     var lossless = false
 
@@ -180,6 +273,9 @@ struct ConvertCommand: AsyncParsableCommand {
         options.compression = compression
         options.progressive = progressive
         options.stripMetadata = stripMetadata
+        if let keepMetadata {
+            options.metadata = .keep(try CLIParser.parseMetadataKinds(keepMetadata))
+        }
         options.lossless = lossless
         options.effort = effort
 
@@ -212,6 +308,9 @@ struct RotateCommand: AsyncParsableCommand {
     @Option(help: "Optional background RGBA (comma-separated), e.g. 255,255,255,255")
     var background: String?
 
+    @Flag(help: "Crop to the largest rectangle without background corners.")
+    var cropToContent = false
+
     /// PURPOSE: Rotate image by arbitrary degree angle and save result.
     mutating func run() async throws {
         let prompt = PromptService()
@@ -220,7 +319,7 @@ struct RotateCommand: AsyncParsableCommand {
 
         let image = try Hokusai.loadFromFile(input)
         let bg = try background.map(CLIParser.parseRGBA)
-        let rotated = try image.rotate(angle: .custom(angle), background: bg)
+        let rotated = try image.rotate(angle: .custom(angle), cropToContent: cropToContent, background: bg)
         try rotated.toFile(output)
 
         prompt.success("Saved rotated image")
@@ -572,10 +671,18 @@ struct BenchmarkSuiteCommand: AsyncParsableCommand {
         )
 
         if let jsonOutput {
+            // PURPOSE: Input geometry lets `CostModel.calibrated(fromBenchmarkSuite:)` fit coefficients.
+            let probe = try Hokusai.loadFromFile(inputPath).metadata()
             let payload = BenchmarkSuitePayload(
                 generatedAt: ISO8601DateFormatter().string(from: Date()),
                 warmup: warmup,
                 iterations: iterations,
+                input: BenchmarkInputInfo(
+                    width: probe.width,
+                    height: probe.height,
+                    channels: probe.channels,
+                    format: probe.format?.rawValue
+                ),
                 cases: jsonCases
             )
             try BenchmarkRunner.writeJSON(payload, to: jsonOutput)
@@ -712,10 +819,18 @@ struct BenchmarkSuiteCaseResult: Encodable {
     let samplesMs: [Double]
 }
 
+struct BenchmarkInputInfo: Encodable {
+    let width: Int
+    let height: Int
+    let channels: Int
+    let format: String?
+}
+
 struct BenchmarkSuitePayload: Encodable {
     let generatedAt: String
     let warmup: Int
     let iterations: Int
+    let input: BenchmarkInputInfo
     let cases: [BenchmarkSuiteCaseResult]
 }
 
@@ -742,6 +857,34 @@ enum CLIParser {
         }
     }
 
+    static func parseMetadataKinds(_ value: String) throws -> MetadataKinds {
+        var kinds: MetadataKinds = []
+        for name in value.lowercased().split(separator: ",") {
+            switch name.trimmingCharacters(in: .whitespaces) {
+            case "exif": kinds.insert(.exif)
+            case "xmp": kinds.insert(.xmp)
+            case "iptc": kinds.insert(.iptc)
+            case "icc": kinds.insert(.icc)
+            case "other": kinds.insert(.other)
+            case "copyright": kinds.insert(.copyright)
+            case "orientation": kinds.insert(.orientation)
+            default: throw ValidationError("Unknown metadata kind: \(name)")
+            }
+        }
+        return kinds
+    }
+
+    static func parseSharpen(_ value: String) throws -> SharpenMode {
+        if value.lowercased() == "auto" {
+            return .auto
+        }
+        let parts = value.split(separator: ",").compactMap { Double($0.trimmingCharacters(in: .whitespaces)) }
+        guard parts.count == 3 else {
+            throw ValidationError("Sharpen must be auto or sigma,m1,m2: \(value)")
+        }
+        return .custom(sigma: parts[0], m1: parts[1], m2: parts[2])
+    }
+
     static func parseTextAlign(_ value: String) -> TextAlignment {
         switch value.lowercased() {
         case "center": return .center
@@ -1,6 +1,7 @@
 import Foundation
 import XCTest
 @testable import Hokusai
+@testable import HokusaiCLI
 
 private actor HokusaiTestRuntime {
     static let shared = HokusaiTestRuntime()
@@ -82,4 +83,826 @@ final class HokusaiTests: XCTestCase {
         XCTAssertEqual(try output.height, 128)
         XCTAssertFalse(png.isEmpty)
     }
+
+    func testBatchProcessReportsPerItemResults() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let data = try loadFixtureData(named: "pixel", ext: "png")
+        let recipe = ProcessingRecipe(
+            steps: [.resize(ResizeOptions(width: 4, height: 4, fit: .fill))],
+            output: SaveOptions(format: .png)
+        )
+        let inputs: [ImageInput] = [.data(data), .data(Data([0x00, 0x01, 0x02])), .data(data)]
+
+        var outputs: [BatchOutput] = []
+        for try await output in Hokusai.process(inputs, recipe: recipe, maxConcurrency: 2, memoryBudget: 1) {
+            outputs.append(output)
+        }
+
+        XCTAssertEqual(outputs.count, 3)
+        XCTAssertEqual(outputs.filter { $0.data != nil }.count, 2)
+        XCTAssertNil(outputs.first { $0.index == 1 }?.data)
+    }
+
+    func testStagedPipelineRunsAllStages() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let data = try loadFixtureData(named: "pixel", ext: "png")
+        let recipe = ProcessingRecipe(
+            steps: [.resize(ResizeOptions(width: 4, height: 4, fit: .fill))],
+            output: SaveOptions(format: .png)
+        )
+        let pipeline = StagedPipeline(recipe: recipe)
+
+        var encoded = 0
+        for try await output in pipeline.process([ImageInput](repeating: .data(data), count: 3)) {
+            if output.data != nil { encoded += 1 }
+        }
+
+        let statistics = await pipeline.statistics()
+        XCTAssertEqual(encoded, 3)
+        XCTAssertEqual(statistics.map(\.stage), PipelineStage.allCases)
+        XCTAssertTrue(statistics.allSatisfy { $0.processed == 3 })
+    }
+
+    func testStageThreadBudgetSplitsThreadsAcrossStageWorkers() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let budget = StageThreadBudget()
+        budget.setWorkers(1, for: .decode)
+        let single = budget.threadsPerImage
+        budget.setWorkers(2, for: .transform)
+        budget.setWorkers(64, for: .encode)
+
+        XCTAssertEqual(single, BatchLimits.vipsThreads(forWorkers: 1))
+        XCTAssertEqual(budget.threadsPerImage, BatchLimits.vipsThreads(forWorkers: 67))
+    }
+
+    func testExecutorTracksQueueLatencyPerClass() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let data = try loadFixtureData(named: "pixel", ext: "png")
+        let recipe = ProcessingRecipe(output: SaveOptions(format: .png))
+        let executor = ProcessingExecutor(configuration: ProcessingExecutorConfiguration(maxConcurrent: 2))
+
+        async let bulk = executor.submit(.data(data), recipe: recipe, priority: .batch, tenant: "backfill")
+        async let thumb = executor.submit(.data(data), recipe: recipe, priority: .interactive, tenant: "web")
+        let outputs = try await [bulk, thumb]
+
+        let statistics = await executor.queueLatencyStatistics()
+        XCTAssertTrue(outputs.allSatisfy { !$0.isEmpty })
+        XCTAssertEqual(statistics.first { $0.priority == .interactive }?.dispatched, 3)
+        XCTAssertEqual(statistics.first { $0.priority == .batch }?.dispatched, 3)
+        XCTAssertTrue(statistics.allSatisfy { $0.waiting == 0 })
+    }
+
+    func testEstimateCostPlansShrinkAndOutputSize() throws {
+        let probe = ImageMetadata(width: 4000, height: 3000, channels: 3, format: .jpeg)
+        let recipe = ProcessingRecipe(
+            steps: [.resize(ResizeOptions(width: 400, height: 300, fit: .cover))],
+            output: SaveOptions(format: .webp)
+        )
+
+        let estimate = try Hokusai.estimateCost(probe: probe, recipe: recipe)
+
+        XCTAssertEqual(estimate.inputPixels, 12_000_000)
+        XCTAssertEqual(estimate.decodeShrink, 4)
+        XCTAssertEqual(estimate.outputPixels, 120_000)
+        XCTAssertEqual(estimate.operations.map(\.operation), ["decode.jpeg", "resize", "encode.webp"])
+        XCTAssertGreaterThan(estimate.peakMemoryBytes, estimate.decodedPixels * 3)
+    }
+
+    func testRecipeDecodesFromDaemonJSON() throws {
+        let json = Data("""
+        {"steps": [{"op": "resize", "width": 320, "fit": "contain"},
+                   {"op": "rotate", "angle": 90},
+                   {"op": "flip", "direction": "horizontal"}],
+         "output": {"format": "webp", "quality": 75}}
+        """.utf8)
+
+        let recipe = try JSONDecoder().decode(ProcessingRecipe.self, from: json)
+        let roundTripped = try JSONDecoder().decode(ProcessingRecipe.self, from: JSONEncoder().encode(recipe))
+
+        for decoded in [recipe, roundTripped] {
+            XCTAssertEqual(decoded.steps.count, 3)
+            guard case .resize(let options) = decoded.steps[0] else {
+                return XCTFail("Expected resize step")
+            }
+            XCTAssertEqual(options.width, 320)
+            XCTAssertEqual(options.fit, .contain)
+            XCTAssertEqual(options.kernel, .lanczos3)
+            guard case .rotate(let angle, _) = decoded.steps[1] else {
+                return XCTFail("Expected rotate step")
+            }
+            XCTAssertEqual(angle.degrees, 90)
+            XCTAssertEqual(decoded.output.format, .webp)
+            XCTAssertEqual(decoded.output.quality, 75)
+        }
+    }
+
+    func testPrefetchedBatchWritesOutputs() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let data = try loadFixtureData(named: "pixel", ext: "png")
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent("hokusai-prefetch-\(UUID().uuidString)")
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let paths = (0..<4).map { directory.appendingPathComponent("in-\($0).png").path }
+        for path in paths {
+            try data.write(to: URL(fileURLWithPath: path))
+        }
+        let inputs = (paths + [directory.appendingPathComponent("missing.png").path]).map { ImageInput.file($0) }
+        let recipe = ProcessingRecipe(
+            steps: [.resize(ResizeOptions(width: 4, height: 4, fit: .fill))],
+            output: SaveOptions(format: .png)
+        )
+
+        for backend in [IOBackend.threads, .automatic] {
+            let writer = BatchWriter(backend: backend, batchSize: 2)
+            var failures = 0
+            let prefetch = PrefetchOptions(depth: 2, backend: backend)
+            for try await output in Hokusai.process(inputs, recipe: recipe, maxConcurrency: 2, prefetch: prefetch) {
+                guard let encoded = output.data else {
+                    failures += 1
+                    continue
+                }
+                writer.write(encoded, to: directory.appendingPathComponent("\(backend.rawValue)/out-\(output.index).png").path)
+            }
+            try await writer.finish()
+
+            XCTAssertEqual(failures, 1)
+            XCTAssertEqual(writer.writtenCount, 4)
+            let written = try Hokusai.loadFromFile(directory.appendingPathComponent("\(backend.rawValue)/out-0.png").path)
+            XCTAssertEqual(try written.width, 4)
+        }
+    }
+
+    func testLoadMappedOutlivesSourceScope() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let data = try loadFixtureData(named: "pixel", ext: "png")
+        let path = FileManager.default.temporaryDirectory
+            .appendingPathComponent("hokusai-mapped-\(UUID().uuidString).png").path
+        try data.write(to: URL(fileURLWithPath: path))
+        defer { try? FileManager.default.removeItem(atPath: path) }
+
+        let resized: HokusaiImage
+        do {
+            let image = try Hokusai.loadMapped(path: path)
+            resized = try image.resize(width: 3, height: 3)
+        }
+        XCTAssertEqual(try resized.width, 3)
+        XCTAssertFalse(try resized.toBuffer(options: SaveOptions(format: .png)).isEmpty)
+        XCTAssertThrowsError(try Hokusai.loadMapped(path: path + ".missing"))
+    }
+
+    func testPooledEncodeBuffersStayIndependent() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let data = try loadFixtureData(named: "pixel", ext: "png")
+        let image = try Hokusai.loadFromBuffer(data)
+
+        let small = try image.resize(width: 2, height: 2).toBuffer(options: SaveOptions(format: .png))
+        let snapshot = Data(small)
+        let large = try image.resize(width: 64, height: 64).toBuffer(options: SaveOptions(format: .png))
+
+        XCTAssertEqual(small, snapshot)
+        XCTAssertEqual(try Hokusai.loadFromBuffer(small).width, 2)
+        XCTAssertEqual(try Hokusai.loadFromBuffer(large).width, 64)
+    }
+
+    func testEncodeDigestsMatchOutputBytes() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        let options = SaveOptions(format: .png)
+
+        let encoded = try image.toBuffer(options: options, hashing: [.sha256, .xxHash64])
+        XCTAssertEqual(encoded.data, try image.toBuffer(options: options))
+        XCTAssertEqual(encoded.digest, StreamingDigest.digest(of: encoded.data, algorithms: [.sha256, .xxHash64]))
+        XCTAssertEqual(encoded.digest.etag, "\"\(encoded.digest.sha256 ?? "")\"")
+
+        let path = FileManager.default.temporaryDirectory
+            .appendingPathComponent("hokusai-digest-\(UUID().uuidString).png").path
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        let fileDigest = try image.toFile(path, options: options, hashing: [.xxHash64])
+        let written = try Data(contentsOf: URL(fileURLWithPath: path))
+        XCTAssertEqual(fileDigest, StreamingDigest.digest(of: written, algorithms: [.xxHash64]))
+
+        let empty = StreamingDigest.digest(of: Data(), algorithms: [.sha256, .xxHash64])
+        XCTAssertEqual(empty.sha256, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855")
+        XCTAssertEqual(empty.xxHash64, "ef46db3751d8e999")
+    }
+
+    func testLazyMetadataAccessors() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+
+        XCTAssertEqual(try image.orientation, 1)
+        XCTAssertNil(try image.exif(tag: "Model"))
+        XCTAssertNil(try image.xmp())
+        XCTAssertEqual(try image.fields(matching: "width"), ["width": "1"])
+        XCTAssertTrue(try image.fields(matching: "exif-*").isEmpty)
+
+        XCTAssertEqual(HokusaiImage.exifValue("Canon (Canon, ASCII, 6 components, 6 bytes)"), "Canon")
+        XCTAssertEqual(HokusaiImage.exifValue("6 (Right-top, Short, 1 components, 2 bytes)"), "6")
+        XCTAssertEqual(HokusaiImage.exifValue("1/200 (1/200 sec., Rational, 1 components, 8 bytes)"), "1/200")
+    }
+
+    func testMetadataPolicyRoundTripsAndSaves() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let legacy = try JSONDecoder().decode(SaveOptions.self, from: Data(#"{"format": "png", "stripMetadata": true}"#.utf8))
+        XCTAssertEqual(legacy.metadata, .strip)
+
+        let options = SaveOptions(format: .png, metadata: .keep([.icc, .orientation]))
+        let decoded = try JSONDecoder().decode(SaveOptions.self, from: JSONEncoder().encode(options))
+        XCTAssertEqual(decoded.metadata, .keep([.icc, .orientation]))
+        XCTAssertFalse(decoded.stripMetadata)
+
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        for policy: MetadataPolicy in [.all, .strip, .keep([.icc, .orientation])] {
+            let data = try image.toBuffer(options: SaveOptions(format: .png, metadata: policy))
+            XCTAssertEqual(try Hokusai.loadFromBuffer(data).width, 1)
+            XCTAssertNil(try Hokusai.loadFromBuffer(data).exif(tag: "Model"))
+        }
+    }
+
+    func testColorspaceConversionAndProfileCache() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        let converted = try image.toColorspace(.sRGB, intent: .perceptual)
+        XCTAssertEqual(converted.width, 1)
+        XCTAssertEqual(converted.bands, 4)
+
+        let cache = ICCProfileCache()
+        let profile = Data("not-a-real-profile".utf8)
+        let first = try cache.path(for: profile)
+        XCTAssertEqual(try cache.path(for: profile), first)
+        XCTAssertEqual(cache.count, 1)
+        let directory = (first as NSString).deletingLastPathComponent
+        let permissions = try FileManager.default.attributesOfItem(atPath: directory)[.posixPermissions] as? NSNumber
+        XCTAssertEqual(permissions?.intValue, 0o700)
+        XCTAssertNotEqual(directory, (NSTemporaryDirectory() as NSString).standardizingPath)
+        XCTAssertEqual(try cache.name(for: .sRGB), "srgb")
+        cache.purge()
+        XCTAssertFalse(FileManager.default.fileExists(atPath: first))
+    }
+
+    func testEmbeddedProfilesReuseTheProfileCache() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        let tagged = try Hokusai.loadFromBuffer(image.toColorspace(.displayP3).toBuffer(options: SaveOptions(format: .png, metadata: .all)))
+
+        _ = try tagged.toColorspace(.sRGB).toBuffer(options: SaveOptions(format: .png))
+        let profiles = ICCProfileCache.shared.count
+        _ = try tagged.toColorspace(.sRGB).toBuffer(options: SaveOptions(format: .png))
+
+        XCTAssertGreaterThan(profiles, 0)
+        XCTAssertEqual(ICCProfileCache.shared.count, profiles)
+    }
+
+    func testContactSheetAndSpriteAtlas() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let pixel = try loadFixtureData(named: "pixel", ext: "png")
+        let inputs = Array(repeating: ImageInput.data(pixel), count: 3)
+
+        let sheet = try Hokusai.contactSheet(images: inputs, columns: 2, cellSize: 16, spacing: 2)
+        XCTAssertEqual(try sheet.width, 34)
+        XCTAssertEqual(try sheet.height, 34)
+
+        let atlas = try Hokusai.spriteAtlas(images: inputs, maxSize: 64)
+        XCTAssertEqual(atlas.frames.count, 3)
+        XCTAssertEqual(Set(atlas.frames.map { "\($0.x),\($0.y)" }).count, 3)
+        XCTAssertEqual(try atlas.image.width, atlas.width)
+        let map = try JSONSerialization.jsonObject(with: atlas.jsonMap()) as? [String: Any]
+        XCTAssertEqual((map?["frames"] as? [Any])?.count, 3)
+        XCTAssertEqual(atlas.frames.map(\.name), ["image-0", "image-1", "image-2"])
+
+        let named = try Hokusai.spriteAtlas(images: inputs, names: ["a", "b", "c"], maxSize: 64)
+        XCTAssertEqual(named.frames.map(\.name), ["a", "b", "c"])
+        XCTAssertThrowsError(try Hokusai.spriteAtlas(images: inputs, names: ["a", "a", "c"], maxSize: 64))
+        XCTAssertEqual(
+            try Montage.frameNames(for: [.file("x/icon.png"), .file("y/icon.png"), .file("z/logo.png")], names: nil),
+            ["icon-0", "icon-1", "logo"]
+        )
+
+        var packer = SkylinePacker(width: 10)
+        XCTAssertEqual(packer.insert(width: 6, height: 4)?.x, 0)
+        XCTAssertEqual(packer.insert(width: 4, height: 2)?.x, 6)
+        let third = packer.insert(width: 4, height: 2)
+        XCTAssertEqual(third?.x, 6)
+        XCTAssertEqual(third?.y, 2)
+        XCTAssertNil(packer.insert(width: 11, height: 1))
+        XCTAssertEqual(packer.height, 4)
+    }
+
+    func testAnimateEncodesEveryFrame() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let pixel = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        let frames = [pixel, pixel, pixel]
+
+        for format in [ImageFormat.gif, .webp] {
+            let data = try Hokusai.animate(frames: frames, delays: [100], loop: 0, format: format)
+            let decoded = try Hokusai.loadFromBuffer(data)
+            XCTAssertEqual(try decoded.width, 1)
+            XCTAssertEqual(try decoded.metadata().pages, 3)
+        }
+
+        XCTAssertThrowsError(try Hokusai.animate(frames: frames, delays: [100, 100], format: .gif))
+        XCTAssertThrowsError(try Hokusai.animate(frames: frames, delays: [100], format: .png))
+        XCTAssertThrowsError(try Hokusai.animate(
+            frames: frames,
+            delays: [100],
+            format: .webp,
+            options: AnimationOptions(keyframeInterval: 5...5)
+        ))
+    }
+
+    func testAdjustBuildsSharedLookupTables() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        let adjusted = try image.adjust(brightness: 0.1, contrast: 1.2, gamma: 1.1)
+        XCTAssertEqual(try adjusted.bands, 4)
+        XCTAssertEqual(try adjusted.width, 1)
+
+        let curve = ToneCurve(brightness: 0, contrast: 1, gamma: 1, levels: ToneLevels(inputBlack: 0.25, inputWhite: 0.75))
+        XCTAssertEqual(curve.apply(0.1), 0)
+        XCTAssertEqual(curve.apply(0.5), 0.5, accuracy: 1e-9)
+        XCTAssertEqual(curve.apply(0.9), 1)
+        XCTAssertEqual(ToneCurve(brightness: 0, contrast: 1, gamma: 2, levels: .identity).apply(0.25), 0.5, accuracy: 1e-9)
+
+        let cache = ToneCurveCache(capacity: 1)
+        let key = ToneCurveCache.Key(curve: curve, entries: 256, bands: 4, alphaBand: 3)
+        XCTAssertTrue(try cache.table(for: key) === cache.table(for: key))
+        _ = try cache.table(for: ToneCurveCache.Key(curve: curve, entries: 256, bands: 3, alphaBand: nil))
+        XCTAssertEqual(cache.count, 1)
+    }
+
+    func testColorMatrixPresetsComposeIntoOnePass() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        XCTAssertEqual(ColorMatrix.chain([]), .identity)
+        for (a, b) in zip(ColorMatrix.saturation(0).matrix, ColorMatrix.saturation(1).then(.saturation(0)).matrix) {
+            XCTAssertEqual(a, b, accuracy: 1e-9)
+        }
+        for (a, b) in zip(ColorMatrix.hueRotate(degrees: 0).matrix, ColorMatrix.identity.matrix) {
+            XCTAssertEqual(a, b, accuracy: 1e-3)
+        }
+
+        let duotone = ColorMatrix.duotone(shadow: [0.2, 0, 0], highlight: [1, 1, 1])
+        let shifted = ColorMatrix(matrix: ColorMatrix.identity.matrix, offset: [0.1, 0, 0]).then(duotone)
+        XCTAssertEqual(shifted.offset[0], 0.2 + 0.8 * 0.2126 * 0.1, accuracy: 1e-9)
+
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        let filtered = try image.colorMatrix([.grayscale, .sepia(), duotone])
+        XCTAssertEqual(try filtered.bands, 4)
+        XCTAssertEqual(try filtered.width, 1)
+    }
+
+    func testResizeSharpenDecodesAndScalesWithReduction() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let json = #"{"op": "resize", "width": 2, "height": 2, "fit": "fill", "sharpen": "auto"}"#
+        guard case .resize(let options) = try JSONDecoder().decode(ProcessingStep.self, from: Data(json.utf8)) else {
+            return XCTFail("expected resize step")
+        }
+        XCTAssertEqual(options.sharpen, .auto)
+        let custom = ResizeOptions(width: 2, sharpen: .custom(sigma: 0.8, m1: 0.5, m2: 2))
+        XCTAssertEqual(try JSONDecoder().decode(ResizeOptions.self, from: JSONEncoder().encode(custom)).sharpen, custom.sharpen)
+
+        XCTAssertNil(SharpenMode.auto.parameters(reduction: 0.5))
+        XCTAssertEqual(SharpenMode.auto.parameters(reduction: 2)?.sigma, 0.75)
+        XCTAssertEqual(SharpenMode.auto.parameters(reduction: 16)?.m2, 3)
+
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        let sharpened = try image.resize(width: 2, height: 2, options: ResizeOptions(fit: .fill, sharpen: .custom(sigma: 0.5, m1: 0, m2: 2)))
+        XCTAssertEqual(try sharpened.width, 2)
+    }
+
+    func testTiledWatermarkKeepsBaseSize() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let pixel = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        let base = try pixel.resize(width: 40, height: 30)
+
+        for angle in [0.0, -30.0] {
+            let marked = try base.tiledWatermark(overlay: pixel, spacing: 3, angle: angle, opacity: 0.5)
+            XCTAssertEqual(try marked.width, 40)
+            XCTAssertEqual(try marked.height, 30)
+            XCTAssertEqual(try marked.bands, 4)
+        }
+    }
+
+    func testAffineTransformComposesAndFusesRecipeSteps() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+
+        let roundTrip = AffineTransform.rotation(degrees: 90).then(.rotation(degrees: -90))
+        XCTAssertEqual(roundTrip.a, 1, accuracy: 1e-9)
+        XCTAssertEqual(roundTrip.b, 0, accuracy: 1e-9)
+        XCTAssertEqual(roundTrip.d, 1, accuracy: 1e-9)
+        let point = AffineTransform.scale(2).then(.translation(x: 3, y: -1)).apply(x: 1, y: 1)
+        XCTAssertEqual(point.x, 5, accuracy: 1e-9)
+        XCTAssertEqual(point.y, 1, accuracy: 1e-9)
+
+        let json = #"{"op": "affine", "a": 2, "d": 2, "interpolator": "lbb"}"#
+        let step = try JSONDecoder().decode(ProcessingStep.self, from: Data(json.utf8))
+        guard case .affine(let decoded, let interpolator, nil) = step else {
+            return XCTFail("expected affine step, got \(step)")
+        }
+        XCTAssertEqual(decoded, .scale(2))
+        XCTAssertEqual(interpolator, .lbb)
+
+        let steps: [ProcessingStep] = [.rotate(.custom(10)), .resize(ResizeOptions(width: 800, fit: .inside)), .flip(.horizontal)]
+        let run = try AffineRun.plan(steps[...], width: 1000, height: 600)
+        XCTAssertEqual(run.count, 2)
+        XCTAssertEqual(run.outputArea.width, 800)
+
+        let image = try await Hokusai.image(from: try loadFixtureData(named: "pixel", ext: "png"))
+        let scaled = try image.transform(affine: .scale(4), interpolator: .nearest)
+        XCTAssertEqual(try scaled.width, 4)
+        XCTAssertEqual(try scaled.height, 4)
+    }
+
+    func testRotateCropToContentUsesInscribedRectangle() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+
+        let square = HokusaiImage.largestInscribedRectangle(width: 100, height: 100, degrees: 45)
+        XCTAssertEqual(square.width, 50 * 2.0.squareRoot(), accuracy: 1e-9)
+        XCTAssertEqual(square.height, square.width, accuracy: 1e-9)
+
+        let wide = HokusaiImage.largestInscribedRectangle(width: 4000, height: 3000, degrees: 2)
+        XCTAssertLessThan(wide.width, 4000)
+        XCTAssertGreaterThan(wide.width, 3800)
+        XCTAssertEqual(wide.width / wide.height, 4.0 / 3.0, accuracy: 0.05)
+
+        let image = try await Hokusai.image(from: try loadFixtureData(named: "pixel", ext: "png"))
+        let large = try image.resize(width: 64, height: 48)
+        let straightened = try large.rotate(angle: .custom(3), cropToContent: true)
+        XCTAssertLessThanOrEqual(try straightened.width, 64)
+        XCTAssertLessThanOrEqual(try straightened.height, 48)
+    }
+
+    func testForEachTileVisitsEveryPixelOnce() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+
+        final class Tally: @unchecked Sendable {
+            private let lock = NSLock()
+            private(set) var pixels = 0
+            private(set) var tiles = 0
+
+            func add(_ count: Int) {
+                lock.lock()
+                pixels += count
+                tiles += 1
+                lock.unlock()
+            }
+        }
+
+        let image = try await Hokusai.image(from: try loadFixtureData(named: "pixel", ext: "png"))
+        let large = try image.resize(width: 64, height: 48)
+        let tally = Tally()
+        try large.forEachTile(size: 16, concurrency: 2) { tile in
+            XCTAssertEqual(tile.row(0).count, tile.width * tile.bytesPerPixel)
+            tally.add(tile.width * tile.height)
+        }
+        XCTAssertEqual(tally.pixels, 64 * 48)
+        XCTAssertGreaterThan(tally.tiles, 1)
+
+        struct Stop: Error {}
+        XCTAssertThrowsError(try large.forEachTile(size: 16) { _ in throw Stop() }) { error in
+            XCTAssertTrue(error is Stop)
+        }
+    }
+
+    func testRegionOperationRunsLazilyInPipeline() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+
+        final class ByteSum: @unchecked Sendable {
+            private let lock = NSLock()
+            private(set) var total = 0
+            private(set) var count = 0
+
+            func add(_ bytes: UnsafeRawBufferPointer) {
+                let sum = bytes.reduce(0) { $0 + Int($1) }
+                lock.lock()
+                total += sum
+                count += bytes.count
+                lock.unlock()
+            }
+        }
+
+        let invert = RegionOperation(name: "test.invert") { pixels in
+            for y in 0..<pixels.input.height {
+                let source = pixels.input.row(y)
+                let target = pixels.outputRow(y)
+                for i in 0..<source.count { target[i] = 255 - source[i] }
+            }
+        }
+        RegionOperation.register(invert)
+
+        let image = try await Hokusai.image(from: try loadFixtureData(named: "pixel", ext: "png"))
+        let source = try image.resize(width: 32, height: 24)
+        let step = try JSONDecoder().decode(ProcessingStep.self, from: Data(#"{"op": "custom", "name": "test.invert"}"#.utf8))
+        let inverted = try ProcessingRecipe(steps: [step], output: SaveOptions(format: .png)).transform(source)
+
+        let original = ByteSum()
+        let flipped = ByteSum()
+        try source.forEachTile(size: 8) { original.add($0.row(0)) }
+        try inverted.forEachTile(size: 8) { flipped.add($0.row(0)) }
+        XCTAssertEqual(original.count, flipped.count)
+        XCTAssertEqual(original.total + flipped.total, 255 * original.count)
+
+        XCTAssertThrowsError(try source.apply(operation: "test.missing"))
+    }
+
+    func testBatchLimitsHonourRequestedWorkersAndGateDropsCancelledWaiters() async throws {
+        XCTAssertEqual(BatchLimits.workerCount(requested: 6), 6)
+        XCTAssertGreaterThanOrEqual(BatchLimits.workerCount(requested: nil), 1)
+
+        let gate = MemoryGate(budget: 10)
+        try await gate.acquire(10)
+        let waiter = Task { try await gate.acquire(5) }
+        while await gate.waitingCount == 0 {
+            await Task.yield()
+        }
+        waiter.cancel()
+        do {
+            try await waiter.value
+            XCTFail("cancelled waiter should throw")
+        } catch {
+            XCTAssertTrue(error is CancellationError)
+        }
+        let remaining = await gate.waitingCount
+        XCTAssertEqual(remaining, 0)
+        await gate.release(10)
+    }
+
+    func testProcessRunsRequestedNumberOfImagesAtOnce() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+
+        final class InFlight: @unchecked Sendable {
+            private let lock = NSLock()
+            private var current = 0
+            private(set) var peak = 0
+
+            func enter() {
+                lock.lock()
+                current += 1
+                peak = max(peak, current)
+                lock.unlock()
+            }
+
+            func leave() {
+                lock.lock()
+                current -= 1
+                lock.unlock()
+            }
+        }
+
+        // PURPOSE: A 1x1 image is a single region, so one callback runs per image.
+        let inFlight = InFlight()
+        RegionOperation.register(RegionOperation(name: "test.slow-copy") { pixels in
+            inFlight.enter()
+            defer { inFlight.leave() }
+            Thread.sleep(forTimeInterval: 0.2)
+            for y in 0..<pixels.input.height {
+                pixels.outputRow(y).copyMemory(from: pixels.input.row(y))
+            }
+        })
+
+        let data = try loadFixtureData(named: "pixel", ext: "png")
+        let recipe = ProcessingRecipe(steps: [.custom("test.slow-copy")], output: SaveOptions(format: .png))
+        var completed = 0
+        for try await output in Hokusai.process(Array(repeating: ImageInput.data(data), count: 4), recipe: recipe, maxConcurrency: 4) {
+            _ = try output.result.get()
+            completed += 1
+        }
+        XCTAssertEqual(completed, 4)
+        XCTAssertGreaterThan(inFlight.peak, 1)
+    }
+
+    func testFairSchedulerKeepsReservedSlotAndDropsCancelledWaiters() async throws {
+        let scheduler = FairScheduler(configuration: ProcessingExecutorConfiguration(maxConcurrent: 2, reservedInteractiveSlots: 1))
+
+        func waiting(_ priority: PriorityClass) async -> Int {
+            return await scheduler.statistics().first { $0.priority == priority }?.waiting ?? 0
+        }
+
+        try await scheduler.acquire(priority: .standard, tenant: "a", cost: 1)
+        let blocked = Task { try await scheduler.acquire(priority: .batch, tenant: "a", cost: 1) }
+        while await waiting(.batch) == 0 {
+            await Task.yield()
+        }
+
+        // PURPOSE: The reserved slot is still free for interactive work.
+        try await scheduler.acquire(priority: .interactive, tenant: "a", cost: 1)
+
+        blocked.cancel()
+        do {
+            try await blocked.value
+            XCTFail("cancelled waiter should throw")
+        } catch {
+            XCTAssertTrue(error is CancellationError)
+        }
+        let remaining = await waiting(.batch)
+        XCTAssertEqual(remaining, 0)
+    }
+
+    func testFairSchedulerLeavesASharedSlotAboveTheReserve() {
+        let tight = ProcessingExecutorConfiguration(maxConcurrent: 1, reservedInteractiveSlots: 1)
+        let roomy = ProcessingExecutorConfiguration(maxConcurrent: 4, reservedInteractiveSlots: 1)
+
+        XCTAssertEqual(FairScheduler.slotCount(for: tight), 2)
+        XCTAssertEqual(FairScheduler.slotCount(for: roomy), 4)
+    }
+
+    func testTiffRoundTripsThroughBufferAndHashedFile() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+
+        let image = try await Hokusai.image(from: try loadFixtureData(named: "pixel", ext: "png"))
+        let encoded = try image.toBuffer(options: SaveOptions(format: .tiff), hashing: [.sha256])
+        XCTAssertFalse(encoded.data.isEmpty)
+        let decoded = try await Hokusai.image(from: encoded.data)
+        XCTAssertEqual(try decoded.width, 1)
+
+        let path = FileManager.default.temporaryDirectory.appendingPathComponent("hokusai-roundtrip-\(UUID().uuidString).tiff").path
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        let digest = try image.toFile(path, options: SaveOptions(format: .tiff), hashing: [.sha256])
+        let written = try Data(contentsOf: URL(fileURLWithPath: path))
+        XCTAssertEqual(digest.byteCount, written.count)
+        XCTAssertEqual(try Hokusai.loadFromFile(path).height, 1)
+    }
+
+    func testStripMetadataRemovesExifAndICC() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        let tagged = try image.toColorspace(.displayP3)
+        let kept = try Hokusai.loadFromBuffer(tagged.toBuffer(options: SaveOptions(format: .png, metadata: .all)))
+        XCTAssertNotNil(try kept.iccProfile())
+
+        let stripped = try Hokusai.loadFromBuffer(tagged.toBuffer(options: SaveOptions(format: .png, metadata: .strip)))
+        XCTAssertNil(try stripped.iccProfile())
+        XCTAssertTrue(try stripped.fields(matching: "exif-*").isEmpty)
+
+        let legacyJSON = try JSONDecoder().decode(MetadataPolicy.self, from: Data(#""none""#.utf8))
+        XCTAssertEqual(legacyJSON, .strip)
+    }
+
+    func testAdjustRejectsOutputLevelsOutsideUnitRange() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        XCTAssertThrowsError(try image.adjust(levels: ToneLevels(outputWhite: 1.5)))
+        XCTAssertThrowsError(try image.adjust(levels: ToneLevels(outputBlack: -0.2)))
+        XCTAssertEqual(try image.adjust(brightness: 0.8, contrast: 4, levels: ToneLevels(outputBlack: 0.1, outputWhite: 0.9)).width, 1)
+    }
+
+    func testAffineRunLimitsCumulativeReductionAndKeepsKernels() throws {
+        // PURPOSE: Each resize halves at most, but the pair would reduce 4x if fused.
+        let halving: [ProcessingStep] = [
+            .rotate(.custom(5)),
+            .resize(ResizeOptions(width: 600, fit: .inside)),
+            .resize(ResizeOptions(width: 300, fit: .inside)),
+        ]
+        let run = try AffineRun.plan(halving[...], width: 1000, height: 1000)
+        XCTAssertEqual(run.count, 2)
+
+        let custom: [ProcessingStep] = [
+            .rotate(.custom(5)),
+            .resize(ResizeOptions(width: 900, fit: .inside, kernel: .nearest)),
+        ]
+        XCTAssertEqual(try AffineRun.plan(custom[...], width: 1000, height: 1000).count, 1)
+    }
+
+    func testBoundedQueueRejectsPushAfterClose() {
+        let queue = BoundedQueue<Int>(capacity: 2)
+        XCTAssertTrue(queue.push(1))
+        queue.close()
+
+        XCTAssertFalse(queue.push(2))
+        XCTAssertEqual(queue.pop(), 1)
+        XCTAssertNil(queue.pop())
+    }
+
+    func testRunWithConcurrentRunsMatchesSingleRun() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let data = try loadFixtureData(named: "pixel", ext: "png")
+        let recipe = ProcessingRecipe(
+            steps: [.resize(ResizeOptions(width: 4, height: 4, fit: .fill))],
+            output: SaveOptions(format: .png)
+        )
+
+        XCTAssertEqual(Hokusai.workerCount(requested: 3), 3)
+        XCTAssertGreaterThanOrEqual(Hokusai.workerCount(), 1)
+        XCTAssertEqual(
+            try recipe.run(.data(data), concurrentRuns: Hokusai.workerCount()),
+            try recipe.run(.data(data))
+        )
+    }
+
+    func testWatchOnceProcessesPendingFilesThenSkipsThem() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        let data = try loadFixtureData(named: "pixel", ext: "png")
+        let root = FileManager.default.temporaryDirectory.resolvingSymlinksInPath()
+            .appendingPathComponent("hokusai-watch-\(UUID().uuidString)")
+        let inputDir = root.appendingPathComponent("in")
+        let outputDir = root.appendingPathComponent("out")
+        try FileManager.default.createDirectory(at: inputDir.appendingPathComponent("nested"), withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: root) }
+        try data.write(to: inputDir.appendingPathComponent("a.png"))
+        try data.write(to: inputDir.appendingPathComponent("nested/b.png"))
+
+        let recipe = ProcessingRecipe(
+            steps: [.resize(ResizeOptions(width: 2, height: 2, fit: .fill))],
+            output: SaveOptions(format: .png)
+        )
+
+        func runOnce() async throws -> (processed: [String], tracked: Int) {
+            let session = try WatchSession(
+                inputDir: inputDir.path,
+                outputDir: outputDir.path,
+                recipe: recipe,
+                workers: 2,
+                debounce: 0.05
+            )
+            var processed: [String] = []
+            let tracked = try await session.run(once: true) { outcome in
+                if case .processed(let path, _) = outcome {
+                    processed.append(path)
+                }
+            }
+            return (processed.sorted(), tracked)
+        }
+
+        let first = try await runOnce()
+        XCTAssertEqual(first.processed, ["a.png", "nested/b.png"])
+        XCTAssertEqual(first.tracked, 2)
+        XCTAssertTrue(FileManager.default.fileExists(atPath: outputDir.appendingPathComponent("nested/b.png").path))
+
+        let second = try await runOnce()
+        XCTAssertEqual(second.processed, [])
+        XCTAssertEqual(second.tracked, 2)
+    }
+
+    func testInFlightPathsDeduplicatesAndRequeuesChangesWhileRunning() {
+        let paths = InFlightPaths()
+        XCTAssertTrue(paths.offer("a"))
+        XCTAssertFalse(paths.offer("a"))
+
+        paths.begin("a")
+        XCTAssertFalse(paths.offer("a"))
+        XCTAssertTrue(paths.finish("a"))
+        XCTAssertFalse(paths.finish("a"))
+        XCTAssertTrue(paths.offer("a"))
+    }
+
+    func testBatchWriterReleasedWithoutFinishFlushesQueuedWrites() async throws {
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent("hokusai-writer-\(UUID().uuidString)")
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let path = directory.appendingPathComponent("out.bin").path
+
+        weak var released: BatchWriter?
+        do {
+            let writer = BatchWriter(backend: .threads)
+            writer.write(Data([1, 2, 3]), to: path)
+            released = writer
+        }
+        XCTAssertNil(released)
+
+        for _ in 0..<200 where !FileManager.default.fileExists(atPath: path) {
+            try await Task.sleep(nanoseconds: 10_000_000)
+        }
+        XCTAssertEqual(FileManager.default.contents(atPath: path), Data([1, 2, 3]))
+    }
+
+    func testBatchWriterHandlesRepeatedPathsAndLateWrites() async throws {
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent("hokusai-writer-\(UUID().uuidString)")
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let path = directory.appendingPathComponent("out.bin").path
+
+        for backend in [IOBackend.threads, .automatic] {
+            let writer = BatchWriter(backend: backend, batchSize: 4)
+            writer.write(Data([1]), to: path)
+            writer.write(Data([2, 2]), to: path)
+            try await writer.finish()
+            writer.write(Data([3]), to: path)
+
+            XCTAssertEqual(writer.writtenCount, 2)
+            XCTAssertEqual(writer.failedWrites.count, 1)
+            XCTAssertEqual(FileManager.default.contents(atPath: path), Data([2, 2]))
+        }
+    }
+
+    func testRegionOperationRethrowsKernelError() async throws {
+        try await HokusaiTestRuntime.shared.ensureInitialized()
+        struct KernelFailure: Error, Equatable {
+            let reason: String
+        }
+        let image = try Hokusai.loadFromBuffer(try loadFixtureData(named: "pixel", ext: "png"))
+        let failing = RegionOperation(name: "test.failing") { _ in
+            throw KernelFailure(reason: "bad pixels")
+        }
+        let output = try image.apply(failing)
+
+        XCTAssertThrowsError(try output.toBuffer(options: SaveOptions(format: .png))) { error in
+            XCTAssertEqual(error as? KernelFailure, KernelFailure(reason: "bad pixels"))
+        }
+        XCTAssertThrowsError(try output.forEachTile { _ in }) { error in
+            XCTAssertEqual(error as? KernelFailure, KernelFailure(reason: "bad pixels"))
+        }
+    }
 }